@@ -0,0 +1,301 @@
+#include "databaseConnectionPool.h"
+#include "databaseLayerException.h"
+
+// ctor()
+DatabaseConnectionPool::DatabaseConnectionPool(const connectionFactory_t& factory, size_t nMaxSize)
+	: m_factory(factory), m_released(m_mutex), m_nMaxSize(nMaxSize), m_nOpenConnections(0),
+	m_nAcquireTimeout(30000), m_nHealthCheckInterval(60000),
+	m_nAcquires(0), m_nWaits(0), m_nTimeouts(0), m_nCreatedConnections(0), m_nFailedChecks(0)
+{
+}
+
+// dtor()
+DatabaseConnectionPool::~DatabaseConnectionPool()
+{
+	CloseIdleConnections();
+
+	// Connections still checked out are closed as well
+	std::map<wxThreadIdType, checkout_t>::iterator start = m_BusyConnections.begin();
+	std::map<wxThreadIdType, checkout_t>::iterator stop = m_BusyConnections.end();
+	while (start != stop)
+	{
+		DestroyConnection(start->second.m_pConnection);
+		start++;
+	}
+	m_BusyConnections.clear();
+}
+
+DatabaseLayer* DatabaseConnectionPool::Acquire()
+{
+	wxThreadIdType threadId = wxThread::GetCurrentId();
+
+	wxMutexLocker lock(m_mutex);
+
+	m_nAcquires++;
+
+	std::map<wxThreadIdType, checkout_t>::iterator foundedCheckout = m_BusyConnections.find(threadId);
+	if (foundedCheckout != m_BusyConnections.end())
+	{
+		foundedCheckout->second.m_nRefCount++;
+		foundedCheckout->second.m_bReleasePending = false;
+		return foundedCheckout->second.m_pConnection;
+	}
+
+	wxLongLong startTime = wxGetLocalTimeMillis();
+	bool bWaited = false;
+
+	for (;;)
+	{
+		DatabaseLayer* pConnection = NULL;
+
+		if (!m_IdleConnections.empty())
+		{
+			idleConnection_t idleConnection = m_IdleConnections.front();
+			m_IdleConnections.pop_front();
+
+			pConnection = idleConnection.m_pConnection;
+
+			// The check runs without the lock, other threads go on meanwhile
+			if (wxGetLocalTimeMillis() - idleConnection.m_lastUsed >= m_nHealthCheckInterval)
+			{
+				m_mutex.Unlock();
+				bool bHealthy = CheckConnection(pConnection);
+				if (!bHealthy)
+					DestroyConnection(pConnection);
+				m_mutex.Lock();
+
+				if (!bHealthy)
+				{
+					m_nFailedChecks++;
+					m_nOpenConnections--;
+					continue;
+				}
+			}
+		}
+		else if (m_nOpenConnections < m_nMaxSize)
+		{
+			m_nOpenConnections++;
+
+			m_mutex.Unlock();
+			pConnection = m_factory();
+			if (pConnection != NULL && !pConnection->IsOpen())
+			{
+				DestroyConnection(pConnection);
+				pConnection = NULL;
+			}
+			m_mutex.Lock();
+
+			if (pConnection == NULL)
+			{
+				m_nOpenConnections--;
+				m_released.Signal();
+				return NULL;
+			}
+
+			pConnection->SetConnectionPool(this);
+			m_nCreatedConnections++;
+		}
+
+		if (pConnection != NULL)
+		{
+			checkout_t checkout;
+			checkout.m_pConnection = pConnection;
+			checkout.m_nRefCount = 1;
+			checkout.m_bReleasePending = false;
+			m_BusyConnections[threadId] = checkout;
+			return pConnection;
+		}
+
+		// All connections are busy, wait for a release
+		if (!bWaited)
+		{
+			m_nWaits++;
+			bWaited = true;
+		}
+
+		long nRemaining = m_nAcquireTimeout - (wxGetLocalTimeMillis() - startTime).ToLong();
+		if (nRemaining <= 0)
+		{
+			m_nTimeouts++;
+			return NULL;
+		}
+
+		m_released.WaitTimeout(nRemaining);
+	}
+}
+
+void DatabaseConnectionPool::Release(DatabaseLayer* pConnection)
+{
+	if (pConnection == NULL)
+		return;
+
+	wxMutexLocker lock(m_mutex);
+
+	std::map<wxThreadIdType, checkout_t>::iterator foundedCheckout = m_BusyConnections.find(wxThread::GetCurrentId());
+	if (foundedCheckout == m_BusyConnections.end() || foundedCheckout->second.m_pConnection != pConnection)
+		return;
+
+	if (foundedCheckout->second.m_nRefCount > 0)
+		foundedCheckout->second.m_nRefCount--;
+
+	if (foundedCheckout->second.m_nRefCount > 0)
+		return;
+
+	// Transaction affinity: the open transaction must be finished by the same thread,
+	//  the connection goes back when it ends
+	if (pConnection->IsTransactionOpen())
+	{
+		foundedCheckout->second.m_bReleasePending = true;
+		return;
+	}
+
+	ReturnConnection(foundedCheckout);
+}
+
+void DatabaseConnectionPool::ReleasePending(DatabaseLayer* pConnection)
+{
+	if (pConnection == NULL || pConnection->IsTransactionOpen())
+		return;
+
+	wxMutexLocker lock(m_mutex);
+
+	std::map<wxThreadIdType, checkout_t>::iterator foundedCheckout = m_BusyConnections.find(wxThread::GetCurrentId());
+	if (foundedCheckout == m_BusyConnections.end() || foundedCheckout->second.m_pConnection != pConnection)
+		return;
+
+	if (!foundedCheckout->second.m_bReleasePending || foundedCheckout->second.m_nRefCount > 0)
+		return;
+
+	ReturnConnection(foundedCheckout);
+}
+
+void DatabaseConnectionPool::ReturnConnection(std::map<wxThreadIdType, checkout_t>::iterator itCheckout)
+{
+	DatabaseLayer* pConnection = itCheckout->second.m_pConnection;
+
+	m_BusyConnections.erase(itCheckout);
+
+	if (m_nOpenConnections > m_nMaxSize)
+	{
+		m_nOpenConnections--;
+		m_mutex.Unlock();
+		DestroyConnection(pConnection);
+		m_mutex.Lock();
+	}
+	else
+	{
+		idleConnection_t idleConnection;
+		idleConnection.m_pConnection = pConnection;
+		idleConnection.m_lastUsed = wxGetLocalTimeMillis();
+		m_IdleConnections.push_front(idleConnection);
+	}
+
+	m_released.Signal();
+}
+
+DatabaseLayer* DatabaseConnectionPool::GetThreadConnection()
+{
+	wxMutexLocker lock(m_mutex);
+
+	std::map<wxThreadIdType, checkout_t>::iterator foundedCheckout = m_BusyConnections.find(wxThread::GetCurrentId());
+	if (foundedCheckout == m_BusyConnections.end())
+		return NULL;
+
+	return foundedCheckout->second.m_pConnection;
+}
+
+void DatabaseConnectionPool::SetMaxSize(size_t nMaxSize)
+{
+	std::list<idleConnection_t> closeConnections;
+
+	{
+		wxMutexLocker lock(m_mutex);
+		m_nMaxSize = nMaxSize;
+
+		// Drop the least recently used idle connections above the limit
+		while (m_nOpenConnections > m_nMaxSize && !m_IdleConnections.empty())
+		{
+			closeConnections.push_back(m_IdleConnections.back());
+			m_IdleConnections.pop_back();
+			m_nOpenConnections--;
+		}
+
+		m_released.Broadcast();
+	}
+
+	std::list<idleConnection_t>::iterator start = closeConnections.begin();
+	std::list<idleConnection_t>::iterator stop = closeConnections.end();
+	while (start != stop)
+	{
+		DestroyConnection(start->m_pConnection);
+		start++;
+	}
+}
+
+void DatabaseConnectionPool::CloseIdleConnections()
+{
+	std::list<idleConnection_t> closeConnections;
+
+	{
+		wxMutexLocker lock(m_mutex);
+		closeConnections.swap(m_IdleConnections);
+		m_nOpenConnections -= closeConnections.size();
+	}
+
+	std::list<idleConnection_t>::iterator start = closeConnections.begin();
+	std::list<idleConnection_t>::iterator stop = closeConnections.end();
+	while (start != stop)
+	{
+		DestroyConnection(start->m_pConnection);
+		start++;
+	}
+}
+
+bool DatabaseConnectionPool::CheckConnection(DatabaseLayer* pConnection)
+{
+	if (!pConnection->IsOpen())
+		return false;
+
+	if (m_strHealthQuery.IsEmpty())
+		return true;
+
+	bool bReturn = false;
+
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		DatabaseResultSet* pResult = pConnection->RunQueryWithResults(m_strHealthQuery);
+		if (pResult != NULL)
+		{
+			bReturn = pResult->Next();
+			pConnection->CloseResultSet(pResult);
+		}
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException&)
+	{
+		bReturn = false;
+	}
+#endif
+
+	return bReturn;
+}
+
+void DatabaseConnectionPool::DestroyConnection(DatabaseLayer* pConnection)
+{
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		if (pConnection->IsOpen())
+			pConnection->Close();
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException&)
+	{
+	}
+#endif
+
+	delete pConnection;
+}
@@ -0,0 +1,124 @@
+#ifndef __DATABASE_CONNECTION_POOL_H__
+#define __DATABASE_CONNECTION_POOL_H__
+
+#include "databaseLayer.h"
+
+#include <wx/thread.h>
+
+#include <functional>
+
+class CORE_API DatabaseConnectionPool
+{
+public:
+	/// Creates and opens a new connection, returns NULL when the database can not be opened
+	typedef std::function<DatabaseLayer*()> connectionFactory_t;
+
+	/// Constructor
+	DatabaseConnectionPool(const connectionFactory_t& factory, size_t nMaxSize = 4);
+
+	/// Destructor
+	~DatabaseConnectionPool();
+
+	/// Check out a connection for the calling thread. Nested calls on the same thread get the same connection.
+	///  When all connections are busy the call waits for the acquire timeout and returns NULL after it
+	DatabaseLayer* Acquire();
+	/// Give back a connection taken by Acquire(). It goes back to the pool after the last Release() of the thread,
+	///  a connection with an open write scope stays with its thread and goes back when the scope is closed
+	void Release(DatabaseLayer* pConnection);
+
+	/// Called by the connection when its transaction has ended, finishes a Release() deferred by the open transaction
+	void ReleasePending(DatabaseLayer* pConnection);
+
+	/// Connection checked out by the calling thread, NULL if there is none
+	DatabaseLayer* GetThreadConnection();
+
+	/// Maximum count of open connections
+	void SetMaxSize(size_t nMaxSize);
+	size_t GetMaxSize() const { return m_nMaxSize; }
+
+	/// How long Acquire() waits for a busy pool
+	void SetAcquireTimeout(long nMilliseconds) { m_nAcquireTimeout = nMilliseconds; }
+	long GetAcquireTimeout() const { return m_nAcquireTimeout; }
+
+	/// Health check of idle connections: the query runs before a connection idle for the interval is handed out,
+	///  an empty query only checks IsOpen()
+	void SetHealthQuery(const wxString& strQuery) { m_strHealthQuery = strQuery; }
+	const wxString& GetHealthQuery() const { return m_strHealthQuery; }
+	void SetHealthCheckInterval(long nMilliseconds) { m_nHealthCheckInterval = nMilliseconds; }
+	long GetHealthCheckInterval() const { return m_nHealthCheckInterval; }
+
+	/// Close the connections nobody has checked out
+	void CloseIdleConnections();
+
+	/// Pool statistics
+	size_t GetSize() const { return m_nOpenConnections; }
+	size_t GetIdleCount() const { return m_IdleConnections.size(); }
+	unsigned long GetAcquires() const { return m_nAcquires; }
+	unsigned long GetWaits() const { return m_nWaits; }
+	unsigned long GetTimeouts() const { return m_nTimeouts; }
+	unsigned long GetCreatedConnections() const { return m_nCreatedConnections; }
+	unsigned long GetFailedChecks() const { return m_nFailedChecks; }
+
+private:
+
+	struct checkout_t {
+		DatabaseLayer* m_pConnection;
+		unsigned int m_nRefCount;
+		// released while its transaction was open
+		bool m_bReleasePending;
+	};
+
+	struct idleConnection_t {
+		DatabaseLayer* m_pConnection;
+		wxLongLong m_lastUsed;
+	};
+
+	/// Move a checked out connection to the idle ones, the mutex must be locked
+	void ReturnConnection(std::map<wxThreadIdType, checkout_t>::iterator itCheckout);
+
+	bool CheckConnection(DatabaseLayer* pConnection);
+	void DestroyConnection(DatabaseLayer* pConnection);
+
+	connectionFactory_t m_factory;
+
+	wxMutex m_mutex;
+	wxCondition m_released;
+
+	// most recently used connections go first
+	std::list<idleConnection_t> m_IdleConnections;
+	std::map<wxThreadIdType, checkout_t> m_BusyConnections;
+
+	size_t m_nMaxSize;
+	size_t m_nOpenConnections;
+
+	long m_nAcquireTimeout;
+
+	wxString m_strHealthQuery;
+	long m_nHealthCheckInterval;
+
+	unsigned long m_nAcquires;
+	unsigned long m_nWaits;
+	unsigned long m_nTimeouts;
+	unsigned long m_nCreatedConnections;
+	unsigned long m_nFailedChecks;
+};
+
+/// Connection of a pool checked out for the lifetime of the locker
+class CORE_API DatabaseConnectionLocker
+{
+public:
+	DatabaseConnectionLocker(DatabaseConnectionPool* pPool)
+		: m_pPool(pPool), m_pConnection(pPool != NULL ? pPool->Acquire() : NULL) {}
+	~DatabaseConnectionLocker() { if (m_pConnection != NULL) m_pPool->Release(m_pConnection); }
+
+	bool IsOk() const { return m_pConnection != NULL; }
+
+	DatabaseLayer* GetConnection() const { return m_pConnection; }
+	DatabaseLayer* operator->() const { return m_pConnection; }
+
+private:
+	DatabaseConnectionPool* m_pPool;
+	DatabaseLayer* m_pConnection;
+};
+
+#endif // __DATABASE_CONNECTION_POOL_H__
@@ -0,0 +1,144 @@
+#include "databaseDialect.h"
+
+wxString DatabaseDialect::GetNumberType(int nPrecision, int nScale) const
+{
+	if (nScale > 0)
+		return wxString::Format(wxT("NUMERIC(%d,%d)"), nPrecision, nScale);
+
+	return wxString::Format(wxT("NUMERIC(%d)"), nPrecision);
+}
+
+wxString DatabaseDialect::GetStringType(int nLength) const
+{
+	return wxString::Format(wxT("VARCHAR(%d)"), nLength);
+}
+
+wxString DatabaseDialect::GetBinaryType(int nLength) const
+{
+	return wxString::Format(wxT("BINARY(%d)"), nLength);
+}
+
+wxString DatabaseDialect::GetBinaryLiteral(const wxString& strHex) const
+{
+	return wxT("X'") + strHex + wxT("'");
+}
+
+wxString DatabaseDialect::GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	// MERGE of SQL:2003
+	wxString strSource, strMatch, strUpdate, strInsert;
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (i > 0)
+		{
+			strSource += wxT(", ");
+			strInsert += wxT(", ");
+		}
+		strSource += values[i] + wxT(" AS ") + columns[i];
+		strInsert += wxT("S.") + columns[i];
+
+		if (keyColumns.Index(columns[i], false) != wxNOT_FOUND)
+			continue;
+
+		if (!strUpdate.IsEmpty())
+			strUpdate += wxT(", ");
+		strUpdate += columns[i] + wxT(" = S.") + columns[i];
+	}
+
+	for (size_t i = 0; i < keyColumns.size(); i++)
+	{
+		if (i > 0)
+			strMatch += wxT(" AND ");
+		strMatch += wxT("T.") + keyColumns[i] + wxT(" = S.") + keyColumns[i];
+	}
+
+	wxString strQuery = wxT("MERGE INTO ") + strTable + wxT(" T USING (") + GetSelectWithoutTable(strSource) + wxT(") S ON (") + strMatch + wxT(")");
+	if (!strUpdate.IsEmpty())
+		strQuery += wxT(" WHEN MATCHED THEN UPDATE SET ") + strUpdate;
+	strQuery += wxT(" WHEN NOT MATCHED THEN INSERT (") + wxJoin(columns, wxT(','), 0) + wxT(") VALUES (") + strInsert + wxT(");");
+
+	return strQuery;
+}
+
+wxString DatabaseDialect::GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset) const
+{
+	return wxString::Format(wxT("SELECT %s OFFSET %lu ROWS FETCH NEXT %lu ROWS ONLY"), strSelect, nOffset, nLimit);
+}
+
+wxString DatabaseDialect::GetSelectWithoutTable(const wxString& strColumns) const
+{
+	return wxT("SELECT ") + strColumns;
+}
+
+wxString DatabaseDialect::GetStartsWith(const wxString& strExpression) const
+{
+	return strExpression + wxT(" LIKE ") + GetLikeParameter() + wxT(" || '%' ESCAPE '!'");
+}
+
+wxString DatabaseDialect::GetAddColumn(const wxString& strTable, const wxString& strColumn, const wxString& strType) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s ADD COLUMN %s %s;"), strTable, strColumn, strType);
+}
+
+wxString DatabaseDialect::GetDropColumn(const wxString& strTable, const wxString& strColumn) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s DROP COLUMN %s;"), strTable, strColumn);
+}
+
+wxString DatabaseDialect::GetRenameColumn(const wxString& strTable, const wxString& strColumn, const wxString& strNewName) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s RENAME COLUMN %s TO %s;"), strTable, strColumn, strNewName);
+}
+
+wxString DatabaseDialect::GetAlterColumnType(const wxString& strTable, const wxString& strColumn, const wxString& strType) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s ALTER COLUMN %s TYPE %s;"), strTable, strColumn, strType);
+}
+
+wxString DatabaseDialect::GetCreateIndex(const wxString& strIndex, const wxString& strTable, const wxString& strColumns,
+	bool bUnique) const
+{
+	return wxString::Format(wxT("CREATE %sINDEX %s ON %s (%s);"), bUnique ? wxT("UNIQUE ") : wxT(""), strIndex, strTable, strColumns);
+}
+
+wxString DatabaseDialect::GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const
+{
+	return wxString::Format(wxT("CREATE INDEX %s ON %s ((%s));"), strIndex, strTable, strExpression);
+}
+
+wxString DatabaseDialect::GetDropIndex(const wxString& strIndex, const wxString& strTable) const
+{
+	return wxString::Format(wxT("DROP INDEX %s;"), strIndex);
+}
+
+wxString DatabaseDialect::GetInsertOnConflict(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	wxString strUpdate;
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (keyColumns.Index(columns[i], false) != wxNOT_FOUND)
+			continue;
+
+		if (!strUpdate.IsEmpty())
+			strUpdate += wxT(", ");
+		strUpdate += columns[i] + wxT(" = excluded.") + columns[i];
+	}
+
+	wxString strQuery = wxT("INSERT INTO ") + strTable + wxT(" (") + wxJoin(columns, wxT(','), 0) + wxT(") VALUES (")
+		+ wxJoin(values, wxT(','), 0) + wxT(") ON CONFLICT (") + wxJoin(keyColumns, wxT(','), 0) + wxT(")");
+
+	if (strUpdate.IsEmpty())
+		return strQuery + wxT(" DO NOTHING;");
+
+	return strQuery + wxT(" DO UPDATE SET ") + strUpdate + wxT(";");
+}
+
+wxString DatabaseDialect::GetLikeParameter() const
+{
+	// The escape character goes first, so the escapes added after it are kept
+	return wxT("REPLACE(REPLACE(REPLACE(?, '!', '!!'), '%', '!%'), '_', '!_')");
+}
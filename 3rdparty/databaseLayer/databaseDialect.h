@@ -0,0 +1,99 @@
+#ifndef __DATABASE_DIALECT_H__
+#define __DATABASE_DIALECT_H__
+
+// For compilers that support precompilation, includes "wx.h".
+#include <wx/wxprec.h>
+
+#ifdef __BORLANDC__
+#pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <wx/arrstr.h>
+
+#include "databaseLayerDef.h"
+
+enum
+{
+	DATABASE_DIALECT_STANDARD = 0,
+	DATABASE_DIALECT_FIREBIRD,
+	DATABASE_DIALECT_SQLITE,
+	DATABASE_DIALECT_POSTGRES,
+	DATABASE_DIALECT_MYSQL
+};
+
+/// SQL text that differs between the backends. The base class writes standard SQL,
+///  each DatabaseLayer creates the dialect of its backend.
+///  Sequences are not covered: the counters of codes and numbers are rows of OBJECT_NUMBERS
+///  keyed by prefix and period, incremented inside the writing transaction
+class CORE_API DatabaseDialect
+{
+public:
+	/// Constructor
+	DatabaseDialect() {}
+
+	/// Destructor
+	virtual ~DatabaseDialect() {}
+
+	/// One of DATABASE_DIALECT_...
+	virtual int GetDialectType() const { return DATABASE_DIALECT_STANDARD; }
+
+	// Column types
+
+	virtual wxString GetBooleanType() const { return wxT("SMALLINT"); }
+	virtual wxString GetNumberType(int nPrecision, int nScale) const;
+	virtual wxString GetDateTimeType() const { return wxT("TIMESTAMP"); }
+	virtual wxString GetStringType(int nLength) const;
+	/// Fixed size binary value, compared byte by byte
+	virtual wxString GetBinaryType(int nLength) const;
+	/// Binary value of any size
+	virtual wxString GetBlobType() const { return wxT("BLOB"); }
+
+	/// Literal of a binary value given as hex digits
+	virtual wxString GetBinaryLiteral(const wxString& strHex) const;
+
+	// Queries
+
+	/// Insert a row or update the row with the same key columns.
+	///  The values are SQL expressions, usually "?" for a parameter
+	virtual wxString GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+
+	/// SELECT returning at most nLimit rows after skipping nOffset rows.
+	///  strSelect is the text after SELECT, including ORDER BY
+	virtual wxString GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset = 0) const;
+
+	/// SELECT of expressions without a table
+	virtual wxString GetSelectWithoutTable(const wxString& strColumns) const;
+
+	/// Condition for a string expression starting with the text of a parameter, taken literally
+	virtual wxString GetStartsWith(const wxString& strExpression) const;
+
+	// Schema changes
+
+	virtual wxString GetAddColumn(const wxString& strTable, const wxString& strColumn, const wxString& strType) const;
+	virtual wxString GetDropColumn(const wxString& strTable, const wxString& strColumn) const;
+	virtual wxString GetRenameColumn(const wxString& strTable, const wxString& strColumn, const wxString& strNewName) const;
+	/// Change of a column type in place, empty when the backend can not do it
+	virtual wxString GetAlterColumnType(const wxString& strTable, const wxString& strColumn, const wxString& strType) const;
+
+	/// Index on a list of columns, separated by commas
+	virtual wxString GetCreateIndex(const wxString& strIndex, const wxString& strTable, const wxString& strColumns,
+		bool bUnique = false) const;
+	/// Index on the value of an expression
+	virtual wxString GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const;
+	virtual wxString GetDropIndex(const wxString& strIndex, const wxString& strTable) const;
+
+protected:
+	/// INSERT ... ON CONFLICT upsert of PostgreSQL and SQLite, the key columns need a unique index
+	wxString GetInsertOnConflict(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+
+	/// The parameter of a LIKE pattern with its wildcards escaped by '!', the pattern needs ESCAPE '!'
+	wxString GetLikeParameter() const;
+};
+
+#endif // __DATABASE_DIALECT_H__
@@ -1,10 +1,14 @@
 #include "databaseLayer.h"
 #include "databaseErrorCodes.h"
 #include "databaseLayerException.h"
+#include "databaseQueryParser.h"
+#include "databaseConnectionPool.h"
 
 // ctor()
 DatabaseLayer::DatabaseLayer()
-	: DatabaseErrorReporter()
+	: DatabaseErrorReporter(), m_nStatementCacheSize(64), m_nStatementCacheHits(0), m_nStatementCacheMisses(0),
+	m_nWriteLevel(0), m_nGroupCommitSize(0), m_nGroupCommitWrites(0), m_bGroupCommitOpen(false), m_nGroupCommitDelay(1000),
+	m_pBeforeCommitHandler(NULL), m_pConnectionPool(NULL), m_pDialect(NULL), m_bSchemaLoaded(false), m_bSchemaChangedInWrite(false)
 {
 }
 
@@ -13,6 +17,16 @@ DatabaseLayer::~DatabaseLayer()
 {
 	CloseResultSets();
 	CloseStatements();
+
+	wxDELETE(m_pDialect);
+}
+
+DatabaseDialect* DatabaseLayer::GetDialect()
+{
+	if (m_pDialect == NULL)
+		m_pDialect = CreateDialect();
+
+	return m_pDialect;
 }
 
 #if !wxUSE_UTF8_LOCALE_ONLY
@@ -106,6 +120,9 @@ void DatabaseLayer::CloseResultSets()
 
 void DatabaseLayer::CloseStatements()
 {
+	// Cached statements still in use are moved to the list below
+	ClearStatementCache();
+
 	// Iterate through all of the statements and close them all
 	DatabaseStatementHashSet::iterator start = m_Statements.begin();
 	DatabaseStatementHashSet::iterator stop = m_Statements.end();
@@ -164,6 +181,21 @@ bool DatabaseLayer::CloseStatement(PreparedStatement* pStatement)
 {
 	if (pStatement != NULL)
 	{
+		// Cached statements go back to the cache
+		std::map<PreparedStatement*, cachedStatementList_t::iterator>::iterator foundedHandle = m_StatementCacheHandles.find(pStatement);
+		if (foundedHandle != m_StatementCacheHandles.end())
+		{
+			cachedStatementList_t::iterator itStatement = foundedHandle->second;
+			if (itStatement->m_bInUse)
+			{
+				itStatement->m_bInUse = false;
+				pStatement->ClearBatch();
+				ReleaseCachedStatement(pStatement);
+			}
+			TrimStatementCache();
+			return true;
+		}
+
 		// See if we know about this pointer, if so then remove it from the list
 		if (m_Statements.find(pStatement) != m_Statements.end())
 		{
@@ -183,6 +215,558 @@ bool DatabaseLayer::CloseStatement(PreparedStatement* pStatement)
 	}
 }
 
+PreparedStatement* DatabaseLayer::PrepareCachedStatement(const wxString& strQuery)
+{
+	std::map<wxString, cachedStatementList_t::iterator>::iterator foundedQuery = m_StatementCacheQueries.find(strQuery);
+	if (foundedQuery != m_StatementCacheQueries.end())
+	{
+		cachedStatementList_t::iterator itStatement = foundedQuery->second;
+		if (itStatement->m_bInUse)
+		{
+			// The same text is already running (e.g. from a nested call), so use a plain statement
+			m_nStatementCacheMisses++;
+			return PrepareStatement(strQuery);
+		}
+
+		// A batch or parameters left by the previous user are not carried over
+		itStatement->m_pStatement->ClearBatch();
+
+		if (ReuseCachedStatement(itStatement->m_pStatement))
+		{
+			itStatement->m_pStatement->ClearParameters();
+			m_StatementCache.splice(m_StatementCache.begin(), m_StatementCache, itStatement);
+			itStatement->m_bInUse = true;
+			m_nStatementCacheHits++;
+			return itStatement->m_pStatement;
+		}
+
+		EraseCachedStatement(itStatement);
+	}
+
+	m_nStatementCacheMisses++;
+
+	PreparedStatement* pStatement = PrepareStatement(strQuery);
+	if (pStatement == NULL)
+		return NULL;
+
+	// The cache owns the statement now
+	m_Statements.erase(pStatement);
+
+	cachedStatement_t cachedStatement = { strQuery, pStatement, true };
+	m_StatementCache.push_front(cachedStatement);
+	m_StatementCacheQueries[strQuery] = m_StatementCache.begin();
+	m_StatementCacheHandles[pStatement] = m_StatementCache.begin();
+
+	TrimStatementCache();
+	return pStatement;
+}
+
+void DatabaseLayer::ClearStatementCache()
+{
+	cachedStatementList_t::iterator start = m_StatementCache.begin();
+	cachedStatementList_t::iterator stop = m_StatementCache.end();
+	while (start != stop)
+	{
+		// A statement in use is closed by its owner with CloseStatement()
+		if (start->m_bInUse)
+			LogStatementForCleanup(start->m_pStatement);
+		else
+			delete start->m_pStatement;
+		start++;
+	}
+
+	m_StatementCache.clear();
+	m_StatementCacheQueries.clear();
+	m_StatementCacheHandles.clear();
+}
+
+void DatabaseLayer::SetStatementCacheSize(size_t nSize)
+{
+	m_nStatementCacheSize = nSize;
+	TrimStatementCache();
+}
+
+void DatabaseLayer::EraseCachedStatement(cachedStatementList_t::iterator itStatement)
+{
+	PreparedStatement* pStatement = itStatement->m_pStatement;
+
+	m_StatementCacheQueries.erase(itStatement->m_strQuery);
+	m_StatementCacheHandles.erase(pStatement);
+	m_StatementCache.erase(itStatement);
+
+	delete pStatement;
+}
+
+void DatabaseLayer::TrimStatementCache()
+{
+	// Drop the least recently used statements that are not in use
+	cachedStatementList_t::iterator itStatement = m_StatementCache.end();
+	while (m_StatementCache.size() > m_nStatementCacheSize && itStatement != m_StatementCache.begin())
+	{
+		itStatement--;
+		if (!itStatement->m_bInUse)
+		{
+			cachedStatementList_t::iterator itErase = itStatement++;
+			EraseCachedStatement(itErase);
+		}
+	}
+}
+
+void DatabaseLayer::BeginWrite()
+{
+	if (m_nWriteLevel == 0 && m_nGroupCommitSize > 1 && !m_bGroupCommitOpen)
+	{
+		// Writes are gathered into one transaction until the group is full
+		BeginTransaction();
+		m_bGroupCommitOpen = true;
+		m_nGroupCommitWrites = 0;
+		m_groupCommitStart = wxGetLocalTimeMillis();
+	}
+
+	m_nWriteLevel++;
+
+	if (m_nWriteLevel == 1 && !m_bGroupCommitOpen)
+		BeginTransaction();
+	else
+		RunQuery(wxT("SAVEPOINT ") + GetWriteSavepoint(), false);
+}
+
+void DatabaseLayer::CommitWrite()
+{
+	if (m_nWriteLevel == 0)
+		return;
+
+	bool bCommitted = false;
+
+	if (m_nWriteLevel == 1 && !m_bGroupCommitOpen)
+	{
+		if (m_pBeforeCommitHandler)
+			m_pBeforeCommitHandler();
+
+		Commit();
+		bCommitted = true;
+	}
+	else
+	{
+		RunQuery(wxT("RELEASE SAVEPOINT ") + GetWriteSavepoint(), false);
+	}
+
+	m_nWriteLevel--;
+
+	if (bCommitted)
+		m_bSchemaChangedInWrite = false;
+
+	if (m_nWriteLevel == 0 && m_bGroupCommitOpen)
+	{
+		if (++m_nGroupCommitWrites >= m_nGroupCommitSize || IsGroupCommitExpired())
+			FlushGroupCommit();
+	}
+	else if (bCommitted)
+	{
+		ReleasePendingConnection();
+	}
+}
+
+void DatabaseLayer::RollBackWrite()
+{
+	if (m_nWriteLevel == 0)
+		return;
+
+	bool bRolledBack = false;
+
+	if (m_nWriteLevel == 1 && !m_bGroupCommitOpen)
+	{
+		RollBack();
+		bRolledBack = true;
+	}
+	else
+	{
+		// The savepoint is kept after the rollback, release it as well
+		RunQuery(wxT("ROLLBACK TO SAVEPOINT ") + GetWriteSavepoint(), false);
+		RunQuery(wxT("RELEASE SAVEPOINT ") + GetWriteSavepoint(), false);
+	}
+
+	m_nWriteLevel--;
+
+	// The catalog may hold tables created by the queries undone to the savepoint,
+	//  a whole transaction rolled back has already been handled by RollBack()
+	if (m_bSchemaChangedInWrite)
+		RefreshSchemaCatalog();
+
+	if (bRolledBack)
+		ReleasePendingConnection();
+}
+
+void DatabaseLayer::SchemaRolledBack()
+{
+	// The catalog may hold tables created by the undone queries
+	if (m_bSchemaChangedInWrite)
+	{
+		m_bSchemaChangedInWrite = false;
+		RefreshSchemaCatalog();
+	}
+}
+
+void DatabaseLayer::SetGroupCommitSize(unsigned int nWrites)
+{
+	m_nGroupCommitSize = nWrites;
+	FlushGroupCommit();
+}
+
+bool DatabaseLayer::IsGroupCommitExpired() const
+{
+	return m_bGroupCommitOpen && wxGetLocalTimeMillis() - m_groupCommitStart >= wxLongLong(m_nGroupCommitDelay);
+}
+
+void DatabaseLayer::FlushExpiredGroupCommit()
+{
+	if (IsGroupCommitExpired())
+		FlushGroupCommit();
+}
+
+void DatabaseLayer::FlushGroupCommit()
+{
+	if (m_nWriteLevel > 0 || !m_bGroupCommitOpen)
+		return;
+
+	// The group is still open here, so a failed query of the handler does not end its transaction
+	if (m_pBeforeCommitHandler)
+		m_pBeforeCommitHandler();
+
+	m_bGroupCommitOpen = false;
+	m_nGroupCommitWrites = 0;
+
+	Commit();
+	m_bSchemaChangedInWrite = false;
+
+	ReleasePendingConnection();
+}
+
+void DatabaseLayer::ReleasePendingConnection()
+{
+	// The connection may be handed to another thread right away, so this is the last thing a write does
+	if (m_pConnectionPool != NULL)
+		m_pConnectionPool->ReleasePending(this);
+}
+
+bool DatabaseLayer::IsSchemaQuery(const wxString& strQuery)
+{
+	wxString strCommand;
+	for (wxString::const_iterator it = strQuery.begin(); it != strQuery.end(); ++it)
+	{
+		if (wxIsalpha(*it))
+			strCommand += *it;
+		else if (!strCommand.IsEmpty() || !wxIsspace(*it))
+			break;
+	}
+
+	strCommand.MakeUpper();
+	return strCommand == wxT("CREATE") || strCommand == wxT("ALTER")
+		|| strCommand == wxT("DROP") || strCommand == wxT("RECREATE");
+}
+
+bool DatabaseLayer::TableExists(const wxString& table)
+{
+	if (!IsOpen())
+		return DoTableExists(table);
+
+	schemaObject_t* pObject = FindSchemaObject(table);
+	return pObject != NULL && !pObject->m_bView;
+}
+
+bool DatabaseLayer::ViewExists(const wxString& view)
+{
+	if (!IsOpen())
+		return DoViewExists(view);
+
+	schemaObject_t* pObject = FindSchemaObject(view);
+	return pObject != NULL && pObject->m_bView;
+}
+
+wxArrayString DatabaseLayer::GetTables()
+{
+	if (!IsOpen())
+		return DoGetTables();
+
+	LoadSchemaCatalog();
+	ResolveSchemaObjects();
+
+	wxArrayString returnArray;
+	for (std::map<wxString, schemaObject_t>::iterator it = m_SchemaObjects.begin(); it != m_SchemaObjects.end(); ++it)
+	{
+		if (!it->second.m_bView)
+			returnArray.Add(it->second.m_strName);
+	}
+	return returnArray;
+}
+
+wxArrayString DatabaseLayer::GetViews()
+{
+	if (!IsOpen())
+		return DoGetViews();
+
+	LoadSchemaCatalog();
+	ResolveSchemaObjects();
+
+	wxArrayString returnArray;
+	for (std::map<wxString, schemaObject_t>::iterator it = m_SchemaObjects.begin(); it != m_SchemaObjects.end(); ++it)
+	{
+		if (it->second.m_bView)
+			returnArray.Add(it->second.m_strName);
+	}
+	return returnArray;
+}
+
+wxArrayString DatabaseLayer::GetColumns(const wxString& table)
+{
+	schemaObject_t* pObject = IsOpen() ? FindSchemaObject(table) : NULL;
+	if (pObject == NULL)
+		return DoGetColumns(table);
+
+	if (!pObject->m_bColumnsLoaded)
+	{
+		pObject->m_aColumns = DoGetColumns(pObject->m_strName);
+		pObject->m_bColumnsLoaded = true;
+	}
+	return pObject->m_aColumns;
+}
+
+wxArrayString DatabaseLayer::GetIndexes(const wxString& table)
+{
+	schemaObject_t* pObject = IsOpen() ? FindSchemaObject(table) : NULL;
+	if (pObject == NULL)
+		return DoGetIndexes(table);
+
+	if (!pObject->m_bIndexesLoaded)
+	{
+		pObject->m_aIndexes = DoGetIndexes(pObject->m_strName);
+		pObject->m_bIndexesLoaded = true;
+	}
+	return pObject->m_aIndexes;
+}
+
+void DatabaseLayer::RefreshSchemaCatalog()
+{
+	m_SchemaObjects.clear();
+	m_SchemaChangedNames.clear();
+	m_bSchemaLoaded = false;
+}
+
+void DatabaseLayer::LoadSchemaCatalog()
+{
+	if (m_bSchemaLoaded)
+		return;
+
+	m_SchemaObjects.clear();
+	m_SchemaChangedNames.clear();
+
+	wxArrayString tables = DoGetTables();
+	for (size_t i = 0; i < tables.GetCount(); i++)
+		AddSchemaObject(tables[i], false);
+
+	wxArrayString views = DoGetViews();
+	for (size_t i = 0; i < views.GetCount(); i++)
+		AddSchemaObject(views[i], true);
+
+	m_bSchemaLoaded = true;
+}
+
+void DatabaseLayer::AddSchemaObject(const wxString& strName, bool bView)
+{
+	schemaObject_t& object = m_SchemaObjects[strName.Upper()];
+	object.m_strName = strName;
+	object.m_bView = bView;
+	object.m_bColumnsLoaded = false;
+	object.m_aColumns.Clear();
+	object.m_bIndexesLoaded = false;
+	object.m_aIndexes.Clear();
+}
+
+DatabaseLayer::schemaObject_t* DatabaseLayer::FindSchemaObject(const wxString& strName)
+{
+	LoadSchemaCatalog();
+
+	wxString strKey = strName.Upper();
+
+	std::set<wxString>::iterator foundedChange = m_SchemaChangedNames.find(strKey);
+	if (foundedChange != m_SchemaChangedNames.end())
+	{
+		m_SchemaChangedNames.erase(foundedChange);
+		m_SchemaObjects.erase(strKey);
+
+		if (DoTableExists(strName))
+			AddSchemaObject(strName, false);
+		else if (DoViewExists(strName))
+			AddSchemaObject(strName, true);
+	}
+
+	std::map<wxString, schemaObject_t>::iterator foundedObject = m_SchemaObjects.find(strKey);
+	if (foundedObject == m_SchemaObjects.end())
+		return NULL;
+
+	return &foundedObject->second;
+}
+
+void DatabaseLayer::ResolveSchemaObjects()
+{
+	while (!m_SchemaChangedNames.empty())
+		FindSchemaObject(*m_SchemaChangedNames.begin());
+}
+
+void DatabaseLayer::InvalidateSchemaObject(const wxString& strName, bool bIndexesOnly)
+{
+	std::map<wxString, schemaObject_t>::iterator foundedObject = m_SchemaObjects.find(strName.Upper());
+	if (foundedObject == m_SchemaObjects.end())
+		return;
+
+	if (!bIndexesOnly)
+	{
+		foundedObject->second.m_bColumnsLoaded = false;
+		foundedObject->second.m_aColumns.Clear();
+	}
+
+	foundedObject->second.m_bIndexesLoaded = false;
+	foundedObject->second.m_aIndexes.Clear();
+}
+
+static wxArrayString GetSchemaQueryWords(const wxString& strQuery)
+{
+	// Words of the query, quoted names are kept together without the quotes
+	wxArrayString words;
+	wxString strWord;
+	bool bQuoted = false;
+
+	for (wxString::const_iterator it = strQuery.begin(); it != strQuery.end(); ++it)
+	{
+		wxUniChar ch = *it;
+		if (ch == wxT('"') || ch == wxT('`'))
+		{
+			bQuoted = !bQuoted;
+			continue;
+		}
+
+		if (!bQuoted && (wxIsspace(ch) || ch == wxT('(') || ch == wxT(')') || ch == wxT(',') || ch == wxT(';')))
+		{
+			if (!strWord.IsEmpty())
+			{
+				words.Add(strWord);
+				strWord.clear();
+			}
+			continue;
+		}
+
+		strWord += ch;
+	}
+
+	if (!strWord.IsEmpty())
+		words.Add(strWord);
+
+	return words;
+}
+
+void DatabaseLayer::UpdateSchemaCatalog(const wxString& strQuery)
+{
+	if (!IsSchemaQuery(strQuery))
+		return;
+
+	if (IsTransactionOpen())
+		m_bSchemaChangedInWrite = true;
+
+	if (!m_bSchemaLoaded)
+		return;
+
+	wxArrayString queries = ParseQueries(strQuery);
+	for (size_t i = 0; i < queries.GetCount(); i++)
+	{
+		if (IsSchemaQuery(queries[i]))
+			ApplySchemaQuery(queries[i]);
+	}
+}
+
+void DatabaseLayer::ApplySchemaQuery(const wxString& strQuery)
+{
+	wxArrayString words = GetSchemaQueryWords(strQuery);
+	if (words.IsEmpty())
+		return;
+
+	wxString strCommand = words[0].Upper();
+
+	// Skip the words between the command and the kind of the object
+	size_t nWord = 1;
+	while (nWord < words.GetCount())
+	{
+		wxString strModifier = words[nWord].Upper();
+		if (strModifier != wxT("OR") && strModifier != wxT("ALTER") && strModifier != wxT("REPLACE")
+			&& strModifier != wxT("UNIQUE") && strModifier != wxT("ASC") && strModifier != wxT("ASCENDING")
+			&& strModifier != wxT("DESC") && strModifier != wxT("DESCENDING") && strModifier != wxT("GLOBAL")
+			&& strModifier != wxT("TEMPORARY") && strModifier != wxT("TEMP"))
+			break;
+		nWord++;
+	}
+
+	if (nWord >= words.GetCount())
+		return;
+
+	wxString strKind = words[nWord++].Upper();
+
+	// IF [NOT] EXISTS
+	while (nWord < words.GetCount())
+	{
+		wxString strModifier = words[nWord].Upper();
+		if (strModifier != wxT("IF") && strModifier != wxT("NOT") && strModifier != wxT("EXISTS"))
+			break;
+		nWord++;
+	}
+
+	if (nWord >= words.GetCount())
+		return;
+
+	wxString strName = words[nWord++];
+
+	if (strKind == wxT("TABLE") || strKind == wxT("VIEW"))
+	{
+		if (strCommand == wxT("ALTER") && strKind == wxT("TABLE"))
+		{
+			// A renamed table is found under its new name only after reading the catalog again
+			for (size_t i = nWord; i < words.GetCount(); i++)
+			{
+				if (words[i].Upper() == wxT("RENAME"))
+				{
+					RefreshSchemaCatalog();
+					return;
+				}
+			}
+			InvalidateSchemaObject(strName, false);
+		}
+		else
+		{
+			// The query may fail, so the name is checked in the database on next use
+			m_SchemaChangedNames.insert(strName.Upper());
+		}
+	}
+	else if (strKind == wxT("INDEX"))
+	{
+		if (strCommand == wxT("CREATE"))
+		{
+			for (size_t i = nWord; i + 1 < words.GetCount(); i++)
+			{
+				if (words[i].Upper() == wxT("ON"))
+				{
+					InvalidateSchemaObject(words[i + 1], true);
+					return;
+				}
+			}
+		}
+
+		// The table of the index is not known here
+		for (std::map<wxString, schemaObject_t>::iterator it = m_SchemaObjects.begin(); it != m_SchemaObjects.end(); ++it)
+		{
+			it->second.m_bIndexesLoaded = false;
+			it->second.m_aIndexes.Clear();
+		}
+	}
+}
+
 
 int DatabaseLayer::GetSingleResultInt(const wxString& strSQL, const wxString& strField, bool bRequireUniqueResult /*= true*/)
 {
@@ -16,11 +16,18 @@
 #include <wx/arrstr.h>
 #include <wx/variant.h>
 
+#include <list>
+#include <map>
+#include <set>
+
 #include "databaseLayerDef.h"
 #include "databaseErrorReporter.h"
 #include "databaseStringConverter.h"
 #include "databaseResultSet.h"
 #include "preparedStatement.h"
+#include "databaseDialect.h"
+
+class DatabaseConnectionPool;
 
 WX_DECLARE_HASH_SET(DatabaseResultSet*, wxPointerHash, wxPointerEqual, DatabaseResultSetHashSet);
 WX_DECLARE_HASH_SET(PreparedStatement*, wxPointerHash, wxPointerEqual, DatabaseStatementHashSet);
@@ -51,6 +58,9 @@ public:
 	/// Rollback the current transaction
 	virtual void RollBack() = 0;
 
+	/// SQL dialect of the backend, created on first use and owned by the layer
+	DatabaseDialect* GetDialect();
+
 	// Define formatted run query 
 
 	/// Run an insert, update, or delete query on the database
@@ -93,17 +103,79 @@ public:
 	/// Close a prepared statement previously prepared by the database
 	virtual bool CloseStatement(PreparedStatement* pStatement);
 
+	// Prepared statement cache
+
+	/// Take a prepared statement for the SQL text from the statement cache or prepare a new one.
+	///  Give it back with CloseStatement() or take it through DatabaseStatementLocker, the statement is kept for the next call with the same text
+	PreparedStatement* PrepareCachedStatement(const wxString& strQuery);
+	/// Close all cached statements
+	void ClearStatementCache();
+
+	/// Maximum count of statements kept in the cache
+	void SetStatementCacheSize(size_t nSize);
+	size_t GetStatementCacheSize() const { return m_nStatementCacheSize; }
+
+	/// Cache statistics
+	unsigned long GetStatementCacheHits() const { return m_nStatementCacheHits; }
+	unsigned long GetStatementCacheMisses() const { return m_nStatementCacheMisses; }
+
+	// Write scopes
+
+	/// Begin a write scope. The outermost scope starts a transaction, nested scopes set a savepoint
+	///  inside it, so a failed inner write is undone without touching the outer one
+	void BeginWrite();
+	/// Close the current write scope, the outermost scope commits the transaction
+	void CommitWrite();
+	/// Undo the current write scope, the outermost scope rolls the transaction back
+	void RollBackWrite();
+
+	/// Depth of the open write scopes, 0 when no scope is open
+	unsigned int GetWriteLevel() const { return m_nWriteLevel; }
+	bool IsWriteActive() const { return m_nWriteLevel > 0; }
+
+	/// Group commit: outermost write scopes are committed together once nWrites of them are done.
+	///  0 or 1 commits every write at once, changing the size commits the pending writes
+	void SetGroupCommitSize(unsigned int nWrites);
+	unsigned int GetGroupCommitSize() const { return m_nGroupCommitSize; }
+	/// Commit the writes kept by group commit, does nothing inside a write scope
+	void FlushGroupCommit();
+	/// Longest time in milliseconds the first write of a group waits for its commit, the locks it
+	///  holds (e.g. the number counters) block other sessions until then
+	void SetGroupCommitDelay(unsigned long nMilliseconds) { m_nGroupCommitDelay = nMilliseconds; }
+	unsigned long GetGroupCommitDelay() const { return m_nGroupCommitDelay; }
+	/// Commit the writes kept by group commit if they wait longer than the delay, called when idle
+	void FlushExpiredGroupCommit();
+
+	/// Is a write scope open or are group commit writes pending?
+	bool IsTransactionOpen() const { return m_nWriteLevel > 0 || m_bGroupCommitOpen; }
+
+	/// Called right before the outermost write scope or a group commit is committed,
+	///  the queries it runs are a part of the transaction being committed
+	typedef void(*beforeCommitHandler_t)();
+	void SetBeforeCommitHandler(beforeCommitHandler_t pHandler) { m_pBeforeCommitHandler = pHandler; }
+
+	/// Pool the connection was taken from, it is told when the transaction ends
+	void SetConnectionPool(DatabaseConnectionPool* pPool) { m_pConnectionPool = pPool; }
+	DatabaseConnectionPool* GetConnectionPool() const { return m_pConnectionPool; }
+
 	// Database schema API contributed by M. Szeftel (author of wxActiveRecordGenerator)
+	// The answers come from the schema catalog: tables and views are read once per connection,
+	//  columns and indexes once per table. Schema queries run through RunQuery keep it up to date
 	/// Check for the existence of a table by name
-	virtual bool TableExists(const wxString& table) = 0;
+	bool TableExists(const wxString& table);
 	/// Check for the existence of a view by name
-	virtual bool ViewExists(const wxString& view) = 0;
+	bool ViewExists(const wxString& view);
 	/// Retrieve all table names
-	virtual wxArrayString GetTables() = 0;
+	wxArrayString GetTables();
 	/// Retrieve all view names
-	virtual wxArrayString GetViews() = 0;
+	wxArrayString GetViews();
 	/// Retrieve all column names for a table
-	virtual wxArrayString GetColumns(const wxString& table) = 0;
+	wxArrayString GetColumns(const wxString& table);
+	/// Retrieve all index names for a table
+	wxArrayString GetIndexes(const wxString& table);
+
+	/// Read the schema catalog again on next use, after the schema was changed by another connection
+	void RefreshSchemaCatalog();
 
 	// Database single result retrieval API contributed by Guru Kathiresan
 	/// With the GetSingleResultX API, two additional exception types are thrown:
@@ -184,6 +256,100 @@ protected:
 	/// Add prepared statement object pointer to the list for "garbage collection"
 	void LogStatementForCleanup(PreparedStatement* pStatement) { m_Statements.insert(pStatement); }
 
+	/// Called when a cached statement is handed out again, return false to prepare it anew
+	virtual bool ReuseCachedStatement(PreparedStatement* pStatement) { return true; }
+	/// Called when a cached statement is given back to the cache
+	virtual void ReleaseCachedStatement(PreparedStatement* pStatement) {}
+
+	/// Create the dialect of the backend, the standard SQL dialect by default
+	virtual DatabaseDialect* CreateDialect() { return new DatabaseDialect(); }
+
+	/// Queries changing the schema (CREATE, ALTER, DROP, RECREATE) invalidate cached statements
+	static bool IsSchemaQuery(const wxString& strQuery);
+
+	// Schema catalog support, these read the database without the catalog
+	virtual bool DoTableExists(const wxString& table) = 0;
+	virtual bool DoViewExists(const wxString& view) = 0;
+	virtual wxArrayString DoGetTables() = 0;
+	virtual wxArrayString DoGetViews() = 0;
+	virtual wxArrayString DoGetColumns(const wxString& table) = 0;
+	virtual wxArrayString DoGetIndexes(const wxString& table) = 0;
+
+	/// Apply a schema query to the schema catalog, called by RunQuery before the query runs
+	void UpdateSchemaCatalog(const wxString& strQuery);
+
+private:
+
+	struct cachedStatement_t {
+		wxString m_strQuery;
+		PreparedStatement* m_pStatement;
+		bool m_bInUse;
+	};
+
+	typedef std::list<cachedStatement_t> cachedStatementList_t;
+
+	void EraseCachedStatement(cachedStatementList_t::iterator itStatement);
+	void TrimStatementCache();
+
+	// most recently used statements go first
+	cachedStatementList_t m_StatementCache;
+	std::map<wxString, cachedStatementList_t::iterator> m_StatementCacheQueries;
+	std::map<PreparedStatement*, cachedStatementList_t::iterator> m_StatementCacheHandles;
+
+	size_t m_nStatementCacheSize;
+
+	unsigned long m_nStatementCacheHits;
+	unsigned long m_nStatementCacheMisses;
+
+	wxString GetWriteSavepoint() const { return wxString::Format(wxT("SP_WRITE_%u"), m_nWriteLevel); }
+
+	unsigned int m_nWriteLevel;
+
+	unsigned int m_nGroupCommitSize;
+	unsigned int m_nGroupCommitWrites;
+	bool m_bGroupCommitOpen;
+
+	unsigned long m_nGroupCommitDelay;
+	wxLongLong m_groupCommitStart;
+
+	bool IsGroupCommitExpired() const;
+
+	beforeCommitHandler_t m_pBeforeCommitHandler;
+
+	/// Give the connection back to its pool if it was released while the transaction was open
+	void ReleasePendingConnection();
+
+	DatabaseConnectionPool* m_pConnectionPool;
+
+	DatabaseDialect* m_pDialect;
+
+	struct schemaObject_t {
+		wxString m_strName;
+		bool m_bView;
+		bool m_bColumnsLoaded;
+		wxArrayString m_aColumns;
+		bool m_bIndexesLoaded;
+		wxArrayString m_aIndexes;
+	};
+
+	void LoadSchemaCatalog();
+	void AddSchemaObject(const wxString& strName, bool bView);
+	/// Find a table or view, names changed by schema queries are checked in the database again
+	schemaObject_t* FindSchemaObject(const wxString& strName);
+	void ResolveSchemaObjects();
+	void InvalidateSchemaObject(const wxString& strName, bool bIndexesOnly);
+	void ApplySchemaQuery(const wxString& strQuery);
+	/// Called by RollBack() of the backends, so a rollback not made through RollBackWrite() refreshes the catalog too
+	void SchemaRolledBack();
+
+	// keyed by the upper case name
+	std::map<wxString, schemaObject_t> m_SchemaObjects;
+	std::set<wxString> m_SchemaChangedNames;
+	bool m_bSchemaLoaded;
+
+	// a schema query ran in the open transaction, a rollback must read the catalog again
+	bool m_bSchemaChangedInWrite;
+
 private:
 
 	int GetSingleResultInt(const wxString& strSQL, const wxVariant* field, bool bRequireUniqueResult = true);
@@ -217,5 +383,45 @@ private:
 #endif
 };
 
+/// Statement of the statement cache checked out for the lifetime of the locker,
+///  so it goes back to the cache even when the code using it throws
+class CORE_API DatabaseStatementLocker
+{
+public:
+	DatabaseStatementLocker(DatabaseLayer* pDatabase, const wxString& strQuery)
+		: m_pDatabase(pDatabase), m_pStatement(pDatabase->PrepareCachedStatement(strQuery)) {}
+	~DatabaseStatementLocker() { if (m_pStatement != NULL) m_pDatabase->CloseStatement(m_pStatement); }
+
+	bool IsOk() const { return m_pStatement != NULL; }
+
+	PreparedStatement* GetStatement() const { return m_pStatement; }
+	PreparedStatement* operator->() const { return m_pStatement; }
+
+private:
+	DatabaseLayer* m_pDatabase;
+	PreparedStatement* m_pStatement;
+
+	wxDECLARE_NO_COPY_CLASS(DatabaseStatementLocker);
+};
+
+/// Write scope opened for the lifetime of the object. A scope left without Commit() or RollBack(),
+///  e.g. by an exception thrown from the code running inside it, is rolled back
+class CORE_API DatabaseWriteScope
+{
+public:
+	DatabaseWriteScope(DatabaseLayer* pDatabase)
+		: m_pDatabase(pDatabase), m_bClosed(false) { m_pDatabase->BeginWrite(); }
+	~DatabaseWriteScope() { RollBack(); }
+
+	void Commit() { if (!m_bClosed) { m_bClosed = true; m_pDatabase->CommitWrite(); } }
+	void RollBack() { if (!m_bClosed) { m_bClosed = true; m_pDatabase->RollBackWrite(); } }
+
+private:
+	DatabaseLayer* m_pDatabase;
+	bool m_bClosed;
+
+	wxDECLARE_NO_COPY_CLASS(DatabaseWriteScope);
+};
+
 #endif // __DATABASE_LAYER_H__
 
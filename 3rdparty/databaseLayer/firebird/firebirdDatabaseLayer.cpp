@@ -10,12 +10,26 @@
 
 #include "firebirdPreparedStatement.h"
 #include "firebirdResultSet.h"
+#include "firebirdDialect.h"
 
 #include <wx/file.h>
 #include <wx/stdpaths.h>
 #include <wx/tokenzr.h>
 #include <wx/regex.h>
 
+/// Every transaction is read committed, the explicit ones as well as the quickie transactions
+/// of statements, so a statement that hit an update conflict can be retried in the same
+/// transaction and see the row committed by another session, and all the reads of the layer
+/// see the same data whichever way they are run
+static char s_tpbReadCommitted[] =
+{
+	isc_tpb_version3,
+	isc_tpb_write,
+	isc_tpb_read_committed,
+	isc_tpb_rec_version,
+	isc_tpb_wait
+};
+
 // ctor()
 FirebirdDatabaseLayer::FirebirdDatabaseLayer()
 	: DatabaseLayer()
@@ -320,6 +334,7 @@ bool FirebirdDatabaseLayer::Close()
 {
 	CloseResultSets();
 	CloseStatements();
+	RefreshSchemaCatalog();
 
 	if (m_pDatabase)
 	{
@@ -375,7 +390,7 @@ void FirebirdDatabaseLayer::BeginTransaction()
 		isc_db_handle pDatabase = (isc_db_handle)m_pDatabase;
 		isc_tr_handle pTransaction = (isc_tr_handle)fbNextNode->m_pTransaction;
 
-		int nReturn = m_pInterface->GetIscStartTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pTransaction, 1, &pDatabase, 0 /*tpb_length*/, NULL/*tpb*/);
+		int nReturn = m_pInterface->GetIscStartTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pTransaction, 1, &pDatabase, GetTransactionParametersLength(), GetTransactionParameters());
 
 		m_pDatabase = pDatabase;
 		fbNextNode->m_pTransaction = pTransaction;
@@ -442,12 +457,20 @@ void FirebirdDatabaseLayer::RollBack()
 			m_fbNode = tr_link;
 		}
 	}
+
+	SchemaRolledBack();
 }
 
 // query database
 int FirebirdDatabaseLayer::RunQuery(const wxString& strQuery, bool bParseQuery)
 {
 	ResetErrorCodes();
+
+	// Prepared statements lock the tables they use, so drop them before the schema changes
+	if (IsSchemaQuery(strQuery))
+		ClearStatementCache();
+	UpdateSchemaCatalog(strQuery);
+
 	if (m_pDatabase != NULL)
 	{
 		wxCharBuffer sqlDebugBuffer = ConvertToUnicodeStream(strQuery);
@@ -497,11 +520,16 @@ int FirebirdDatabaseLayer::RunQuery(const wxString& strQuery, bool bParseQuery)
 				if (nReturn != 0)
 				{
 					InterpretErrorCodes();
-					// Manually try to rollback the transaction rather than calling the member RollBack function
-					//  so that we can ignore the error messages
-					isc_tr_handle pTransaction = (isc_tr_handle)m_fbNode->m_pTransaction;
-					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pTransaction);
-					m_fbNode->m_pTransaction = NULL;
+					// Inside a write scope or a group commit Firebird has already undone the failed statement,
+					//  the transaction is kept so the scope can roll back to its savepoint
+					if (bQuickieTransaction || !IsTransactionOpen())
+					{
+						// Manually try to rollback the transaction rather than calling the member RollBack function
+						//  so that we can ignore the error messages
+						isc_tr_handle pTransaction = (isc_tr_handle)m_fbNode->m_pTransaction;
+						m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pTransaction);
+						m_fbNode->m_pTransaction = NULL;
+					}
 
 					ThrowDatabaseException();
 					return DATABASE_LAYER_QUERY_RESULT_ERROR;
@@ -592,7 +620,7 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 			{
 				bManageTransaction = true;
 				isc_db_handle pDatabase = (isc_db_handle)m_pDatabase;
-				int nReturn = m_pInterface->GetIscStartTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction, 1, &pDatabase, 0 /*tpb_length*/, NULL/*tpb*/);
+				int nReturn = m_pInterface->GetIscStartTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction, 1, &pDatabase, GetTransactionParametersLength(), GetTransactionParameters());
 				m_pDatabase = pDatabase;
 				if (nReturn != 0)
 				{
@@ -605,6 +633,10 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 				pQueryTransaction = m_fbNode->m_pTransaction;
 			}
 
+			// A failed query ends the transaction only outside of a write scope and a group commit,
+			//  inside them Firebird has already undone the statement and the scope rolls back to its savepoint
+			bool bRollBackOnError = bManageTransaction || !IsTransactionOpen();
+
 			isc_stmt_handle pStatement = NULL;
 			isc_db_handle pDatabase = (isc_db_handle)m_pDatabase;
 			int nReturn = m_pInterface->GetIscDsqlAllocateStatement()(*(ISC_STATUS_ARRAY*)m_pStatus, &pDatabase, &pStatement);
@@ -615,7 +647,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 				// Manually try to rollback the transaction rather than calling the member RollBack function
 				//  so that we can ignore the error messages
-				m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+				if (bRollBackOnError)
+				{
+					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (!bManageTransaction)
+						m_fbNode->m_pTransaction = NULL;
+				}
 
 				ThrowDatabaseException();
 				return NULL;
@@ -629,7 +666,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 				// Manually try to rollback the transaction rather than calling the member RollBack function
 				//  so that we can ignore the error messages
-				m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+				if (bRollBackOnError)
+				{
+					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (!bManageTransaction)
+						m_fbNode->m_pTransaction = NULL;
+				}
 
 				ThrowDatabaseException();
 				return NULL;
@@ -650,7 +692,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 				// Manually try to rollback the transaction rather than calling the member RollBack function
 				//  so that we can ignore the error messages
-				m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+				if (bRollBackOnError)
+				{
+					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (!bManageTransaction)
+						m_fbNode->m_pTransaction = NULL;
+				}
 
 				ThrowDatabaseException();
 				return NULL;
@@ -671,7 +718,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 					// Manually try to rollback the transaction rather than calling the member RollBack function
 					//  so that we can ignore the error messages
-					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (bRollBackOnError)
+					{
+						m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+						if (!bManageTransaction)
+							m_fbNode->m_pTransaction = NULL;
+					}
 
 					ThrowDatabaseException();
 					return NULL;
@@ -688,7 +740,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 				// Manually try to rollback the transaction rather than calling the member RollBack function
 				//  so that we can ignore the error messages
-				m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+				if (bRollBackOnError)
+				{
+					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (!bManageTransaction)
+						m_fbNode->m_pTransaction = NULL;
+				}
 
 				// Wrap the result set deletion in try/catch block if using exceptions.
 				//We want to make sure the original error gets to the user
@@ -715,7 +772,12 @@ DatabaseResultSet* FirebirdDatabaseLayer::RunQueryWithResults(const wxString& st
 
 				// Manually try to rollback the transaction rather than calling the member RollBack function
 				//  so that we can ignore the error messages
-				m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+				if (bRollBackOnError)
+				{
+					m_pInterface->GetIscRollbackTransaction()(*(ISC_STATUS_ARRAY*)m_pStatus, &pQueryTransaction);
+					if (!bManageTransaction)
+						m_fbNode->m_pTransaction = NULL;
+				}
 
 				// Wrap the result set deletion in try/catch block if using exceptions.
 				//  We want to make sure the isc_dsql_execute error gets to the user
@@ -769,7 +831,29 @@ PreparedStatement* FirebirdDatabaseLayer::PrepareStatement(const wxString& strQu
 	return pStatement;
 }
 
-bool FirebirdDatabaseLayer::TableExists(const wxString& table)
+bool FirebirdDatabaseLayer::ReuseCachedStatement(PreparedStatement* pStatement)
+{
+	// The statement could be prepared in another transaction, so run it in the current one
+	FirebirdPreparedStatement* pFirebirdStatement = dynamic_cast<FirebirdPreparedStatement*>(pStatement);
+	if (pFirebirdStatement == NULL)
+		return false;
+
+	return pFirebirdStatement->BindTransaction(m_fbNode->m_pTransaction);
+}
+
+void FirebirdDatabaseLayer::ReleaseCachedStatement(PreparedStatement* pStatement)
+{
+	FirebirdPreparedStatement* pFirebirdStatement = dynamic_cast<FirebirdPreparedStatement*>(pStatement);
+	if (pFirebirdStatement != NULL)
+		pFirebirdStatement->ReleaseTransaction();
+}
+
+DatabaseDialect* FirebirdDatabaseLayer::CreateDialect()
+{
+	return new FirebirdDialect();
+}
+
+bool FirebirdDatabaseLayer::DoTableExists(const wxString& table)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -835,7 +919,7 @@ bool FirebirdDatabaseLayer::TableExists(const wxString& table)
 	return bReturn;
 	}
 
-bool FirebirdDatabaseLayer::ViewExists(const wxString& view)
+bool FirebirdDatabaseLayer::DoViewExists(const wxString& view)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -901,7 +985,7 @@ bool FirebirdDatabaseLayer::ViewExists(const wxString& view)
 	return bReturn;
 	}
 
-wxArrayString FirebirdDatabaseLayer::GetTables()
+wxArrayString FirebirdDatabaseLayer::DoGetTables()
 {
 	wxArrayString returnArray;
 
@@ -940,7 +1024,7 @@ wxArrayString FirebirdDatabaseLayer::GetTables()
 	return returnArray;
 	}
 
-wxArrayString FirebirdDatabaseLayer::GetViews()
+wxArrayString FirebirdDatabaseLayer::DoGetViews()
 {
 	wxArrayString returnArray;
 
@@ -979,7 +1063,7 @@ wxArrayString FirebirdDatabaseLayer::GetViews()
 	return returnArray;
 	}
 
-wxArrayString FirebirdDatabaseLayer::GetColumns(const wxString& table)
+wxArrayString FirebirdDatabaseLayer::DoGetColumns(const wxString& table)
 {
 	// Initialize variables
 	wxArrayString returnArray;
@@ -1042,6 +1126,69 @@ wxArrayString FirebirdDatabaseLayer::GetColumns(const wxString& table)
 	return returnArray;
 	}
 
+wxArrayString FirebirdDatabaseLayer::DoGetIndexes(const wxString& table)
+{
+	// Initialize variables
+	wxArrayString returnArray;
+	// Keep these variables outside of scope so that we can clean them up
+	//  in case of an error
+	PreparedStatement* pStatement = NULL;
+	DatabaseResultSet* pResult = NULL;
+
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		wxString tableUpperCase = table.Upper();
+		wxString query = _("SELECT RDB$INDEX_NAME FROM RDB$INDICES WHERE RDB$RELATION_NAME=?;");
+		pStatement = PrepareStatement(query);
+		if (pStatement)
+		{
+			pStatement->SetParamString(1, tableUpperCase);
+			pResult = pStatement->ExecuteQuery();
+			if (pResult)
+			{
+				while (pResult->Next())
+				{
+					returnArray.Add(pResult->GetResultString(1).Trim());
+				}
+			}
+		}
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException& e)
+	{
+		if (pResult != NULL)
+		{
+			CloseResultSet(pResult);
+			pResult = NULL;
+		}
+
+		if (pStatement != NULL)
+		{
+			CloseStatement(pStatement);
+			pStatement = NULL;
+		}
+
+		throw e;
+	}
+#endif
+
+	if (pResult != NULL)
+	{
+		CloseResultSet(pResult);
+		pResult = NULL;
+	}
+
+	if (pStatement != NULL)
+	{
+		CloseStatement(pStatement);
+		pStatement = NULL;
+	}
+
+	return returnArray;
+}
+
 int FirebirdDatabaseLayer::TranslateErrorCode(int nCode)
 {
 	// Ultimately, this will probably be a map of Firebird database error code values to DatabaseLayer values
@@ -1095,6 +1242,16 @@ void FirebirdDatabaseLayer::InterpretErrorCodes()
 	}
 }
 
+char* FirebirdDatabaseLayer::GetTransactionParameters()
+{
+	return s_tpbReadCommitted;
+}
+
+short FirebirdDatabaseLayer::GetTransactionParametersLength()
+{
+	return (short)sizeof(s_tpbReadCommitted);
+}
+
 bool FirebirdDatabaseLayer::IsAvailable()
 {
 	bool bAvailable = false;
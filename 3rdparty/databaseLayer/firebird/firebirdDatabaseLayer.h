@@ -67,18 +67,31 @@ public:
 	static wxString TranslateErrorCodeToString(FirebirdInterface* pInterface, int nCode, void* status);
 	static bool IsAvailable();
 
+	/// Transaction parameter block used for every transaction started by the layer and its statements
+	static char* GetTransactionParameters();
+	static short GetTransactionParametersLength();
+
 	void SetServer(const wxString& strServer) { m_strServer = strServer; }
 	void SetDatabase(const wxString& strDatabase) { m_strDatabase = strDatabase; }
 	void SetUser(const wxString& strUser) { m_strUser = strUser; }
 	void SetPassword(const wxString& strPassword) { m_strPassword = strPassword; }
 	void SetRole(const wxString& strRole) { m_strRole = strRole; }
 
+protected:
+
 	// Database schema API contributed by M. Szeftel (author of wxActiveRecordGenerator)
-	virtual bool TableExists(const wxString& table);
-	virtual bool ViewExists(const wxString& view);
-	virtual wxArrayString GetTables();
-	virtual wxArrayString GetViews();
-	virtual wxArrayString GetColumns(const wxString& table);
+	virtual bool DoTableExists(const wxString& table);
+	virtual bool DoViewExists(const wxString& view);
+	virtual wxArrayString DoGetTables();
+	virtual wxArrayString DoGetViews();
+	virtual wxArrayString DoGetColumns(const wxString& table);
+	virtual wxArrayString DoGetIndexes(const wxString& table);
+
+	// Prepared statement cache support
+	virtual bool ReuseCachedStatement(PreparedStatement* pStatement);
+	virtual void ReleaseCachedStatement(PreparedStatement* pStatement);
+
+	virtual DatabaseDialect* CreateDialect();
 
 private:
 
@@ -0,0 +1,52 @@
+#include "firebirdDialect.h"
+
+wxString FirebirdDialect::GetBinaryType(int nLength) const
+{
+	return wxString::Format(wxT("CHAR(%d) CHARACTER SET OCTETS"), nLength);
+}
+
+wxString FirebirdDialect::GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	return wxT("UPDATE OR INSERT INTO ") + strTable + wxT(" (") + wxJoin(columns, wxT(','), 0) + wxT(") VALUES (")
+		+ wxJoin(values, wxT(','), 0) + wxT(") MATCHING (") + wxJoin(keyColumns, wxT(','), 0) + wxT(");");
+}
+
+wxString FirebirdDialect::GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset) const
+{
+	if (nOffset > 0)
+		return wxString::Format(wxT("SELECT FIRST %lu SKIP %lu %s"), nLimit, nOffset, strSelect);
+
+	return wxString::Format(wxT("SELECT FIRST %lu %s"), nLimit, strSelect);
+}
+
+wxString FirebirdDialect::GetSelectWithoutTable(const wxString& strColumns) const
+{
+	return wxT("SELECT ") + strColumns + wxT(" FROM RDB$DATABASE");
+}
+
+wxString FirebirdDialect::GetStartsWith(const wxString& strExpression) const
+{
+	// STARTING WITH uses an index on the expression
+	return strExpression + wxT(" STARTING WITH ?");
+}
+
+wxString FirebirdDialect::GetAddColumn(const wxString& strTable, const wxString& strColumn, const wxString& strType) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s ADD %s %s;"), strTable, strColumn, strType);
+}
+
+wxString FirebirdDialect::GetDropColumn(const wxString& strTable, const wxString& strColumn) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s DROP %s;"), strTable, strColumn);
+}
+
+wxString FirebirdDialect::GetRenameColumn(const wxString& strTable, const wxString& strColumn, const wxString& strNewName) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s ALTER %s TO %s;"), strTable, strColumn, strNewName);
+}
+
+wxString FirebirdDialect::GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const
+{
+	return wxString::Format(wxT("CREATE INDEX %s ON %s COMPUTED BY (%s);"), strIndex, strTable, strExpression);
+}
@@ -0,0 +1,26 @@
+#ifndef __FIREBIRD_DIALECT_H__
+#define __FIREBIRD_DIALECT_H__
+
+#include "databaseLayer/databaseDialect.h"
+
+class CORE_API FirebirdDialect : public DatabaseDialect
+{
+public:
+	virtual int GetDialectType() const { return DATABASE_DIALECT_FIREBIRD; }
+
+	virtual wxString GetBinaryType(int nLength) const;
+
+	virtual wxString GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+	virtual wxString GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset = 0) const;
+	virtual wxString GetSelectWithoutTable(const wxString& strColumns) const;
+	virtual wxString GetStartsWith(const wxString& strExpression) const;
+
+	virtual wxString GetAddColumn(const wxString& strTable, const wxString& strColumn, const wxString& strType) const;
+	virtual wxString GetDropColumn(const wxString& strTable, const wxString& strColumn) const;
+	virtual wxString GetRenameColumn(const wxString& strTable, const wxString& strColumn, const wxString& strNewName) const;
+
+	virtual wxString GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const;
+};
+
+#endif // __FIREBIRD_DIALECT_H__
@@ -184,6 +184,28 @@ FirebirdParameter::FirebirdParameter(FirebirdInterface* pInterface, XSQLVAR* pVa
 	void* pBuffer = m_BufferValue.GetWriteBuf(nDataLength);
 	memcpy(pBuffer, pData, nDataLength);
 	m_nBufferLength = nDataLength;
+
+	// Fixed binary columns (CHAR/VARCHAR CHARACTER SET OCTETS) take the bytes inline, without a blob
+	int nType = (m_pParameter->sqltype & ~1);
+	if (nType == SQL_TEXT)
+	{
+		long nLength = nDataLength < m_pParameter->sqllen ? nDataLength : m_pParameter->sqllen;
+		memcpy(m_pParameter->sqldata, pData, nLength);
+		m_pParameter->sqltype = SQL_TEXT | 1;
+		m_pParameter->sqllen = nLength;
+
+		m_nNullFlag = 0;
+		m_pParameter->sqlind = &m_nNullFlag; // NULL indicator
+	}
+	else if (nType == SQL_VARYING)
+	{
+		short nLength = nDataLength < m_pParameter->sqllen ? nDataLength : m_pParameter->sqllen;
+		memcpy(m_pParameter->sqldata, &nLength, sizeof(short));
+		memcpy(m_pParameter->sqldata + sizeof(short), pData, nLength);
+
+		m_nNullFlag = 0;
+		m_pParameter->sqlind = &m_nNullFlag; // NULL indicator
+	}
 }
 
 void FirebirdParameter::ResetBlob()
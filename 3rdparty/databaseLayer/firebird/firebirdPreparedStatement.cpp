@@ -101,7 +101,7 @@ FirebirdPreparedStatement* FirebirdPreparedStatement::CreateStatement(FirebirdIn
 	{
 		pTransaction = 0L;
 		ISC_STATUS_ARRAY status;
-		int nReturn = pInterface->GetIscStartTransaction()(status, &pTransaction, 1, &pDatabase, 0 /*tpb_length*/, NULL/*tpb*/);
+		int nReturn = pInterface->GetIscStartTransaction()(status, &pTransaction, 1, &pDatabase, FirebirdDatabaseLayer::GetTransactionParametersLength(), FirebirdDatabaseLayer::GetTransactionParameters());
 		pStatement = new FirebirdPreparedStatement(pInterface, pDatabase, pTransaction);
 		pStatement->SetEncoding(conv);
 		if (nReturn != 0)
@@ -195,6 +195,54 @@ FirebirdPreparedStatement* FirebirdPreparedStatement::CreateStatement(FirebirdIn
 	return pStatement;
 }
 
+bool FirebirdPreparedStatement::BindTransaction(isc_tr_handle pTransaction)
+{
+	ResetErrorCodes();
+	ReleaseTransaction();
+
+	if (pTransaction == NULL)
+	{
+		int nReturn = m_pInterface->GetIscStartTransaction()(m_Status, &pTransaction, 1, &m_pDatabase, FirebirdDatabaseLayer::GetTransactionParametersLength(), FirebirdDatabaseLayer::GetTransactionParameters());
+		if (nReturn != 0)
+		{
+			InterpretErrorCodes();
+			return false;
+		}
+
+		m_bManageTransaction = true;
+	}
+
+	m_pTransaction = pTransaction;
+
+	FirebirdStatementVector::iterator start = m_Statements.begin();
+	FirebirdStatementVector::iterator stop = m_Statements.end();
+	while (start != stop)
+	{
+		((FirebirdPreparedStatementWrapper*)(*start))->SetTransaction(m_pTransaction);
+		start++;
+	}
+
+	return true;
+}
+
+void FirebirdPreparedStatement::ReleaseTransaction()
+{
+	CloseResultSets();
+
+	if (m_bManageTransaction && m_pTransaction)
+	{
+		int nReturn = m_pInterface->GetIscCommitTransaction()(m_Status, &m_pTransaction);
+		if (nReturn != 0)
+		{
+			// The commit failed, do not leave the transaction open
+			m_pInterface->GetIscRollbackTransaction()(m_Status, &m_pTransaction);
+		}
+	}
+
+	m_pTransaction = NULL;
+	m_bManageTransaction = false;
+}
+
 // get field
 void FirebirdPreparedStatement::SetParamInt(int nPosition, int nValue)
 {
@@ -284,6 +332,58 @@ int FirebirdPreparedStatement::GetParameterCount()
 
 int FirebirdPreparedStatement::RunQuery()
 {
+	int nRows = RunStatements();
+	if (GetErrorCode() != DATABASE_LAYER_OK)
+		return DATABASE_LAYER_QUERY_RESULT_ERROR;
+
+	// If the statement is managing the transaction then commit it now
+	CommitRetaining();
+
+	return nRows;
+}
+
+void FirebirdPreparedStatement::AddBatch()
+{
+	// Rows are still executed one by one: an EXECUTE BLOCK for several rows needs
+	//  the declared types of its parameters, only the commit is deferred to ExecuteBatch()
+	if (m_bBatchError)
+		return;
+
+	int nRows = RunStatements();
+	if (GetErrorCode() != DATABASE_LAYER_OK)
+		m_bBatchError = true;
+	else if (nRows > 0)
+		m_nBatchRows += nRows;
+}
+
+int FirebirdPreparedStatement::ExecuteBatch()
+{
+	if (!m_bBatchError && !CommitRetaining())
+		m_bBatchError = true;
+
+	return PreparedStatement::ExecuteBatch();
+}
+
+bool FirebirdPreparedStatement::CommitRetaining()
+{
+	if (m_bManageTransaction)
+	{
+		int nReturn = m_pInterface->GetIscCommitRetaining()(m_Status, &m_pTransaction);
+		if (nReturn != 0)
+		{
+			InterpretErrorCodes();
+			ThrowDatabaseException();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int FirebirdPreparedStatement::RunStatements()
+{
+	ResetErrorCodes();
+
 	FirebirdStatementVector::iterator start = m_Statements.begin();
 	FirebirdStatementVector::iterator stop = m_Statements.end();
 
@@ -301,19 +401,6 @@ int FirebirdPreparedStatement::RunQuery()
 		start++;
 	}
 
-	// If the statement is managing the transaction then commit it now
-	if (m_bManageTransaction)
-	{
-		int nReturn = m_pInterface->GetIscCommitRetaining()(m_Status, &m_pTransaction);
-		//int nReturn = isc_commit_transaction(m_Status, &m_pTransaction);
-		// We're done with the transaction, so set it to NULL so that we know that a new transaction must be started if we run any queries
-		if (nReturn != 0)
-		{
-			InterpretErrorCodes();
-			ThrowDatabaseException();
-		}
-	}
-
 	return nRows;
 }
 
@@ -347,7 +434,7 @@ DatabaseResultSet* FirebirdPreparedStatement::RunQueryWithResults()
 			}
 
 			// Start a new transaction
-			nReturn = m_pInterface->GetIscStartTransaction()(m_Status, &m_pTransaction, 1, &m_pDatabase, 0 /*tpb_length*/, NULL/*tpb*/);
+			nReturn = m_pInterface->GetIscStartTransaction()(m_Status, &m_pTransaction, 1, &m_pDatabase, FirebirdDatabaseLayer::GetTransactionParametersLength(), FirebirdDatabaseLayer::GetTransactionParameters());
 			if (nReturn != 0)
 			{
 				InterpretErrorCodes();
@@ -49,12 +49,24 @@ public:
 	virtual int RunQuery();
 	virtual DatabaseResultSet* RunQueryWithResults();
 
+	// batch support - an own transaction is committed once per batch
+	virtual void AddBatch();
+	virtual int ExecuteBatch();
+
 	static FirebirdPreparedStatement* CreateStatement(FirebirdInterface* pInterface, isc_db_handle pDatabase, isc_tr_handle pTransaction, const wxString& strSQL, const wxCSConv* conv);
 
 	void SetManageTransaction(bool bManageTransaction) { m_bManageTransaction = bManageTransaction; }
 
+	// statement cache support: run the statement in the given transaction (or in an own one if NULL)
+	bool BindTransaction(isc_tr_handle pTransaction);
+	// statement cache support: commit the own transaction
+	void ReleaseTransaction();
+
 private:
 
+	int RunStatements();
+	bool CommitRetaining();
+
 	int FindStatementAndAdjustPositionIndex(int* pPosition);
 	void SetInvalidParameterPositionError(int nPosition);
 	void InterpretErrorCodes();
@@ -427,6 +427,21 @@ void* FirebirdResultSet::GetResultBlob(int nField, wxMemoryBuffer& Buffer)
 			tempBufferExactSize.SetBufSize(bufferSize);
 			Buffer = tempBufferExactSize;
 		}
+		else if (nType == SQL_TEXT || nType == SQL_VARYING)
+		{
+			// Fixed binary columns (CHARACTER SET OCTETS) are returned as they are
+			char* pData = pVar->sqldata;
+			unsigned int bufferSize = pVar->sqllen;
+			if (nType == SQL_VARYING)
+			{
+				bufferSize = *(short*)pData;
+				pData += sizeof(short);
+			}
+
+			wxMemoryBuffer tempBuffer(bufferSize);
+			tempBuffer.AppendData(pData, bufferSize);
+			Buffer = tempBuffer;
+		}
 		else
 		{
 			// Incompatible field type
@@ -5,6 +5,7 @@
 #include "mysqlInterface.h"
 #include "mysqlPreparedStatement.h"
 #include "mysqlPreparedStatementResultSet.h"
+#include "mysqlDialect.h"
 #include "databaseLayer/databaseErrorCodes.h"
 #include "databaseLayer/databaseLayerException.h"
 
@@ -221,6 +222,7 @@ bool MysqlDatabaseLayer::Close()
 {
 	CloseResultSets();
 	CloseStatements();
+	RefreshSchemaCatalog();
 
 	ResetErrorCodes();
 	if (m_pDatabase)
@@ -292,6 +294,8 @@ void MysqlDatabaseLayer::RollBack()
 		SetErrorMessage(ConvertFromUnicodeStream(m_pInterface->GetMysqlError()((MYSQL*)m_pDatabase)));
 		ThrowDatabaseException();
 	}
+
+	SchemaRolledBack();
 }
 
 
@@ -300,6 +304,8 @@ int MysqlDatabaseLayer::RunQuery(const wxString& strQuery, bool bParseQuery)
 {
 	ResetErrorCodes();
 
+	UpdateSchemaCatalog(strQuery);
+
 	wxArrayString QueryArray;
 	if (bParseQuery)
 		QueryArray = ParseQueries(strQuery);
@@ -437,7 +443,7 @@ PreparedStatement* MysqlDatabaseLayer::PrepareStatement(const wxString& strQuery
 	return pStatement;
 }
 
-bool MysqlDatabaseLayer::TableExists(const wxString& table)
+bool MysqlDatabaseLayer::DoTableExists(const wxString& table)
 {
 	bool bReturn = false;
 	/*
@@ -518,7 +524,7 @@ bool MysqlDatabaseLayer::TableExists(const wxString& table)
 	return bReturn;
 }
 
-bool MysqlDatabaseLayer::ViewExists(const wxString& view)
+bool MysqlDatabaseLayer::DoViewExists(const wxString& view)
 {
 	bool bReturn = false;
 	/*
@@ -599,7 +605,7 @@ bool MysqlDatabaseLayer::ViewExists(const wxString& view)
 	return bReturn;
 }
 
-wxArrayString MysqlDatabaseLayer::GetTables()
+wxArrayString MysqlDatabaseLayer::DoGetTables()
 {
 	wxArrayString returnArray;
 
@@ -660,7 +666,7 @@ wxArrayString MysqlDatabaseLayer::GetTables()
 	return returnArray;
 }
 
-wxArrayString MysqlDatabaseLayer::GetViews()
+wxArrayString MysqlDatabaseLayer::DoGetViews()
 {
 	wxArrayString returnArray;
 
@@ -702,7 +708,7 @@ wxArrayString MysqlDatabaseLayer::GetViews()
 	return returnArray;
 }
 
-wxArrayString MysqlDatabaseLayer::GetColumns(const wxString& table)
+wxArrayString MysqlDatabaseLayer::DoGetColumns(const wxString& table)
 {
 	wxArrayString returnArray;
 	// Keep these variables outside of scope so that we can clean them up
@@ -743,6 +749,49 @@ wxArrayString MysqlDatabaseLayer::GetColumns(const wxString& table)
 	return returnArray;
 }
 
+wxArrayString MysqlDatabaseLayer::DoGetIndexes(const wxString& table)
+{
+	wxArrayString returnArray;
+	// Keep these variables outside of scope so that we can clean them up
+	//  in case of an error
+	DatabaseResultSet* pResult = NULL;
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		wxString query = wxString::Format(_("SHOW INDEX FROM %s;"), table.c_str());
+		pResult = ExecuteQuery(query);
+
+		// One row per indexed column, Key_name is the third field
+		while (pResult->Next())
+		{
+			wxString index = pResult->GetResultString(3).Trim();
+			if (!index.IsEmpty() && returnArray.Index(index) == wxNOT_FOUND)
+				returnArray.Add(index);
+		}
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException& e)
+	{
+		if (pResult != NULL)
+		{
+			CloseResultSet(pResult);
+			pResult = NULL;
+		}
+
+		throw e;
+	}
+#endif
+
+	if (pResult != NULL)
+	{
+		CloseResultSet(pResult);
+		pResult = NULL;
+	}
+
+	return returnArray;
+}
+
 int MysqlDatabaseLayer::TranslateErrorCode(int nCode)
 {
 	// Ultimately, this will probably be a map of Mysql database error code values to DatabaseLayer values
@@ -760,3 +809,8 @@ bool MysqlDatabaseLayer::IsAvailable()
 	return bAvailable;
 }
 
+
+DatabaseDialect* MysqlDatabaseLayer::CreateDialect()
+{
+	return new MysqlDialect();
+}
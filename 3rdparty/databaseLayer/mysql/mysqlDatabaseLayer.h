@@ -69,16 +69,21 @@ public:
 	// PreparedStatement support
 	virtual PreparedStatement* PrepareStatement(const wxString& strQuery);
 
-	// Database schema API contributed by M. Szeftel (author of wxActiveRecordGenerator)
-	virtual bool TableExists(const wxString& table);
-	virtual bool ViewExists(const wxString& view);
-	virtual wxArrayString GetTables();
-	virtual wxArrayString GetViews();
-	virtual wxArrayString GetColumns(const wxString& table);
-
 	static int TranslateErrorCode(int nCode);
 	static bool IsAvailable();
 
+protected:
+
+	// Database schema API contributed by M. Szeftel (author of wxActiveRecordGenerator)
+	virtual bool DoTableExists(const wxString& table);
+	virtual bool DoViewExists(const wxString& view);
+	virtual wxArrayString DoGetTables();
+	virtual wxArrayString DoGetViews();
+	virtual wxArrayString DoGetColumns(const wxString& table);
+	virtual wxArrayString DoGetIndexes(const wxString& table);
+
+	virtual DatabaseDialect* CreateDialect();
+
 private:
 	void InitDatabase();
 	void ParseServerAndPort(const wxString& strServer);
@@ -0,0 +1,47 @@
+#include "mysqlDialect.h"
+
+wxString MysqlDialect::GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	wxString strUpdate;
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (keyColumns.Index(columns[i], false) != wxNOT_FOUND)
+			continue;
+
+		if (!strUpdate.IsEmpty())
+			strUpdate += wxT(", ");
+		strUpdate += columns[i] + wxT(" = VALUES(") + columns[i] + wxT(")");
+	}
+
+	// The key is assigned to itself when there is nothing else to update
+	if (strUpdate.IsEmpty() && !keyColumns.IsEmpty())
+		strUpdate = keyColumns[0] + wxT(" = ") + keyColumns[0];
+
+	return wxT("INSERT INTO ") + strTable + wxT(" (") + wxJoin(columns, wxT(','), 0) + wxT(") VALUES (")
+		+ wxJoin(values, wxT(','), 0) + wxT(") ON DUPLICATE KEY UPDATE ") + strUpdate + wxT(";");
+}
+
+wxString MysqlDialect::GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset) const
+{
+	if (nOffset > 0)
+		return wxString::Format(wxT("SELECT %s LIMIT %lu, %lu"), strSelect, nOffset, nLimit);
+
+	return wxString::Format(wxT("SELECT %s LIMIT %lu"), strSelect, nLimit);
+}
+
+wxString MysqlDialect::GetStartsWith(const wxString& strExpression) const
+{
+	return strExpression + wxT(" LIKE CONCAT(") + GetLikeParameter() + wxT(", '%') ESCAPE '!'");
+}
+
+wxString MysqlDialect::GetAlterColumnType(const wxString& strTable, const wxString& strColumn, const wxString& strType) const
+{
+	return wxString::Format(wxT("ALTER TABLE %s MODIFY %s %s;"), strTable, strColumn, strType);
+}
+
+wxString MysqlDialect::GetDropIndex(const wxString& strIndex, const wxString& strTable) const
+{
+	return wxString::Format(wxT("DROP INDEX %s ON %s;"), strIndex, strTable);
+}
@@ -0,0 +1,22 @@
+#ifndef __MYSQL_DIALECT_H__
+#define __MYSQL_DIALECT_H__
+
+#include "databaseLayer/databaseDialect.h"
+
+class CORE_API MysqlDialect : public DatabaseDialect
+{
+public:
+	virtual int GetDialectType() const { return DATABASE_DIALECT_MYSQL; }
+
+	virtual wxString GetBlobType() const { return wxT("LONGBLOB"); }
+
+	virtual wxString GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+	virtual wxString GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset = 0) const;
+	virtual wxString GetStartsWith(const wxString& strExpression) const;
+
+	virtual wxString GetAlterColumnType(const wxString& strTable, const wxString& strColumn, const wxString& strType) const;
+	virtual wxString GetDropIndex(const wxString& strIndex, const wxString& strTable) const;
+};
+
+#endif // __MYSQL_DIALECT_H__
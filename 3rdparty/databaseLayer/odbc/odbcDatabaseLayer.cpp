@@ -186,6 +186,7 @@ bool OdbcDatabaseLayer::Close()
 
 	CloseResultSets();
 	CloseStatements();
+	RefreshSchemaCatalog();
 
 	if (m_bIsConnected)
 	{
@@ -255,12 +256,16 @@ void OdbcDatabaseLayer::RollBack()
 		InterpretErrorCodes(nRet);
 		ThrowDatabaseException();
 	}
+
+	SchemaRolledBack();
 }
 
 int OdbcDatabaseLayer::RunQuery(const wxString& strQuery, bool bParseQuery)
 {
 	ResetErrorCodes();
 
+	UpdateSchemaCatalog(strQuery);
+
 	//wxPrintf("Running: '%s'\n", strQuery.c_str());
 	OdbcPreparedStatement* pStatement = (OdbcPreparedStatement*)PrepareStatement(strQuery, bParseQuery);
 
@@ -376,7 +381,7 @@ PreparedStatement* OdbcDatabaseLayer::PrepareStatement(const wxString& strQuery,
 	return pReturnStatement;
 }
 
-bool OdbcDatabaseLayer::TableExists(const wxString& table)
+bool OdbcDatabaseLayer::DoTableExists(const wxString& table)
 {
 	bool bReturn = false;
 	// Use SQLTables
@@ -408,7 +413,7 @@ bool OdbcDatabaseLayer::TableExists(const wxString& table)
 	return bReturn;
 }
 
-bool OdbcDatabaseLayer::ViewExists(const wxString& view)
+bool OdbcDatabaseLayer::DoViewExists(const wxString& view)
 {
 	bool bReturn = false;
 	// Use SQLTables
@@ -440,7 +445,7 @@ bool OdbcDatabaseLayer::ViewExists(const wxString& view)
 	return bReturn;
 }
 
-wxArrayString OdbcDatabaseLayer::GetTables()
+wxArrayString OdbcDatabaseLayer::DoGetTables()
 {
 	wxArrayString returnArray;
 	SQLHSTMT pStatement = allocStmth();
@@ -495,7 +500,7 @@ wxArrayString OdbcDatabaseLayer::GetTables()
 	return returnArray;
 }
 
-wxArrayString OdbcDatabaseLayer::GetViews()
+wxArrayString OdbcDatabaseLayer::DoGetViews()
 {
 	wxArrayString returnArray;
 	SQLHSTMT pStatement = allocStmth();
@@ -551,7 +556,7 @@ wxArrayString OdbcDatabaseLayer::GetViews()
 	return returnArray;
 }
 
-wxArrayString OdbcDatabaseLayer::GetColumns(const wxString& table)
+wxArrayString OdbcDatabaseLayer::DoGetColumns(const wxString& table)
 {
 	wxArrayString returnArray;
 	// Use SQLColumns
@@ -607,6 +612,65 @@ wxArrayString OdbcDatabaseLayer::GetColumns(const wxString& table)
 	return returnArray;
 }
 
+wxArrayString OdbcDatabaseLayer::DoGetIndexes(const wxString& table)
+{
+	wxArrayString returnArray;
+	// Use SQLStatistics
+	SQLHSTMT pStatement = allocStmth();
+	wxCharBuffer tableBuffer = ConvertToUnicodeStream(table);
+	int tableBufferLength = GetEncodedStreamLength(table);
+	SQLRETURN nRet = m_pInterface->GetSQLStatistics()(pStatement,
+		NULL, 0,
+		NULL, 0,
+		(SQLTCHAR*)(const char*)tableBuffer, tableBufferLength,
+		SQL_INDEX_ALL, SQL_QUICK);
+
+	if (nRet != SQL_SUCCESS)
+	{
+		InterpretErrorCodes(nRet);
+		m_pInterface->GetSQLFreeStmt()(pStatement, SQL_CLOSE);
+		ThrowDatabaseException();
+		return returnArray;
+	}
+
+	nRet = m_pInterface->GetSQLFetch()(pStatement);
+	while (nRet == SQL_SUCCESS || nRet == SQL_SUCCESS_WITH_INFO)
+	{
+		SQLTCHAR buff[8192];
+
+		memset(buff, 0, 8192 * sizeof(SQLTCHAR));
+
+#ifdef _WIN64
+		SQLLEN  col_size = 8192;
+		SQLLEN  real_size = 0;
+#else
+		SQLINTEGER  col_size = 8192;
+		SQLINTEGER  real_size = 0;
+#endif // _WIN64
+		int nField = 6;
+
+		SQLRETURN nGetDataReturn = m_pInterface->GetSQLGetData()(pStatement, nField, SQL_C_CHAR, buff,
+			col_size, &real_size);
+		if (nGetDataReturn != SQL_SUCCESS && nGetDataReturn != SQL_SUCCESS_WITH_INFO)
+		{
+			InterpretErrorCodes(nRet);
+			m_pInterface->GetSQLFreeStmt()(pStatement, SQL_CLOSE);
+			ThrowDatabaseException();
+			return returnArray;
+		}
+
+		// One row per indexed column, the table statistics row has no index name
+		wxString strIndex = (real_size == SQL_NULL_DATA) ? wxString() : ConvertFromUnicodeStream((const char*)buff);
+		if (!strIndex.IsEmpty() && returnArray.Index(strIndex) == wxNOT_FOUND)
+			returnArray.Add(strIndex);
+		nRet = m_pInterface->GetSQLFetch()(pStatement);
+	}
+
+	m_pInterface->GetSQLFreeStmt()(pStatement, SQL_CLOSE);
+
+	return returnArray;
+}
+
 //void OdbcDatabaseLayer::InterpretErrorCodes( long nCode, SQLHSTMT stmth_ptr )
 void OdbcDatabaseLayer::InterpretErrorCodes(long nCode, void* stmth_ptr)
 {
@@ -160,6 +160,16 @@ bool OdbcInterface::Init()
 		return false;
 	}
 
+	symbol = wxT("SQLStatistics");
+	if (m_OdbcDLL.HasSymbol(symbol))
+	{
+		m_pSQLStatistics = (SQLStatisticsType)m_OdbcDLL.GetSymbol(symbol);
+	}
+	else
+	{
+		return false;
+	}
+
 	symbol = wxT("SQLGetDiagRec");
 	if (m_OdbcDLL.HasSymbol(symbol))
 	{
@@ -36,6 +36,8 @@ typedef SQLRETURN(SQL_API *SQLGetDataType)(SQLHSTMT, SQLUSMALLINT, SQLSMALLINT,
 	SQLPOINTER, SQLLEN, SQLLEN*);
 typedef SQLRETURN(SQL_API *SQLColumnsType)(SQLHSTMT, SQLTCHAR*, SQLSMALLINT, SQLTCHAR*,
 	SQLSMALLINT, SQLTCHAR*, SQLSMALLINT, SQLTCHAR*, SQLSMALLINT);
+typedef SQLRETURN(SQL_API *SQLStatisticsType)(SQLHSTMT, SQLTCHAR*, SQLSMALLINT, SQLTCHAR*,
+	SQLSMALLINT, SQLTCHAR*, SQLSMALLINT, SQLUSMALLINT, SQLUSMALLINT);
 typedef SQLRETURN(SQL_API *SQLGetDiagRecType)(SQLSMALLINT, SQLHANDLE, SQLSMALLINT, SQLTCHAR*,
 	SQLINTEGER*, SQLTCHAR*, SQLSMALLINT, SQLSMALLINT*);
 typedef SQLRETURN(SQL_API *SQLNumParamsType)(SQLHSTMT, SQLSMALLINT*);
@@ -75,6 +77,7 @@ public:
 	SQLFetchType GetSQLFetch() { return m_pSQLFetch; }
 	SQLGetDataType GetSQLGetData() { return m_pSQLGetData; }
 	SQLColumnsType GetSQLColumns() { return m_pSQLColumns; }
+	SQLStatisticsType GetSQLStatistics() { return m_pSQLStatistics; }
 	SQLGetDiagRecType GetSQLGetDiagRec() { return m_pSQLGetDiagRec; }
 	SQLNumParamsType GetSQLNumParams() { return m_pSQLNumParams; }
 	SQLExecuteType GetSQLExecute() { return m_pSQLExecute; }
@@ -106,6 +109,7 @@ private:
 	SQLFetchType m_pSQLFetch;
 	SQLGetDataType m_pSQLGetData;
 	SQLColumnsType m_pSQLColumns;
+	SQLStatisticsType m_pSQLStatistics;
 	SQLGetDiagRecType m_pSQLGetDiagRec;
 	SQLNumParamsType m_pSQLNumParams;
 	SQLExecuteType m_pSQLExecute;
@@ -2,6 +2,7 @@
 #include "postgresInterface.h"
 #include "postgresResultSet.h"
 #include "postgresPreparedStatement.h"
+#include "postgresDialect.h"
 
 #include "databaseLayer/databaseErrorCodes.h"
 #include "databaseLayer/databaseLayerException.h"
@@ -248,6 +249,7 @@ bool PostgresDatabaseLayer::Close()
 {
 	CloseResultSets();
 	CloseStatements();
+	RefreshSchemaCatalog();
 
 	if (m_pDatabase)
 	{
@@ -285,6 +287,7 @@ void PostgresDatabaseLayer::Commit()
 void PostgresDatabaseLayer::RollBack()
 {
 	RunQuery(_("ROLLBACK"), false);
+	SchemaRolledBack();
 }
 
 
@@ -295,6 +298,11 @@ int PostgresDatabaseLayer::RunQuery(const wxString& strQuery, bool WXUNUSED(bPar
 
 	ResetErrorCodes();
 
+	// Cached plans can not change their result type, so drop them before the schema changes
+	if (IsSchemaQuery(strQuery))
+		ClearStatementCache();
+	UpdateSchemaCatalog(strQuery);
+
 	wxCharBuffer sqlBuffer = ConvertToUnicodeStream(strQuery);
 	PGresult* pResultCode = m_pInterface->GetPQexec()((PGconn*)m_pDatabase, sqlBuffer);
 	if ((pResultCode == NULL) || (m_pInterface->GetPQresultStatus()(pResultCode) != PGRES_COMMAND_OK))
@@ -348,7 +356,7 @@ PreparedStatement* PostgresDatabaseLayer::PrepareStatement(const wxString& strQu
 	return pStatement;
 }
 
-bool PostgresDatabaseLayer::TableExists(const wxString& table)
+bool PostgresDatabaseLayer::DoTableExists(const wxString& table)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -413,7 +421,7 @@ bool PostgresDatabaseLayer::TableExists(const wxString& table)
 	return bReturn;
 }
 
-bool PostgresDatabaseLayer::ViewExists(const wxString& view)
+bool PostgresDatabaseLayer::DoViewExists(const wxString& view)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -478,7 +486,7 @@ bool PostgresDatabaseLayer::ViewExists(const wxString& view)
 	return bReturn;
 }
 
-wxArrayString PostgresDatabaseLayer::GetTables()
+wxArrayString PostgresDatabaseLayer::DoGetTables()
 {
 	wxArrayString returnArray;
 
@@ -517,7 +525,7 @@ wxArrayString PostgresDatabaseLayer::GetTables()
 	return returnArray;
 }
 
-wxArrayString PostgresDatabaseLayer::GetViews()
+wxArrayString PostgresDatabaseLayer::DoGetViews()
 {
 	wxArrayString returnArray;
 
@@ -556,7 +564,7 @@ wxArrayString PostgresDatabaseLayer::GetViews()
 	return returnArray;
 }
 
-wxArrayString PostgresDatabaseLayer::GetColumns(const wxString& table)
+wxArrayString PostgresDatabaseLayer::DoGetColumns(const wxString& table)
 {
 	// Initialize variables
 	wxArrayString returnArray;
@@ -619,6 +627,68 @@ wxArrayString PostgresDatabaseLayer::GetColumns(const wxString& table)
 	return returnArray;
 }
 
+wxArrayString PostgresDatabaseLayer::DoGetIndexes(const wxString& table)
+{
+	// Initialize variables
+	wxArrayString returnArray;
+	// Keep these variables outside of scope so that we can clean them up
+	//  in case of an error
+	PreparedStatement* pStatement = NULL;
+	DatabaseResultSet* pResult = NULL;
+
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		wxString query = _("SELECT indexname FROM pg_indexes WHERE tablename=?;");
+		pStatement = PrepareStatement(query);
+		if (pStatement)
+		{
+			pStatement->SetParamString(1, table);
+			pResult = pStatement->ExecuteQuery();
+			if (pResult)
+			{
+				while (pResult->Next())
+				{
+					returnArray.Add(pResult->GetResultString(1));
+				}
+			}
+		}
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException& e)
+	{
+		if (pResult != NULL)
+		{
+			CloseResultSet(pResult);
+			pResult = NULL;
+		}
+
+		if (pStatement != NULL)
+		{
+			CloseStatement(pStatement);
+			pStatement = NULL;
+		}
+
+		throw e;
+	}
+#endif
+
+	if (pResult != NULL)
+	{
+		CloseResultSet(pResult);
+		pResult = NULL;
+	}
+
+	if (pStatement != NULL)
+	{
+		CloseStatement(pStatement);
+		pStatement = NULL;
+	}
+
+	return returnArray;
+}
+
 int PostgresDatabaseLayer::TranslateErrorCode(int nCode)
 {
 	// Ultimately, this will probably be a map of Postgresql database error code values to DatabaseLayer values
@@ -636,3 +706,8 @@ bool PostgresDatabaseLayer::IsAvailable()
 	return bAvailable;
 }
 
+
+DatabaseDialect* PostgresDatabaseLayer::CreateDialect()
+{
+	return new PostgresDialect();
+}
@@ -0,0 +1,20 @@
+#include "postgresDialect.h"
+
+wxString PostgresDialect::GetBinaryLiteral(const wxString& strHex) const
+{
+	return wxT("decode('") + strHex + wxT("', 'hex')");
+}
+
+wxString PostgresDialect::GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	return GetInsertOnConflict(strTable, columns, values, keyColumns);
+}
+
+wxString PostgresDialect::GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset) const
+{
+	if (nOffset > 0)
+		return wxString::Format(wxT("SELECT %s LIMIT %lu OFFSET %lu"), strSelect, nLimit, nOffset);
+
+	return wxString::Format(wxT("SELECT %s LIMIT %lu"), strSelect, nLimit);
+}
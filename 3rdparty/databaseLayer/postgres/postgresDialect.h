@@ -0,0 +1,20 @@
+#ifndef __POSTGRES_DIALECT_H__
+#define __POSTGRES_DIALECT_H__
+
+#include "databaseLayer/databaseDialect.h"
+
+class CORE_API PostgresDialect : public DatabaseDialect
+{
+public:
+	virtual int GetDialectType() const { return DATABASE_DIALECT_POSTGRES; }
+
+	virtual wxString GetBinaryType(int nLength) const { return wxT("BYTEA"); }
+	virtual wxString GetBlobType() const { return wxT("BYTEA"); }
+	virtual wxString GetBinaryLiteral(const wxString& strHex) const;
+
+	virtual wxString GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+	virtual wxString GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset = 0) const;
+};
+
+#endif // __POSTGRES_DIALECT_H__
@@ -211,6 +211,67 @@ DatabaseResultSet* PostgresPreparedStatement::RunQueryWithResults()
 	return pResultSet;
 }
 
+void PostgresPreparedStatement::AddBatch()
+{
+	if (m_bBatchError)
+		return;
+
+	if (m_Statements.size() != 1 || !m_Statements[0].CanBatch())
+	{
+		PreparedStatement::AddBatch();
+		return;
+	}
+
+	int nRows = m_Statements[0].AddBatchRow();
+	if (m_Statements[0].GetErrorCode() != DATABASE_LAYER_OK)
+	{
+		m_bBatchError = true;
+		SetErrorCode(m_Statements[0].GetErrorCode());
+		SetErrorMessage(m_Statements[0].GetErrorMessage());
+	}
+	else if (nRows > 0)
+	{
+		m_nBatchRows += nRows;
+	}
+}
+
+int PostgresPreparedStatement::ExecuteBatch()
+{
+	if (m_bBatchError)
+	{
+		ClearBatch();
+		return DATABASE_LAYER_QUERY_RESULT_ERROR;
+	}
+
+	if (m_Statements.size() == 1)
+	{
+		int nRows = m_Statements[0].RunBatch();
+		if (m_Statements[0].GetErrorCode() != DATABASE_LAYER_OK)
+		{
+			m_bBatchError = true;
+			SetErrorCode(m_Statements[0].GetErrorCode());
+			SetErrorMessage(m_Statements[0].GetErrorMessage());
+		}
+		else if (nRows > 0)
+		{
+			m_nBatchRows += nRows;
+		}
+	}
+
+	return PreparedStatement::ExecuteBatch();
+}
+
+void PostgresPreparedStatement::ClearBatch()
+{
+	// Buffered rows of a batch that was not executed are not written
+	for (unsigned int i = 0; i < m_Statements.size(); i++)
+	{
+		m_Statements[i].ClearBatchRows();
+	}
+
+	PreparedStatement::ClearBatch();
+}
+
 wxString PostgresPreparedStatement::GenerateRandomStatementName()
 {
 	// Just come up with a string prefixed with "databaselayer_" and 10 random characters
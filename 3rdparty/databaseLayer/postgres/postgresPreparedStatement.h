@@ -52,6 +52,13 @@ public:
 	virtual int RunQuery();
 	virtual DatabaseResultSet* RunQueryWithResults();
 
+	// batch support
+	/// An INSERT with a single VALUES row buffers the rows and sends them as one multi-row statement,
+	///  any other statement runs every row at once
+	virtual void AddBatch();
+	virtual int ExecuteBatch();
+	virtual void ClearBatch();
+
 	static wxString TranslateSQL(const wxString& strOriginalSQL);
 
 private:
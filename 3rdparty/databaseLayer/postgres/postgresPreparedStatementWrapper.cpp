@@ -2,10 +2,18 @@
 #include "postgresResultSet.h"
 #include "postgresDatabaseLayer.h"
 
+#include "postgresPreparedStatement.h"
+
 #include "databaseLayer/databaseErrorCodes.h"
 
+#include <wx/tokenzr.h>
+
+/// Rows sent in one statement, the protocol also limits a statement to 65535 parameters
+static const int s_nBatchMaxRows = 100;
+static const int s_nMaxParameters = 65535;
+
 PostgresPreparedStatementWrapper::PostgresPreparedStatementWrapper(PostgresInterface* pInterface, PGconn* pDatabase, const wxString& strSQL, const wxString& strStatementName)
-	: DatabaseErrorReporter(), m_strSQL(strSQL), m_strStatementName(strStatementName)
+	: DatabaseErrorReporter(), m_strSQL(strSQL), m_strStatementName(strStatementName), m_nBatchMode(-1), m_nBatchRowParameters(0)
 {
 	m_pInterface = pInterface;
 	m_pDatabase = pDatabase;
@@ -154,4 +162,222 @@ DatabaseResultSet* PostgresPreparedStatementWrapper::RunQueryWithResults()
 	return NULL;
 }
 
+bool PostgresPreparedStatementWrapper::CanBatch()
+{
+	if (m_nBatchMode == -1)
+		m_nBatchMode = ParseBatchQuery() ? 1 : 0;
+
+	return m_nBatchMode == 1;
+}
+
+bool PostgresPreparedStatementWrapper::ParseBatchQuery()
+{
+	// Only the statements built by the dialect are recognized: no literals, one '?' for every column
+	wxString strUpper = m_strSQL.Upper();
+	if (!wxString(strUpper).Trim(false).StartsWith(wxT("INSERT")) || m_strSQL.Find('\'') != wxNOT_FOUND)
+		return false;
+
+	int nValues = strUpper.Find(wxT(" VALUES"));
+	if (nValues == wxNOT_FOUND)
+		return false;
+
+	size_t nRowStart = strUpper.find('(', nValues);
+	size_t nRowEnd = strUpper.find(')', nValues);
+	if (nRowStart == wxString::npos || nRowEnd == wxString::npos || nRowEnd < nRowStart)
+		return false;
+	if (!strUpper.Mid(nValues + 7, nRowStart - nValues - 7).Trim().IsEmpty())
+		return false;
+
+	wxString strRow = m_strSQL.Mid(nRowStart, nRowEnd - nRowStart + 1);
+	int nRowParameters = strRow.Freq('?');
+	if (nRowParameters == 0 || nRowParameters != m_strSQL.Freq('?'))
+		return false;
+	for (size_t i = 1; i + 1 < strRow.length(); i++)
+	{
+		wxChar character = strRow[i];
+		if (character != '?' && character != ',' && !wxIsspace(character))
+			return false;
+	}
+
+	wxString strPrefix = m_strSQL.Left(nValues);
+	int nColumnsStart = strPrefix.Find('(');
+	int nColumnsEnd = strPrefix.Find(')', true);
+	if (nColumnsStart == wxNOT_FOUND || nColumnsEnd < nColumnsStart)
+		return false;
+	wxArrayString columns = wxStringTokenize(strPrefix.Mid(nColumnsStart + 1, nColumnsEnd - nColumnsStart - 1), wxT(","));
+	if ((int)columns.size() != nRowParameters)
+		return false;
+
+	wxString strSuffix = m_strSQL.Mid(nRowEnd + 1);
+	strSuffix.Trim();
+	if (strSuffix.EndsWith(wxT(";")))
+		strSuffix.RemoveLast();
+
+	// A statement can not update one row twice, a row repeating the key of a buffered row starts a new statement
+	std::vector<int> aKeyParameters;
+	int nConflict = strSuffix.Upper().Find(wxT("ON CONFLICT"));
+	if (nConflict != wxNOT_FOUND)
+	{
+		size_t nKeysStart = strSuffix.find('(', nConflict);
+		size_t nKeysEnd = strSuffix.find(')', nConflict);
+		if (nKeysStart == wxString::npos || nKeysEnd == wxString::npos || nKeysEnd < nKeysStart)
+			return false;
+		wxArrayString keyColumns = wxStringTokenize(strSuffix.Mid(nKeysStart + 1, nKeysEnd - nKeysStart - 1), wxT(","));
+		for (size_t i = 0; i < keyColumns.size(); i++)
+		{
+			int nKey = wxNOT_FOUND;
+			for (size_t j = 0; j < columns.size() && nKey == wxNOT_FOUND; j++)
+			{
+				if (columns[j].Strip(wxString::both).IsSameAs(keyColumns[i].Strip(wxString::both), false))
+					nKey = j;
+			}
+			if (nKey == wxNOT_FOUND)
+				return false;
+			aKeyParameters.push_back(nKey);
+		}
+	}
+
+	m_strBatchPrefix = strPrefix + wxT(" VALUES ");
+	m_strBatchRow = strRow;
+	m_strBatchSuffix = strSuffix;
+	m_nBatchRowParameters = nRowParameters;
+	m_aBatchKeyParameters = aKeyParameters;
+	return true;
+}
+
+std::string PostgresPreparedStatementWrapper::GetBatchKey(PostgresPreparedStatementParameterCollection& Parameters)
+{
+	std::string strKey;
+	char** paramValues = Parameters.GetParamValues();
+	int* paramLengths = Parameters.GetParamLengths();
+	int* paramFormats = Parameters.GetParamFormats();
+	for (size_t i = 0; i < m_aBatchKeyParameters.size(); i++)
+	{
+		int nParameter = m_aBatchKeyParameters[i];
+		if (nParameter >= Parameters.GetSize() || paramValues[nParameter] == NULL)
+		{
+			strKey += 'N';
+		}
+		else
+		{
+			size_t nLength = paramFormats[nParameter] ? paramLengths[nParameter] : strlen(paramValues[nParameter]);
+			strKey += std::to_string(nLength) + ':';
+			strKey.append(paramValues[nParameter], nLength);
+		}
+		strKey += '|';
+	}
+	delete[]paramValues;
+	delete[]paramLengths;
+	delete[]paramFormats;
+	return strKey;
+}
+
+int PostgresPreparedStatementWrapper::AddBatchRow()
+{
+	int nRows = 0;
+
+	std::string strKey = GetBatchKey(m_Parameters);
+	int nMaxRows = wxMin(s_nBatchMaxRows, s_nMaxParameters / m_nBatchRowParameters);
+	if ((int)m_aBatchRows.size() >= nMaxRows || (!m_aBatchKeyParameters.empty() && m_aBatchKeys.count(strKey) > 0))
+	{
+		nRows = RunBatch();
+		if (nRows == DATABASE_LAYER_QUERY_RESULT_ERROR && GetErrorCode() != DATABASE_LAYER_OK)
+			return DATABASE_LAYER_QUERY_RESULT_ERROR;
+	}
+
+	m_aBatchRows.push_back(m_Parameters);
+	if (!m_aBatchKeyParameters.empty())
+		m_aBatchKeys.insert(strKey);
+
+	return nRows;
+}
+
+int PostgresPreparedStatementWrapper::RunBatch()
+{
+	if (m_aBatchRows.empty())
+		return 0;
+
+	ResetErrorCodes();
 
+	wxString strQuery = m_strBatchPrefix;
+	for (size_t i = 0; i < m_aBatchRows.size(); i++)
+	{
+		if (i > 0)
+			strQuery += wxT(", ");
+		strQuery += m_strBatchRow;
+	}
+	strQuery += wxT(" ") + m_strBatchSuffix;
+
+	int nParameters = m_aBatchRows.size() * m_nBatchRowParameters;
+	char** paramValues = new char*[nParameters];
+	int* paramLengths = new int[nParameters];
+	int* paramFormats = new int[nParameters];
+	for (size_t i = 0; i < m_aBatchRows.size(); i++)
+	{
+		PostgresPreparedStatementParameterCollection& Parameters = m_aBatchRows[i];
+		int nSize = wxMin(Parameters.GetSize(), m_nBatchRowParameters);
+		char** rowValues = Parameters.GetParamValues();
+		int* rowLengths = Parameters.GetParamLengths();
+		int* rowFormats = Parameters.GetParamFormats();
+		for (int j = 0; j < m_nBatchRowParameters; j++)
+		{
+			// Parameters that were never set are sent as NULL, as a single row would send them
+			int nParameter = i * m_nBatchRowParameters + j;
+			paramValues[nParameter] = (j < nSize) ? rowValues[j] : NULL;
+			paramLengths[nParameter] = (j < nSize) ? rowLengths[j] : 0;
+			paramFormats[nParameter] = (j < nSize) ? rowFormats[j] : 0;
+		}
+		delete[]rowValues;
+		delete[]rowLengths;
+		delete[]rowFormats;
+	}
+
+	// The unnamed statement is replaced by the next one, nothing stays prepared on the server
+	long nRows = -1;
+	wxCharBuffer sqlBuffer = ConvertToUnicodeStream(PostgresPreparedStatement::TranslateSQL(strQuery));
+	PGresult* pResult = m_pInterface->GetPQprepare()(m_pDatabase, "", sqlBuffer, 0, NULL);
+	if (pResult != NULL && m_pInterface->GetPQresultStatus()(pResult) == PGRES_COMMAND_OK)
+	{
+		m_pInterface->GetPQclear()(pResult);
+		pResult = m_pInterface->GetPQexecPrepared()(m_pDatabase, "", nParameters, paramValues, paramLengths, paramFormats, 0);
+	}
+	if (pResult != NULL)
+	{
+		ExecStatusType status = m_pInterface->GetPQresultStatus()(pResult);
+		if ((status != PGRES_COMMAND_OK) && (status != PGRES_TUPLES_OK))
+		{
+			SetErrorCode(PostgresDatabaseLayer::TranslateErrorCode(status));
+			SetErrorMessage(ConvertFromUnicodeStream(m_pInterface->GetPQresultErrorMessage()(pResult)));
+		}
+		else
+		{
+			wxString rowsAffected = ConvertFromUnicodeStream(m_pInterface->GetPQcmdTuples()(pResult));
+			rowsAffected.ToLong(&nRows);
+		}
+		m_pInterface->GetPQclear()(pResult);
+	}
+	else
+	{
+		SetErrorCode(DATABASE_LAYER_ERROR);
+		SetErrorMessage(ConvertFromUnicodeStream(m_pInterface->GetPQerrorMessage()(m_pDatabase)));
+	}
+	delete[]paramValues;
+	delete[]paramLengths;
+	delete[]paramFormats;
+
+	ClearBatchRows();
+
+	if (GetErrorCode() != DATABASE_LAYER_OK)
+	{
+		ThrowDatabaseException();
+		return DATABASE_LAYER_QUERY_RESULT_ERROR;
+	}
+
+	return (int)nRows;
+}
+
+void PostgresPreparedStatementWrapper::ClearBatchRows()
+{
+	m_aBatchRows.clear();
+	m_aBatchKeys.clear();
+}
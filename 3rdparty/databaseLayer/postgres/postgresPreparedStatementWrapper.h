@@ -21,6 +21,10 @@
 
 #include "engine/libpq-fe.h"
 
+#include <set>
+#include <string>
+#include <vector>
+
 class DatabaseResultSet;
 
 class PostgresPreparedStatementWrapper : public DatabaseErrorReporter, public DatabaseStringConverter
@@ -46,13 +50,37 @@ public:
 	int RunQuery();
 	DatabaseResultSet* RunQueryWithResults();
 
+	// batch support
+	/// True if the statement is an INSERT with a single VALUES row, which can be sent for several rows at once
+	bool CanBatch();
+	/// Keep the current parameters as a row of the batch, the buffered rows are sent first
+	///  when the batch is full or the row repeats the conflict key of a buffered row.
+	///  Returns the count of rows written or DATABASE_LAYER_QUERY_RESULT_ERROR
+	int AddBatchRow();
+	/// Send the buffered rows as one multi-row INSERT
+	int RunBatch();
+	void ClearBatchRows();
+
 private:
+	bool ParseBatchQuery();
+	std::string GetBatchKey(PostgresPreparedStatementParameterCollection& Parameters);
+
 	PostgresInterface* m_pInterface;
 	PGconn* m_pDatabase;
 	wxString m_strSQL;
 	wxString m_strStatementName;
 
 	PostgresPreparedStatementParameterCollection m_Parameters;
+
+	// multi-row form of the statement: m_strBatchPrefix, m_strBatchRow repeated for every row, m_strBatchSuffix
+	int m_nBatchMode; // -1 not parsed yet, 0 the statement runs row by row, 1 multi-row
+	wxString m_strBatchPrefix;
+	wxString m_strBatchRow;
+	wxString m_strBatchSuffix;
+	int m_nBatchRowParameters;
+	std::vector<int> m_aBatchKeyParameters; // positions of the ON CONFLICT columns in a row
+	std::vector<PostgresPreparedStatementParameterCollection> m_aBatchRows;
+	std::set<std::string> m_aBatchKeys;
 };
 
 #endif // __POSTGRESQL_PREPARED_STATEMENT_WRAPPER_H__
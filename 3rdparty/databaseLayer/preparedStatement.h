@@ -19,6 +19,7 @@
 #include "databaseStringConverter.h"
 #include "databaseResultSet.h"
 #include "databaseQueryParser.h"
+#include "databaseErrorCodes.h"
 
 WX_DECLARE_HASH_SET(DatabaseResultSet*, wxPointerHash, wxPointerEqual, StatementResultSetHashSet);
 
@@ -26,7 +27,7 @@ class CORE_API PreparedStatement : public DatabaseErrorReporter, public Database
 {
 public:
 	/// Constructor
-	PreparedStatement() {};
+	PreparedStatement() : m_nBatchRows(0), m_bBatchError(false) {};
 
 	/// Destructor
 	virtual ~PreparedStatement() {};
@@ -58,6 +59,14 @@ public:
 
 	virtual int GetParameterCount() = 0;
 
+	/// Set all parameters to NULL, the statement cache calls it before a statement is used again
+	virtual void ClearParameters()
+	{
+		int nParameters = GetParameterCount();
+		for (int nPosition = 1; nPosition <= nParameters; nPosition++)
+			SetParamNull(nPosition);
+	}
+
 	/// Run an insert, update, or delete query on the database
 	virtual int RunQuery() = 0;
 	/// Run an insert, update, or delete query on the database
@@ -73,6 +82,35 @@ public:
 	/// Close a result set returned by the database or a prepared statement previously
 	virtual bool CloseResultSet(DatabaseResultSet* pResultSet) { return false; };
 
+	// batch support
+	/// Run the statement with the current parameters as a part of the batch.
+	///  By default every call is executed at once, backends defer the commit or buffer the rows up to ExecuteBatch()
+	virtual void AddBatch()
+	{
+		if (m_bBatchError)
+			return;
+
+		int nRows = RunQuery();
+		if (GetErrorCode() != DATABASE_LAYER_OK)
+			m_bBatchError = true;
+		else if (nRows > 0)
+			m_nBatchRows += nRows;
+	}
+	/// Finish the batch, returns the count of affected rows or DATABASE_LAYER_QUERY_RESULT_ERROR
+	virtual int ExecuteBatch()
+	{
+		int nRows = m_bBatchError ? DATABASE_LAYER_QUERY_RESULT_ERROR : m_nBatchRows;
+		m_nBatchRows = 0; m_bBatchError = false;
+		return nRows;
+	}
+	/// Drop the batch without finishing it, the statement cache calls it when the statement is given back
+	virtual void ClearBatch() { m_nBatchRows = 0; m_bBatchError = false; }
+
+protected:
+
+	int m_nBatchRows;
+	bool m_bBatchError;
+
 protected:
 	/// Close all result set objects that have been generated but not yet closed
 	void CloseResultSets() {};
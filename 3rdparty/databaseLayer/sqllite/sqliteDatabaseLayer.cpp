@@ -4,6 +4,7 @@
 
 #include "sqliteResultSet.h"
 #include "sqlitePreparedStatement.h"
+#include "sqliteDialect.h"
 
 #include "databaseLayer/databaseErrorCodes.h"
 #include "databaseLayer/databaseLayerException.h"
@@ -13,7 +14,7 @@
 
 // ctor()
 SqliteDatabaseLayer::SqliteDatabaseLayer()
-	: DatabaseLayer()
+	: DatabaseLayer(), m_bWriteAheadLog(true), m_nMemoryMapSize(256 * 1024 * 1024), m_nCacheSize(64 * 1024), m_nBusyTimeout(5000)
 {
 	m_pDatabase = NULL; //&m_Database; //new sqlite3;
 	wxCSConv conv(_("UTF-8"));
@@ -21,7 +22,7 @@ SqliteDatabaseLayer::SqliteDatabaseLayer()
 }
 
 SqliteDatabaseLayer::SqliteDatabaseLayer(const wxString& strDatabase, bool mustExist /*= false*/)
-	: DatabaseLayer()
+	: DatabaseLayer(), m_bWriteAheadLog(true), m_nMemoryMapSize(256 * 1024 * 1024), m_nCacheSize(64 * 1024), m_nBusyTimeout(5000)
 {
 	m_pDatabase = NULL; //new sqlite3;
 	wxCSConv conv(_("UTF-8"));
@@ -29,6 +30,12 @@ SqliteDatabaseLayer::SqliteDatabaseLayer(const wxString& strDatabase, bool mustE
 	Open(strDatabase, mustExist);
 }
 
+SqliteDatabaseLayer::SqliteDatabaseLayer(void* pDatabase)
+	: DatabaseLayer(), m_bWriteAheadLog(true), m_nMemoryMapSize(256 * 1024 * 1024), m_nCacheSize(64 * 1024), m_nBusyTimeout(5000)
+{
+	m_pDatabase = pDatabase;
+}
+
 // dtor()
 SqliteDatabaseLayer::~SqliteDatabaseLayer()
 {
@@ -71,9 +78,29 @@ bool SqliteDatabaseLayer::Open(const wxString& strDatabase)
 		return false;
 	}
 
+	ApplyTuning();
+
 	return true;
 }
 
+void SqliteDatabaseLayer::ApplyTuning()
+{
+	sqlite3_busy_timeout((sqlite3*)m_pDatabase, m_nBusyTimeout);
+
+	// The journal mode is kept in the database file, the other settings belong to the connection
+	if (m_bWriteAheadLog)
+	{
+		RunQuery(_("PRAGMA journal_mode=WAL;"), false);
+		// A commit in WAL mode is durable after the next checkpoint, it can not corrupt the database
+		RunQuery(_("PRAGMA synchronous=NORMAL;"), false);
+	}
+
+	RunQuery(wxString::Format(_("PRAGMA mmap_size=%s;"), m_nMemoryMapSize.ToString()), false);
+	// A negative size is in kibibytes instead of pages
+	RunQuery(wxString::Format(_("PRAGMA cache_size=-%d;"), m_nCacheSize), false);
+	RunQuery(_("PRAGMA temp_store=MEMORY;"), false);
+}
+
 // close database  
 bool SqliteDatabaseLayer::Close()
 {
@@ -81,6 +108,7 @@ bool SqliteDatabaseLayer::Close()
 
 	CloseResultSets();
 	CloseStatements();
+	RefreshSchemaCatalog();
 
 	if (m_pDatabase != NULL)
 	{
@@ -119,6 +147,7 @@ void SqliteDatabaseLayer::RollBack()
 {
 	wxLogDebug(_("Rolling back transaction"));
 	RunQuery(_("rollback transaction;"), false);
+	SchemaRolledBack();
 }
 
 // query database
@@ -126,6 +155,11 @@ int SqliteDatabaseLayer::RunQuery(const wxString& strQuery, bool bParseQuery)
 {
 	ResetErrorCodes();
 
+	// Cached statements would have to be recompiled after the schema changes
+	if (IsSchemaQuery(strQuery))
+		ClearStatementCache();
+	UpdateSchemaCatalog(strQuery);
+
 	if (m_pDatabase == NULL)
 		return false;
 
@@ -283,7 +317,7 @@ PreparedStatement* SqliteDatabaseLayer::PrepareStatement(const wxString& strQuer
 	}
 }
 
-bool SqliteDatabaseLayer::TableExists(const wxString& table)
+bool SqliteDatabaseLayer::DoTableExists(const wxString& table)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -348,7 +382,7 @@ bool SqliteDatabaseLayer::TableExists(const wxString& table)
 	return bReturn;
 }
 
-bool SqliteDatabaseLayer::ViewExists(const wxString& view)
+bool SqliteDatabaseLayer::DoViewExists(const wxString& view)
 {
 	// Initialize variables
 	bool bReturn = false;
@@ -413,7 +447,7 @@ bool SqliteDatabaseLayer::ViewExists(const wxString& view)
 	return bReturn;
 }
 
-wxArrayString SqliteDatabaseLayer::GetTables()
+wxArrayString SqliteDatabaseLayer::DoGetTables()
 {
 	wxArrayString returnArray;
 
@@ -452,7 +486,7 @@ wxArrayString SqliteDatabaseLayer::GetTables()
 	return returnArray;
 }
 
-wxArrayString SqliteDatabaseLayer::GetViews()
+wxArrayString SqliteDatabaseLayer::DoGetViews()
 {
 	wxArrayString returnArray;
 
@@ -491,7 +525,7 @@ wxArrayString SqliteDatabaseLayer::GetViews()
 	return returnArray;
 }
 
-wxArrayString SqliteDatabaseLayer::GetColumns(const wxString& table)
+wxArrayString SqliteDatabaseLayer::DoGetColumns(const wxString& table)
 {
 	wxArrayString returnArray;
 
@@ -551,6 +585,68 @@ wxArrayString SqliteDatabaseLayer::GetColumns(const wxString& table)
 	return returnArray;
 }
 
+wxArrayString SqliteDatabaseLayer::DoGetIndexes(const wxString& table)
+{
+	// Initialize variables
+	wxArrayString returnArray;
+	// Keep these variables outside of scope so that we can clean them up
+	//  in case of an error
+	PreparedStatement* pStatement = NULL;
+	DatabaseResultSet* pResult = NULL;
+
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	try
+	{
+#endif
+		wxString query = _("SELECT name FROM sqlite_master WHERE type='index' AND tbl_name=?;");
+		pStatement = PrepareStatement(query);
+		if (pStatement)
+		{
+			pStatement->SetParamString(1, table);
+			pResult = pStatement->ExecuteQuery();
+			if (pResult)
+			{
+				while (pResult->Next())
+				{
+					returnArray.Add(pResult->GetResultString(1));
+				}
+			}
+		}
+#ifndef DONT_USE_DATABASE_LAYER_EXCEPTIONS
+	}
+	catch (DatabaseLayerException& e)
+	{
+		if (pResult != NULL)
+		{
+			CloseResultSet(pResult);
+			pResult = NULL;
+		}
+
+		if (pStatement != NULL)
+		{
+			CloseStatement(pStatement);
+			pStatement = NULL;
+		}
+
+		throw e;
+	}
+#endif
+
+	if (pResult != NULL)
+	{
+		CloseResultSet(pResult);
+		pResult = NULL;
+	}
+
+	if (pStatement != NULL)
+	{
+		CloseStatement(pStatement);
+		pStatement = NULL;
+	}
+
+	return returnArray;
+}
+
 int SqliteDatabaseLayer::TranslateErrorCode(int nCode)
 {
 	// Ultimately, this will probably be a map of SQLite database error code values to DatabaseLayer values
@@ -633,3 +729,8 @@ int SqliteDatabaseLayer::TranslateErrorCode(int nCode)
 	return nReturn;
 }
 
+
+DatabaseDialect* SqliteDatabaseLayer::CreateDialect()
+{
+	return new SqliteDialect();
+}
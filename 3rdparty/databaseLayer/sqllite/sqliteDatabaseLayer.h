@@ -25,7 +25,7 @@ public:
 	// ctor()
 	SqliteDatabaseLayer();
 	SqliteDatabaseLayer(const wxString& strDatabase, bool mustExist = false);
-	SqliteDatabaseLayer(void* pDatabase) { m_pDatabase = pDatabase; }
+	SqliteDatabaseLayer(void* pDatabase);
 
 	// dtor()
 	virtual ~SqliteDatabaseLayer();
@@ -53,19 +53,47 @@ public:
 	virtual PreparedStatement* PrepareStatement(const wxString& strQuery);
 	PreparedStatement* PrepareStatement(const wxString& strQuery, bool bLogForCleanup);
 
+	static int TranslateErrorCode(int nCode);
+
+	// Tuning, applied when the database is opened
+
+	/// Write-ahead log: readers do not block the writer and a commit appends to the log
+	///  instead of rewriting pages of the database file. Not possible for :memory:
+	void SetWriteAheadLog(bool bWriteAheadLog) { m_bWriteAheadLog = bWriteAheadLog; }
+	bool GetWriteAheadLog() const { return m_bWriteAheadLog; }
+	/// Size of the file mapped into memory for reading, 0 reads through the file API
+	void SetMemoryMapSize(wxLongLong nBytes) { m_nMemoryMapSize = nBytes; }
+	wxLongLong GetMemoryMapSize() const { return m_nMemoryMapSize; }
+	/// Size of the page cache of the connection
+	void SetCacheSize(int nKiloBytes) { m_nCacheSize = nKiloBytes; }
+	int GetCacheSize() const { return m_nCacheSize; }
+	/// How long a write waits for the lock of another connection before it fails with SQLITE_BUSY
+	void SetBusyTimeout(int nMilliseconds) { m_nBusyTimeout = nMilliseconds; }
+	int GetBusyTimeout() const { return m_nBusyTimeout; }
+
+protected:
+
 	// Database schema API contributed by M. Szeftel (author of wxActiveRecordGenerator)
-	virtual bool TableExists(const wxString& table);
-	virtual bool ViewExists(const wxString& view);
-	virtual wxArrayString GetTables();
-	virtual wxArrayString GetViews();
-	virtual wxArrayString GetColumns(const wxString& table);
+	virtual bool DoTableExists(const wxString& table);
+	virtual bool DoViewExists(const wxString& view);
+	virtual wxArrayString DoGetTables();
+	virtual wxArrayString DoGetViews();
+	virtual wxArrayString DoGetColumns(const wxString& table);
+	virtual wxArrayString DoGetIndexes(const wxString& table);
 
-	static int TranslateErrorCode(int nCode);
+	virtual DatabaseDialect* CreateDialect();
 
 private:
 
+	void ApplyTuning();
+
 	//sqlite3* m_pDatabase;
 	void* m_pDatabase;
+
+	bool m_bWriteAheadLog;
+	wxLongLong m_nMemoryMapSize;
+	int m_nCacheSize;
+	int m_nBusyTimeout;
 };
 
 #endif // __SQLITE_DATABASE_LAYER_H__
@@ -0,0 +1,20 @@
+#include "sqliteDialect.h"
+
+wxString SqliteDialect::GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+	const wxArrayString& keyColumns) const
+{
+	return GetInsertOnConflict(strTable, columns, values, keyColumns);
+}
+
+wxString SqliteDialect::GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset) const
+{
+	if (nOffset > 0)
+		return wxString::Format(wxT("SELECT %s LIMIT %lu OFFSET %lu"), strSelect, nLimit, nOffset);
+
+	return wxString::Format(wxT("SELECT %s LIMIT %lu"), strSelect, nLimit);
+}
+
+wxString SqliteDialect::GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const
+{
+	return wxString::Format(wxT("CREATE INDEX %s ON %s (%s);"), strIndex, strTable, strExpression);
+}
@@ -0,0 +1,22 @@
+#ifndef __SQLITE_DIALECT_H__
+#define __SQLITE_DIALECT_H__
+
+#include "databaseLayer/databaseDialect.h"
+
+class CORE_API SqliteDialect : public DatabaseDialect
+{
+public:
+	virtual int GetDialectType() const { return DATABASE_DIALECT_SQLITE; }
+
+	virtual wxString GetBinaryType(int nLength) const { return wxT("BLOB"); }
+
+	virtual wxString GetUpsert(const wxString& strTable, const wxArrayString& columns, const wxArrayString& values,
+		const wxArrayString& keyColumns) const;
+	virtual wxString GetSelectLimit(const wxString& strSelect, unsigned long nLimit, unsigned long nOffset = 0) const;
+
+	/// Column types can not be changed, the caller copies the values into a new column
+	virtual wxString GetAlterColumnType(const wxString& strTable, const wxString& strColumn, const wxString& strType) const { return wxEmptyString; }
+	virtual wxString GetCreateExpressionIndex(const wxString& strIndex, const wxString& strTable, const wxString& strExpression) const;
+};
+
+#endif // __SQLITE_DIALECT_H__
@@ -6,20 +6,20 @@
 
 // ctor
 SqlitePreparedStatement::SqlitePreparedStatement(sqlite3* pDatabase)
-	: PreparedStatement()
+	: PreparedStatement(), m_bBatchTransaction(false)
 {
 	m_pDatabase = pDatabase;
 }
 
 SqlitePreparedStatement::SqlitePreparedStatement(sqlite3* pDatabase, sqlite3_stmt* pStatement)
-	: PreparedStatement()
+	: PreparedStatement(), m_bBatchTransaction(false)
 {
 	m_pDatabase = pDatabase;
 	m_Statements.push_back(pStatement);
 }
 
 SqlitePreparedStatement::SqlitePreparedStatement(sqlite3* pDatabase, StatementVector statements)
-	: PreparedStatement(), m_Statements(statements)
+	: PreparedStatement(), m_Statements(statements), m_bBatchTransaction(false)
 {
 	m_pDatabase = pDatabase;
 }
@@ -34,6 +34,8 @@ void SqlitePreparedStatement::Close()
 {
 	CloseResultSets();
 
+	ClearBatch();
+
 	StatementVector::iterator start = m_Statements.begin();
 	StatementVector::iterator stop = m_Statements.end();
 	while (start != stop)
@@ -104,7 +106,13 @@ void SqlitePreparedStatement::SetParamNumber(int nPosition, const number_t &dblV
 	if (nIndex > -1)
 	{
 		sqlite3_reset(m_Statements[nIndex]);
-		int nReturn = sqlite3_bind_double(m_Statements[nIndex], nPosition, dblValue.ToDouble());
+		// Bound as text: a NUMERIC column keeps it as INTEGER or REAL only when the conversion is exact,
+		//  so the value reads back with all its digits
+		ttmath::Conv conv;
+		conv.scient_from = 128;
+		std::string strNumber;
+		dblValue.ToString(strNumber, conv);
+		int nReturn = sqlite3_bind_text(m_Statements[nIndex], nPosition, strNumber.c_str(), -1, SQLITE_TRANSIENT);
 		if (nReturn != SQLITE_OK)
 		{
 			SetErrorCode(SqliteDatabaseLayer::TranslateErrorCode(nReturn));
@@ -265,6 +273,55 @@ int SqlitePreparedStatement::RunQuery()
 	return sqlite3_changes(m_pDatabase);
 }
 
+void SqlitePreparedStatement::AddBatch()
+{
+	if (m_bBatchError)
+		return;
+
+	// Outside of a transaction every row would be committed (and synced) separately
+	if (!m_bBatchTransaction && sqlite3_get_autocommit(m_pDatabase))
+	{
+		if (sqlite3_exec(m_pDatabase, "BEGIN TRANSACTION;", 0, 0, NULL) == SQLITE_OK)
+			m_bBatchTransaction = true;
+	}
+
+	PreparedStatement::AddBatch();
+}
+
+int SqlitePreparedStatement::ExecuteBatch()
+{
+	if (m_bBatchTransaction)
+	{
+		m_bBatchTransaction = false;
+
+		if (m_bBatchError)
+		{
+			sqlite3_exec(m_pDatabase, "ROLLBACK TRANSACTION;", 0, 0, NULL);
+		}
+		else if (sqlite3_exec(m_pDatabase, "COMMIT TRANSACTION;", 0, 0, NULL) != SQLITE_OK)
+		{
+			m_bBatchError = true;
+			SetErrorCode(SqliteDatabaseLayer::TranslateErrorCode(sqlite3_errcode(m_pDatabase)));
+			SetErrorMessage(ConvertFromUnicodeStream(sqlite3_errmsg(m_pDatabase)));
+			sqlite3_exec(m_pDatabase, "ROLLBACK TRANSACTION;", 0, 0, NULL);
+		}
+	}
+
+	return PreparedStatement::ExecuteBatch();
+}
+
+void SqlitePreparedStatement::ClearBatch()
+{
+	// A batch that was not executed is not written, the transaction must not stay open on the connection
+	if (m_bBatchTransaction)
+	{
+		sqlite3_exec(m_pDatabase, "ROLLBACK TRANSACTION;", 0, 0, NULL);
+		m_bBatchTransaction = false;
+	}
+
+	PreparedStatement::ClearBatch();
+}
+
 DatabaseResultSet* SqlitePreparedStatement::RunQueryWithResults()
 {
 	ResetErrorCodes();
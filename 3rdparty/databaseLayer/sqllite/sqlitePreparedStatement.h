@@ -50,6 +50,11 @@ public:
   virtual int RunQuery();
   virtual DatabaseResultSet* RunQueryWithResults();
 
+  // batch support - rows of a batch are written in one transaction
+  virtual void AddBatch();
+  virtual int ExecuteBatch();
+  virtual void ClearBatch();
+
   sqlite3_stmt* GetLastStatement() { return (m_Statements.size() > 0) ? m_Statements[m_Statements.size()-1] : NULL; }
 
 private:
@@ -57,6 +62,8 @@ private:
  
   sqlite3* m_pDatabase; // Database pointer needed for error messages
   StatementVector m_Statements;
+
+  bool m_bBatchTransaction;
 };
 
 #endif // __SQLITE_PREPARED_STATEMENT_H__
@@ -157,10 +157,13 @@ double SqliteResultSet::GetResultDouble(int nField)
 
 number_t SqliteResultSet::GetResultNumber(int nField)
 {
-	number_t dblValue = -1;
+	number_t dblValue = 0;
 	if (m_pSqliteStatement == NULL)
 		m_pSqliteStatement = m_pStatement->GetLastStatement();
-	dblValue = sqlite3_column_double(m_pSqliteStatement, nField - 1);
+	// The text of an INTEGER is exact and a REAL is printed with the 15 digits it was stored from
+	const char* pNumber = (const char*)sqlite3_column_text(m_pSqliteStatement, nField - 1);
+	if (pNumber != NULL)
+		dblValue.FromString(pNumber);
 
 	return dblValue;
 }
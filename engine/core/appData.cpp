@@ -8,11 +8,18 @@
 //sandbox
 #include "metadata/moduleManager/moduleManager.h"
 #include "metadata/metadata.h"
+#include "metadata/objects/objectCache.h"
 
 //databases
 #include "databaseLayer/odbc/odbcDatabaseLayer.h"
 #include "databaseLayer/postgres/postgresDatabaseLayer.h"
 #include "databaseLayer/firebird/firebirdDatabaseLayer.h"
+#include "databaseLayer/sqllite/sqliteDatabaseLayer.h"
+#include "databaseLayer/databaseConnectionPool.h"
+
+#include <wx/app.h>
+#include <wx/filename.h>
+#include <wx/sysopt.h>
 
 //mainFrame
 #include "frontend/mainFrame.h"
@@ -37,6 +44,8 @@ void ApplicationData::Destroy()
 
 	if (s_instance) {
 		s_instance->Disconnect();
+		//drop cached objects of the session
+		CObjectCache::Destroy();
 		//Close connection and delete ptr 
 		wxDELETE(s_instance);
 	}
@@ -46,10 +55,19 @@ void ApplicationData::Destroy()
 
 void ApplicationData::OnIdleHandler(wxTimerEvent &event)
 {
+	//group commit writes do not keep their locks longer than the delay
+	databaseLayer->FlushExpiredGroupCommit();
 	RefreshActiveUsers();
 	event.Skip();
 }
 
+void ApplicationData::OnIdleCommit(wxIdleEvent &event)
+{
+	//writes kept by group commit are committed once the script or the form event is done
+	databaseLayer->FlushGroupCommit();
+	event.Skip();
+}
+
 bool ApplicationData::Initialize(eRunMode modeRun, const wxString &user, const wxString &password)
 {
 	return appData->Connect(modeRun, user, password);
@@ -59,9 +77,14 @@ void ApplicationData::RefreshActiveUsers()
 {
 	wxDateTime currentTime = wxDateTime::Now();
 
+	//the session is kept alive on its own connection, so it does not wait for the open writes of the main one
+	DatabaseConnectionLocker connection(m_connectionPool);
+	if (!connection.IsOk())
+		return;
+
 	// fisrt update current session
 	PreparedStatement *preparedStatement =
-		databaseLayer->PrepareStatement("UPDATE %s SET lastActive = ? WHERE session = ?", IConfigMetadata::GetActiveUsersTableName());
+		connection->PrepareStatement("UPDATE %s SET lastActive = ? WHERE session = ?", IConfigMetadata::GetActiveUsersTableName());
 
 	preparedStatement->SetParamDate(1, currentTime);
 	preparedStatement->SetParamString(2, m_sessionGuid.str());
@@ -71,7 +94,7 @@ void ApplicationData::RefreshActiveUsers()
 
 	if (m_sesssionLocker.TryEnter()) {
 		PreparedStatement *preparedStatement =
-			databaseLayer->PrepareStatement("DELETE FROM %s WHERE lastActive < ?", IConfigMetadata::GetActiveUsersTableName());
+			connection->PrepareStatement("DELETE FROM %s WHERE lastActive < ?", IConfigMetadata::GetActiveUsersTableName());
 		preparedStatement->SetParamDate(1, currentTime.Subtract(wxTimeSpan(0, 0, timeInterval)));
 		preparedStatement->RunQuery();
 		preparedStatement->Close();
@@ -79,11 +102,46 @@ void ApplicationData::RefreshActiveUsers()
 	}
 }
 
+//embedded sqlite is used when it is asked for on the command line or the project already keeps its data in it
+static bool IsSqliteStorage(const wxString &projectDir)
+{
+	if (wxSystemOptions::GetOption(wxT("storage")).IsSameAs(wxT("sqlite"), false))
+		return true;
+
+	return wxFileName::FileExists(projectDir + wxT("\\") + wxT("sys.sqlite"));
+}
+
+static DatabaseLayer *CreateDatabaseLayer(bool sqliteStorage)
+{
+	if (sqliteStorage)
+		return new SqliteDatabaseLayer();
+
+	return new FirebirdDatabaseLayer();
+}
+
 ApplicationData::ApplicationData(const wxString &projectDir) :
-	m_projectDir(projectDir), m_objDb(new FirebirdDatabaseLayer()), m_runMode(eRunMode::START_MODE), m_sessionTimer(NULL)
+	m_projectDir(projectDir), m_objDb(NULL), m_connectionPool(NULL), m_runMode(eRunMode::START_MODE), m_sessionTimer(NULL)
 {
+	bool sqliteStorage = IsSqliteStorage(projectDir);
+
+	wxString databasePath = projectDir + wxT("\\") +
+		(sqliteStorage ? wxT("sys.sqlite") : wxT("sys.database"));
+
+	m_objDb = CreateDatabaseLayer(sqliteStorage);
+
+	//connections of the pool open the same database
+	m_connectionPool = new DatabaseConnectionPool([databasePath, sqliteStorage]() -> DatabaseLayer * {
+		DatabaseLayer *connection = CreateDatabaseLayer(sqliteStorage);
+		if (!connection->Open(databasePath)) {
+			wxDELETE(connection);
+		}
+		return connection;
+	});
+
+	m_connectionPool->SetHealthQuery(m_objDb->GetDialect()->GetSelectWithoutTable(wxT("1")));
+
 	//start new connection 
-	if (m_objDb->Open(projectDir + wxT("\\") + wxT("sys.database"))) {
+	if (m_objDb->Open(databasePath)) {
 
 		//create new session 
 		m_sessionGuid = Guid::newGuid();
@@ -97,10 +155,16 @@ ApplicationData::~ApplicationData()
 {
 	//close session disp 
 	wxDELETE(m_sessionTimer);
-	//Close connection 
+	//Close connections 
+	wxDELETE(m_connectionPool);
 	wxDELETE(m_objDb);
 }
 
+DatabaseLayer *ApplicationData::GetObjectDatabase() const
+{
+	return m_objDb;
+}
+
 bool ApplicationData::Connect(eRunMode runMode, const wxString &user, const wxString &password)
 {
 	m_runMode = runMode;
@@ -121,6 +185,10 @@ bool ApplicationData::Connect(eRunMode runMode, const wxString &user, const wxSt
 		return false;
 	}
 
+	if (wxTheApp != NULL) {
+		wxTheApp->Bind(wxEVT_IDLE, &ApplicationData::OnIdleCommit, this);
+	}
+
 	mainFrameCreate(runMode);
 
 	if (!metadata->LoadMetadata()) {
@@ -150,10 +218,21 @@ bool ApplicationData::Disconnect()
 		}
 	}
 
+	if (wxTheApp != NULL) {
+		wxTheApp->Unbind(wxEVT_IDLE, &ApplicationData::OnIdleCommit, this);
+	}
+
+	//commit writes kept by group commit
+	databaseLayer->FlushGroupCommit();
+
 	if (!CloseSession()) {
 		return false;
 	}
 
+	if (m_connectionPool != NULL) {
+		m_connectionPool->CloseIdleConnections();
+	}
+
 	return true;
 }
 
@@ -257,6 +336,12 @@ bool ApplicationData::ShowAuthorizationWnd()
 
 bool ApplicationData::StartSession(const wxString &userName, const wxString &userPassword)
 {
+	//the session row lives on a pooled connection, apart from the writes of the main one
+	DatabaseConnectionLocker connection(m_connectionPool);
+	if (!connection.IsOk()) {
+		return false;
+	}
+
 	if (!CloseSession()) {
 		return false;
 	}
@@ -266,7 +351,7 @@ bool ApplicationData::StartSession(const wxString &userName, const wxString &use
 	RefreshActiveUsers();
 
 	if (m_runMode == eRunMode::DESIGNER_MODE) {
-		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT * FROM %s WHERE application = %i", IConfigMetadata::GetActiveUsersTableName(), m_runMode);
+		DatabaseResultSet *resultSet = connection->RunQueryWithResults("SELECT * FROM %s WHERE application = %i", IConfigMetadata::GetActiveUsersTableName(), m_runMode);
 		if (resultSet == NULL) {
 			return false;
 		}
@@ -285,7 +370,7 @@ bool ApplicationData::StartSession(const wxString &userName, const wxString &use
 
 	//start empty session 
 	PreparedStatement *preparedStatement =
-		databaseLayer->PrepareStatement("INSERT INTO %s (session, userName, application, started, lastActive, computer) VALUES (?,?,?,?,?,?);", IConfigMetadata::GetActiveUsersTableName());
+		connection->PrepareStatement("INSERT INTO %s (session, userName, application, started, lastActive, computer) VALUES (?,?,?,?,?,?);", IConfigMetadata::GetActiveUsersTableName());
 
 	if (preparedStatement == NULL) {
 		return false;
@@ -321,9 +406,15 @@ bool ApplicationData::StartSession(const wxString &userName, const wxString &use
 
 	if (successful) {
 
+		wxArrayString aColumns, aValues, aKeyColumns;
+		aColumns.Add(wxT("session")); aColumns.Add(wxT("userName")); aColumns.Add(wxT("application"));
+		aColumns.Add(wxT("started")); aColumns.Add(wxT("lastActive")); aColumns.Add(wxT("computer"));
+		aValues.Add(wxT("?"), aColumns.size());
+		aKeyColumns.Add(wxT("session"));
+
 		//update empty session 
 		PreparedStatement *preparedStatement =
-			databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (session, userName, application, started, lastActive, computer) VALUES (?,?,?,?,?,?) MATCHING(session);", IConfigMetadata::GetActiveUsersTableName());
+			connection->PrepareStatement(connection->GetDialect()->GetUpsert(IConfigMetadata::GetActiveUsersTableName(), aColumns, aValues, aKeyColumns));
 		if (preparedStatement == NULL) {
 			return false;
 		}
@@ -345,8 +436,13 @@ bool ApplicationData::StartSession(const wxString &userName, const wxString &use
 
 bool ApplicationData::CloseSession()
 {
+	DatabaseConnectionLocker connection(m_connectionPool);
+	if (!connection.IsOk()) {
+		return false;
+	}
+
 	int result =
-		databaseLayer->RunQuery("DELETE FROM %s WHERE session = '%s'", IConfigMetadata::GetActiveUsersTableName(), m_sessionGuid.str());
+		connection->RunQuery("DELETE FROM %s WHERE session = '%s'", IConfigMetadata::GetActiveUsersTableName(), m_sessionGuid.str());
 	return result != DATABASE_LAYER_QUERY_RESULT_ERROR;
 }
 
@@ -23,6 +23,7 @@ class CMetadataTree;
 struct CByteCode;
 
 class DatabaseLayer;
+class DatabaseConnectionPool;
 
 #define appData         	(ApplicationData::Get())
 #define appDataCreate(path) (ApplicationData::Get(path))
@@ -58,6 +59,7 @@ class CORE_API ApplicationData {
 	wxDateTime m_lastActivity;
 
 	DatabaseLayer* m_objDb;  // Base de datos de objetos
+	DatabaseConnectionPool *m_connectionPool; // connections for the session rows, apart from the writes of the main one
 	wxTimer *m_sessionTimer;
 
 	wxCriticalSection m_sesssionLocker;
@@ -87,7 +89,9 @@ public:
 
 	bool SaveConfiguration();
 
-	DatabaseLayer *GetObjectDatabase() const { return m_objDb; }
+	//main connection, used for object reads and writes; only the session bookkeeping goes through the pool
+	DatabaseLayer *GetObjectDatabase() const;
+	DatabaseConnectionPool *GetConnectionPool() const { return m_connectionPool; }
 
 	eRunMode GetAppMode() const {
 		return m_runMode;
@@ -158,6 +162,7 @@ public:
 
 protected:
 	void OnIdleHandler(wxTimerEvent& event);
+	void OnIdleCommit(wxIdleEvent& event);
 };
 
 
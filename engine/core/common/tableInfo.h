@@ -280,6 +280,9 @@ public:
 
 	virtual wxDataViewItem GetLineByGuid(const Guid &guid) const { return wxDataViewItem(0); }
 
+	//read the presentations of all references in the rows at once before showing them
+	virtual void PrepareReferences() {}
+
 	virtual IValueTableReturnLine *GetRowAt(unsigned int line) = 0;
 	virtual IValueTableColumns *GetColumns() const = 0;
 
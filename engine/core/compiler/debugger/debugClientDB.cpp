@@ -47,10 +47,19 @@ void CDebuggerClient::LoadBreakpoints()
 	}
 }
 
+//the row of a breakpoint, nothing changes when it is already there
+static wxString GetBreakpointUpsert(const wxString &tableName, const wxString &sModuleName, unsigned int line)
+{
+	wxArrayString aColumns, aValues;
+	aColumns.Add(wxT("moduleName")); aValues.Add(wxT("'") + sModuleName + wxT("'"));
+	aColumns.Add(wxT("moduleLine")); aValues.Add(StringUtils::IntToStr(line));
+	return databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aColumns);
+}
+
 bool CDebuggerClient::ToggleBreakpointInDB(const wxString &sModuleName, unsigned int line)
 {
 	bool successful = true;
-	PreparedStatement *preparedStatement = databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s(moduleName, moduleLine) VALUES('" + sModuleName + "', " + StringUtils::IntToStr(line) + ") MATCHING (moduleName, moduleLine); ", GetDebugPointTableName());
+	PreparedStatement *preparedStatement = databaseLayer->PrepareStatement(GetBreakpointUpsert(GetDebugPointTableName(), sModuleName, line));
 	wxASSERT(preparedStatement);
 	if (preparedStatement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 		wxASSERT_MSG(false, "error in ToggleBreakpointInDB"); successful = false;
@@ -77,8 +86,8 @@ bool CDebuggerClient::RemoveBreakpointInDB(const wxString &sModuleName, unsigned
 bool CDebuggerClient::OffsetBreakpointInDB(const wxString &sModuleName, unsigned int lineFrom, int offset)
 {
 	bool successful = true;
-	PreparedStatement *preparedStatement = databaseLayer->PrepareStatement("DELETE FROM %s WHERE moduleName = '" + sModuleName + "' AND moduleLine = " + StringUtils::IntToStr(lineFrom) + ";"
-		"UPDATE OR INSERT INTO %s (moduleName, moduleLine) VALUES('" + sModuleName + "', " + StringUtils::IntToStr(lineFrom + offset) + ") MATCHING (moduleName, moduleLine); ", GetDebugPointTableName(), GetDebugPointTableName());
+	PreparedStatement *preparedStatement = databaseLayer->PrepareStatement("DELETE FROM " + GetDebugPointTableName() + " WHERE moduleName = '" + sModuleName + "' AND moduleLine = " + StringUtils::IntToStr(lineFrom) + ";"
+		+ GetBreakpointUpsert(GetDebugPointTableName(), sModuleName, lineFrom + offset));
 	wxASSERT(preparedStatement);
 	if (preparedStatement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 		wxASSERT_MSG(false, "error in OffsetBreakpointInDB"); successful = false;
@@ -80,6 +80,12 @@ public:
 
 	int FindAttribute(const wxString &attributeName) const;
 
+	//check attribute name by position (used by inline cache in procUnit)
+	bool CompareAttribute(unsigned int attributeID, const wxString &attributeName) const {
+		return attributeID < m_aAttributes.size() 
+			&& m_aAttributes[attributeID].sName.CmpNoCase(attributeName) == 0;
+	}
+
 	wxString GetAttributeName(unsigned int attributeID) const;
 	wxString GetAttributeSynonym(unsigned int attributeID) const;
 
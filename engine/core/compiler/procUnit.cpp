@@ -6,6 +6,7 @@
 #include "procUnit.h"
 #include "debugger/debugServer.h"
 #include "systemObjects.h"
+#include "methods.h"
 #include "utils/stringUtils.h"
 
 #define CurCode	m_pByteCode->m_aCodeList[nCodeLine]
@@ -456,6 +457,32 @@ inline void SetTypeNumber(CValue &cValue1, const number_t &fValue)
 		CTranslateError::Error(_("Aggregate object field not found '%s'"), sName.wc_str());\
 }
 
+//attribute inline cache: param4 keeps the attribute table and the position found last time
+//objects sharing one table (rows of the same table, values of the same class) skip the name lookup
+//only positions that FindAttribute of the object itself returned and that name the same attribute of the table are kept,
+//so classes that resolve attributes on their own (frames, forms, modules) are not served from the table
+inline int FindAttributeCached(CByte &code, const CValue &cValue, const wxString &sName)
+{
+	CValue *pValue = cValue.GetRef();
+	CMethods *pMethods = pValue && pValue->m_typeClass != eValueTypes::TYPE_OLE ? pValue->GetPMethods() : NULL;
+
+	if (pMethods) {
+		CMethods *pStorageMethods = reinterpret_cast<CMethods *>(code.m_param4.m_nArray);
+		if (pStorageMethods == pMethods && pMethods->CompareAttribute(code.m_param4.m_nIndex, sName)) {
+			return code.m_param4.m_nIndex;
+		}
+	}
+
+	int nAttr = cValue.FindAttribute(sName);
+
+	if (pMethods && nAttr != wxNOT_FOUND && pMethods->CompareAttribute(nAttr, sName)) {
+		code.m_param4.m_nArray = reinterpret_cast<wxLongLong_t>(pMethods);
+		code.m_param4.m_nIndex = nAttr;
+	}
+
+	return nAttr;
+}
+
 // 
 inline void SetArrayValue(CValue &cValue1, const CValue &cValue2, CValue &cValue3)
 {
@@ -684,8 +711,8 @@ start_label:
 			} break;
 			case OPER_SET_A: {// 
 
-				wxString sAttributeName = m_pByteCode->m_aConstList[Index2].m_sData;
-				int nAttr = Variable1.FindAttribute(sAttributeName);
+				const wxString &sAttributeName = m_pByteCode->m_aConstList[Index2].m_sData;
+				int nAttr = FindAttributeCached(CurCode, Variable1, sAttributeName);
 				if (nAttr < 0) CheckAndError(Variable1, sAttributeName);
 				attributeArg_t aParams(nAttr, sAttributeName);
 				Variable1.SetAttribute(aParams, GetValue(Variable3));
@@ -694,8 +721,8 @@ start_label:
 			{
 				CValue *pRetValue = &Variable1;
 				CValue *pVariable2 = &Variable2;
-				wxString sAttributeName = m_pByteCode->m_aConstList[Index3].m_sData;
-				int nAttr = Variable2.FindAttribute(sAttributeName);
+				const wxString &sAttributeName = m_pByteCode->m_aConstList[Index3].m_sData;
+				int nAttr = FindAttributeCached(CurCode, Variable2, sAttributeName);
 				if (nAttr < 0) CheckAndError(Variable2, sAttributeName);
 				attributeArg_t aParams(nAttr, sAttributeName);
 				CValue vRet = Variable2.GetAttribute(aParams);
@@ -30,6 +30,12 @@ enum eRoundMode
 	eRoundMode_Round15as20
 };
 
+enum eSortDirection
+{
+	eSortDirection_Ascending = 1,
+	eSortDirection_Descending
+};
+
 enum enChars {
 	eCR = 13,
 	eFF = 12,
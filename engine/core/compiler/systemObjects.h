@@ -115,6 +115,7 @@ public:
 	static void BeginTransaction();
 	static void CommitTransaction();
 	static void RollBackTransaction();
+	static void SetGroupCommit(unsigned int count);
 
 public:
 
@@ -137,6 +137,38 @@ protected:
 	}
 };
 
+class CValueSortDirection : public IEnumeration<eSortDirection>
+{
+	wxDECLARE_DYNAMIC_CLASS(CValueSortDirection);
+
+public:
+
+	CValueSortDirection() : IEnumeration() { InitializeEnumeration(); }
+	CValueSortDirection(eSortDirection direction) : IEnumeration(direction) { InitializeEnumeration(direction); }
+
+	wxString GetTypeString() const override { return wxT("sortDirection"); }
+
+protected:
+
+	void CreateEnumeration()
+	{
+		AddEnumeration(eSortDirection::eSortDirection_Ascending, wxT("ascending"));
+		AddEnumeration(eSortDirection::eSortDirection_Descending, wxT("descending"));
+	}
+
+	virtual void InitializeEnumeration() override
+	{
+		CreateEnumeration();
+		IEnumeration::InitializeEnumeration();
+	}
+
+	virtual void InitializeEnumeration(eSortDirection value) override
+	{
+		CreateEnumeration();
+		IEnumeration::InitializeEnumeration(value);
+	}
+};
+
 class CValueChars : public IEnumeration<enChars>
 {
 	wxDECLARE_DYNAMIC_CLASS(CValueChars);
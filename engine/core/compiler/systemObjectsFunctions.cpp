@@ -4,11 +4,13 @@
 #include "frontend/visualView/controls/form.h"
 #include "metadata/metaObjects/metaFormObject.h"
 #include "metadata/metadata.h"
+#include "metadata/objects/objectCache.h"
 #include "utils/stringUtils.h"
 #include "frontend/mainFrame.h"
 #include "translateModule.h"
 #include "procUnit.h"
 #include "appData.h"
+#include "utils/dateUtils.h"
 
 #include "systemObjectsEnums.h"
 
@@ -192,60 +194,85 @@ wxString CSystemObjects::StrReplace(const CValue &cSource, const CValue &cValue1
 	return csSource;
 }
 
-int CSystemObjects::StrCountOccur(const CValue &cSource, const CValue &cValue1)
-{
-	wxString csSource = cSource.GetString();
-	return csSource.find(cValue1.GetString());
-}
+//line index of the last scanned string - repeated StrGetLine calls on the same text do not rescan it
+//the text is known by its length and hash, so no copy of it is kept; each thread has its own index
+struct lineIndex_t {
+	size_t m_nLength = 0;
+	wxULongLong_t m_nHash = 0;
+	std::vector<size_t> m_aLineStart;
+};
 
-int CSystemObjects::StrLineCount(const CValue &cSource)
+static thread_local lineIndex_t s_lineIndex;
+
+static wxULongLong_t GetLineSourceHash(const wxString &csSource)
 {
-	wxString csSource = cSource.GetString();
-	return csSource.find('\n') + 1;
+	//64-bit FNV-1a
+	wxULongLong_t nHash = wxULL(14695981039346656037);
+	const wchar_t *pSource = csSource.wc_str();
+	for (size_t nIndex = 0; nIndex < csSource.length(); nIndex++) {
+		nHash = (nHash ^ static_cast<wxULongLong_t>(pSource[nIndex])) * wxULL(1099511628211);
+	}
+	return nHash;
 }
 
-wxString CSystemObjects::StrGetLine(const CValue &cValue, unsigned int nLine)
+static const std::vector<size_t> &GetLineIndex(const wxString &csSource)
 {
-	wxString csSource = cValue.GetString() + wxT("\r\n");
+	wxULongLong_t nHash = GetLineSourceHash(csSource);
 
-	unsigned int nLast = 0;
-	unsigned int nStartLine = 1;
+	if (!s_lineIndex.m_aLineStart.empty()
+		&& s_lineIndex.m_nLength == csSource.length()
+		&& s_lineIndex.m_nHash == nHash) {
+		return s_lineIndex.m_aLineStart;
+	}
 
-	//********блок для ускорения
-	static wxString _csStaticSource;
+	s_lineIndex.m_nLength = csSource.length();
+	s_lineIndex.m_nHash = nHash;
+	s_lineIndex.m_aLineStart.clear();
+	s_lineIndex.m_aLineStart.push_back(0);
 
-	static unsigned int _nStaticLast = 0;
-	static unsigned int _nStaticLine = 0;
+	for (size_t nIndex = csSource.find(wxT('\n')); nIndex != wxString::npos; nIndex = csSource.find(wxT('\n'), nIndex + 1)) {
+		s_lineIndex.m_aLineStart.push_back(nIndex + 1);
+	}
 
-	if (_csStaticSource == csSource)
-	{
-		if (_nStaticLine <= nLine)
-		{
-			nLast = _nStaticLast;//т.е. начинаем поиск не с начала
-			nStartLine = _nStaticLine;
-		}
+	return s_lineIndex.m_aLineStart;
+}
+
+int CSystemObjects::StrCountOccur(const CValue &cSource, const CValue &cValue1)
+{
+	const wxString &csSource = cSource.GetString();
+	const wxString &csValue = cValue1.GetString();
+
+	if (csValue.IsEmpty())
+		return 0;
+
+	int nCount = 0;
+	for (size_t nIndex = csSource.find(csValue); nIndex != wxString::npos; nIndex = csSource.find(csValue, nIndex + csValue.length())) {
+		nCount++;
 	}
 
-	//перебираем строчки втупую
-	for (unsigned int i = nStartLine;; i++)
-	{
-		unsigned int nIndex = csSource.find(wxT("\r\n"), nLast);
+	return nCount;
+}
 
-		if (nIndex < 0) return wxEmptyString;
+int CSystemObjects::StrLineCount(const CValue &cSource)
+{
+	return GetLineIndex(cSource.GetString()).size();
+}
 
-		if (i == nLine)
-		{
-			_csStaticSource = csSource;
-			_nStaticLast = nIndex + 2;
-			_nStaticLine = nLine + 1;
+wxString CSystemObjects::StrGetLine(const CValue &cValue, unsigned int nLine)
+{
+	const wxString &csSource = cValue.GetString();
+	const std::vector<size_t> &aLineStart = GetLineIndex(csSource);
 
-			return csSource.Mid(nLast, nIndex - nLast);
-		}
+	if (nLine < 1 || nLine > aLineStart.size())
+		return wxEmptyString;
 
-		nLast = nIndex + 2;
-	}
+	size_t nStart = aLineStart[nLine - 1];
+	size_t nEnd = nLine < aLineStart.size() ? aLineStart[nLine] - 1 : csSource.length();
+
+	if (nEnd > nStart && csSource[nEnd - 1] == wxT('\r'))
+		nEnd--;
 
-	return wxEmptyString;
+	return csSource.Mid(nStart, nEnd - nStart);
 }
 
 wxString CSystemObjects::Upper(const CValue &cSource)
@@ -303,7 +330,8 @@ CValue CSystemObjects::AddMonth(const CValue &cData, int nMonthAdd)
 	nYear = SummaMonth / 12;
 	nMonth = SummaMonth % 12 + 1;
 
-	return CValue(nYear, nMonth, nDay);
+	int nDaysInMonth = DateUtils::DaysInMonth(nYear, nMonth);
+	return CValue(nYear, nMonth, nDay > nDaysInMonth ? nDaysInMonth : nDay);
 }
 
 CValue CSystemObjects::BegOfMonth(const CValue &cData)
@@ -318,8 +346,7 @@ CValue CSystemObjects::EndOfMonth(const CValue &cData)
 	int nYear, nMonth, nDay;
 	cData.FromDate(nYear, nMonth, nDay);
 
-	CValue m_date = CValue(nYear, nMonth, 1, 23, 59, 59);
-	return AddMonth(m_date, 1) - 1;
+	return CValue(nYear, nMonth, DateUtils::DaysInMonth(nYear, nMonth), 23, 59, 59);
 }
 
 CValue CSystemObjects::BegOfQuart(const CValue &cData)
@@ -350,31 +377,32 @@ CValue CSystemObjects::EndOfYear(const CValue &cData)
 
 CValue CSystemObjects::BegOfWeek(const CValue &cData)
 {
-	int nYear, nMonth, nDay, DayOfWeek, DayOfYear, WeekOfYear;
-	cData.FromDate(nYear, nMonth, nDay, DayOfWeek, DayOfYear, WeekOfYear);
-	CValue Date1 = CValue(nYear, nMonth, nDay) - (DayOfWeek + 1);
-	return Date1;
+	wxLongLong_t nDays, nTime;
+	DateUtils::SplitDays(cData.GetDate(), nDays, nTime);
+	nDays -= DateUtils::WeekDayFromDays(nDays) - 1;
+	return CValue(DateUtils::FromLocal(nDays * DateUtils::msPerDay));
 }
 
 CValue CSystemObjects::EndOfWeek(const CValue &cData)
 {
-	int nYear, nMonth, nDay, DayOfWeek, DayOfYear, WeekOfYear;
-	cData.FromDate(nYear, nMonth, nDay, DayOfWeek, DayOfYear, WeekOfYear);
-	return CValue(nYear, nMonth, nDay) + (7 - DayOfWeek);
+	wxLongLong_t nDays, nTime;
+	DateUtils::SplitDays(cData.GetDate(), nDays, nTime);
+	nDays += 7 - DateUtils::WeekDayFromDays(nDays);
+	return CValue(DateUtils::FromLocal((nDays + 1) * DateUtils::msPerDay - DateUtils::msPerSecond));
 }
 
 CValue CSystemObjects::BegOfDay(const CValue &cData)
 {
-	int nYear, nMonth, nDay;
-	cData.FromDate(nYear, nMonth, nDay);
-	return CValue(nYear, nMonth, nDay, 0, 0, 0);
+	wxLongLong_t nDays, nTime;
+	DateUtils::SplitDays(cData.GetDate(), nDays, nTime);
+	return CValue(DateUtils::FromLocal(nDays * DateUtils::msPerDay));
 }
 
 CValue CSystemObjects::EndOfDay(const CValue &cData)
 {
-	int nYear, nMonth, nDay;
-	cData.FromDate(nYear, nMonth, nDay);
-	return CValue(nYear, nMonth, nDay, 23, 59, 59);
+	wxLongLong_t nDays, nTime;
+	DateUtils::SplitDays(cData.GetDate(), nDays, nTime);
+	return CValue(DateUtils::FromLocal((nDays + 1) * DateUtils::msPerDay - DateUtils::msPerSecond));
 }
 
 int CSystemObjects::GetYear(const CValue &cData)
@@ -597,10 +625,42 @@ void CSystemObjects::Execute(const wxString &sExpression)
 #define DF wxT("DF")
 #define DE wxT("DE")
 
-wxString CSystemObjects::Format(CValue &cData, const wxString &fmt)
+//compiled format string - parsed once and kept by format string, since reports call Format per cell
+struct formatData_t {
+
+	enum dateToken {
+		dateLiteral,
+		dateYear,
+		dateShortYear,
+		dateMonth,
+		dateDay,
+		dateHour,
+		dateMinute,
+		dateSecond
+	};
+
+	struct dateFormat_t {
+		dateToken m_token;
+		wxString m_literal;
+	};
+
+	bool m_hasBT = false, m_hasBF = false;
+	wxString m_strBT, m_strBF;
+
+	ttmath::Conv m_conv;
+	bool m_hasNZ = false;
+	wxString m_strNZ;
+
+	bool m_hasDE = false;
+	wxString m_strDE;
+
+	bool m_hasDF = false;
+	std::vector<dateFormat_t> m_aDateFormat;
+};
+
+static void ParseFormat(const wxString &fmt, std::map<wxString, wxString> &aParams)
 {
 	wxString leftParam, rightParam;
-	std::map<wxString, wxString> aParams;
 	bool bLeftParam = true;
 	for (unsigned int i = 0; i < fmt.length(); i++) {
 		auto c = fmt.at(i);
@@ -631,142 +691,230 @@ wxString CSystemObjects::Format(CValue &cData, const wxString &fmt)
 			bLeftParam = true; leftParam = ""; rightParam = "";
 		}
 	}
+}
 
-	switch (cData.GetType()) {
-	case eValueTypes::TYPE_BOOLEAN: {
-		if (cData.GetBoolean()) {
-			auto foundedBT = aParams.find(BT);
-			if (foundedBT != aParams.end()) {
-				return foundedBT->second;
-			}
+static void CompileDateFormat(const wxString &dateFormat, std::vector<formatData_t::dateFormat_t> &aDateFormat)
+{
+	wxString literal;
+	for (unsigned int i = 0; i < dateFormat.length();) {
+		wxUniChar c = dateFormat[i];
+		unsigned int count = 1;
+		while (i + count < dateFormat.length() && dateFormat[i + count] == c) {
+			count++;
+		}
+
+		formatData_t::dateToken token = formatData_t::dateLiteral;
+
+		if (c == 'y') token = count >= 4 ? formatData_t::dateYear : formatData_t::dateShortYear;
+		else if (c == 'm') token = formatData_t::dateMonth;
+		else if (c == 'd') token = formatData_t::dateDay;
+		else if (c == 'H') token = formatData_t::dateHour;
+		else if (c == 'M') token = formatData_t::dateMinute;
+		else if (c == 'S') token = formatData_t::dateSecond;
+
+		if (token == formatData_t::dateLiteral) {
+			literal += dateFormat.Mid(i, count);
 		}
 		else {
-			auto foundedBT = aParams.find(BF);
-			if (foundedBT != aParams.end()) {
-				return foundedBT->second;
+			if (!literal.IsEmpty()) {
+				aDateFormat.push_back({ formatData_t::dateLiteral, literal });
+				literal.clear();
 			}
+			aDateFormat.push_back({ token, wxEmptyString });
 		}
-		return cData.GetString();
+
+		i += count;
 	}
-	case eValueTypes::TYPE_NUMBER:
-	{
-		ttmath::Conv conv;
 
-		auto foundedND = aParams.find(ND);
-		if (foundedND != aParams.end()) {
-			conv.precision = wxAtoi(foundedND->second);
-			conv.trim_zeroes = true;
-		}
+	if (!literal.IsEmpty()) {
+		aDateFormat.push_back({ formatData_t::dateLiteral, literal });
+	}
+}
 
-		auto foundedNFD = aParams.find(NFD);
-		if (foundedNFD != aParams.end()) {
-			conv.round = wxAtoi(foundedNFD->second);
-			conv.trim_zeroes = false;
-		}
+static void CompileFormat(const wxString &fmt, formatData_t &formatData)
+{
+	std::map<wxString, wxString> aParams;
+	ParseFormat(fmt, aParams);
 
-		auto foundedNDS = aParams.find(NDS);
-		if (foundedNDS != aParams.end()) {
-			conv.comma = foundedNDS->second[0];
-		}
+	//boolean
+	auto foundedBT = aParams.find(BT);
+	if (foundedBT != aParams.end()) {
+		formatData.m_hasBT = true;
+		formatData.m_strBT = foundedBT->second;
+	}
 
-		auto foundedNGS = aParams.find(NGS);
-		if (foundedNGS != aParams.end()) {
-			conv.comma2 = foundedNGS->second[0];
-		}
+	auto foundedBF = aParams.find(BF);
+	if (foundedBF != aParams.end()) {
+		formatData.m_hasBF = true;
+		formatData.m_strBF = foundedBF->second;
+	}
 
-		auto foundedNG = aParams.find(NG);
-		if (foundedNG != aParams.end()) {
-			wxString group, group_digits; bool digits = false;
-			for (auto c : foundedNG->second) {
-				if (c == ',') {
-					digits = true;
-					continue;
-				}
-				if (digits == false) {
-					group += c;
-				}
-				else {
-					group_digits += c;
-				}
+	//number
+	ttmath::Conv &conv = formatData.m_conv;
+
+	auto foundedND = aParams.find(ND);
+	if (foundedND != aParams.end()) {
+		conv.precision = wxAtoi(foundedND->second);
+		conv.trim_zeroes = true;
+	}
+
+	auto foundedNFD = aParams.find(NFD);
+	if (foundedNFD != aParams.end()) {
+		conv.round = wxAtoi(foundedNFD->second);
+		conv.trim_zeroes = false;
+	}
+
+	auto foundedNDS = aParams.find(NDS);
+	if (foundedNDS != aParams.end() && !foundedNDS->second.IsEmpty()) {
+		conv.comma = foundedNDS->second[0];
+	}
+
+	auto foundedNGS = aParams.find(NGS);
+	if (foundedNGS != aParams.end() && !foundedNGS->second.IsEmpty()) {
+		conv.comma2 = foundedNGS->second[0];
+	}
+
+	auto foundedNG = aParams.find(NG);
+	if (foundedNG != aParams.end()) {
+		wxString group, group_digits; bool digits = false;
+		for (auto c : foundedNG->second) {
+			if (c == ',') {
+				digits = true;
+				continue;
+			}
+			if (digits == false) {
+				group += c;
 			}
-			group.Trim(true);
-			group.Trim(false);
-			group_digits.Trim(true);
-			group_digits.Trim(false);
-
-			conv.group = wxAtoi(group);
-			if (!group_digits.IsEmpty()) {
-				conv.group_digits = wxAtoi(group_digits);
+			else {
+				group_digits += c;
 			}
 		}
-
-		auto foundedNLZ = aParams.find(NLZ);
-		if (foundedNLZ != aParams.end()) {
-			conv.leading_zero = true;
+		group.Trim(true);
+		group.Trim(false);
+		group_digits.Trim(true);
+		group_digits.Trim(false);
+
+		conv.group = wxAtoi(group);
+		if (!group_digits.IsEmpty()) {
+			conv.group_digits = wxAtoi(group_digits);
 		}
+	}
 
-		number_t number = cData.GetNumber();
+	auto foundedNLZ = aParams.find(NLZ);
+	if (foundedNLZ != aParams.end()) {
+		conv.leading_zero = true;
+	}
 
-		if (number.IsZero()) {
-			auto foundedNZ = aParams.find(NZ);
+	auto foundedNZ = aParams.find(NZ);
+	if (foundedNZ != aParams.end()) {
+		formatData.m_hasNZ = true;
+		formatData.m_strNZ = foundedNZ->second;
+	}
 
-			if (foundedNZ != aParams.end()) {
-				return foundedNZ->second;
-			}
-		}
+	//date
+	auto foundedDE = aParams.find(DE);
+	if (foundedDE != aParams.end()) {
+		formatData.m_hasDE = true;
+		formatData.m_strDE = foundedDE->second;
+	}
 
-		return number.ToString(conv);
+	auto foundedDF = aParams.find(DF);
+	if (foundedDF != aParams.end()) {
+		formatData.m_hasDF = true;
+		CompileDateFormat(foundedDF->second, formatData.m_aDateFormat);
 	}
-	case eValueTypes::TYPE_DATE:
+}
 
-		if (cData.IsEmpty()) {
-			auto foundedDE = aParams.find(DE);
-			if (foundedDE != aParams.end()) {
-				return foundedDE->second;
-			};
-		}
+#define MAX_FORMAT_CACHE 1024
 
-		auto foundedDF = aParams.find(DF);
-		if (foundedDF != aParams.end()) {
+static const formatData_t &GetFormatData(const wxString &fmt)
+{
+	static std::map<wxString, formatData_t> s_aFormatCache;
 
-			wxString newFormat = foundedDF->second;
+	auto foundedFormat = s_aFormatCache.find(fmt);
+	if (foundedFormat != s_aFormatCache.end())
+		return foundedFormat->second;
 
-			//year 
-			if (newFormat.Replace("yyyy", "%Y") == 0) {
-				if (newFormat.Replace("yyy", "%y") == 0) {
-					if (newFormat.Replace("yy", "%y") == 0) {
-						newFormat.Replace("y", "%y");
-					}
-				}
-			}
+	//formats are usually literals from modules, so the cache stays small; drop it if something generates them
+	if (s_aFormatCache.size() >= MAX_FORMAT_CACHE)
+		s_aFormatCache.clear();
 
-			//mouth 
-			if (newFormat.Replace("mm", "%m") == 0) {
-				newFormat.Replace("m", "%m");
-			}
+	formatData_t &formatData = s_aFormatCache[fmt];
+	CompileFormat(fmt, formatData);
+	return formatData;
+}
 
-			//day 
-			if (newFormat.Replace("dd", "%d") == 0) {
-				newFormat.Replace("d", "%d");
-			}
+static inline void AppendDigits(wxString &result, int value, unsigned int width)
+{
+	wxChar buffer[16]; unsigned int pos = 0;
+	unsigned int absValue = value < 0 ? -value : value;
+
+	do {
+		buffer[pos++] = wxT('0') + absValue % 10;
+		absValue /= 10;
+	} while (absValue > 0 && pos < 15);
+
+	if (value < 0) result += wxT('-');
+	for (unsigned int i = pos; i < width; i++) result += wxT('0');
+	while (pos > 0) result += buffer[--pos];
+}
 
-			//hour
-			if (newFormat.Replace("HH", "%H") == 0) {
-				newFormat.Replace("H", "%H");
+wxString CSystemObjects::Format(CValue &cData, const wxString &fmt)
+{
+	const formatData_t &formatData = GetFormatData(fmt);
+
+	switch (cData.GetType()) {
+	case eValueTypes::TYPE_BOOLEAN: {
+		if (cData.GetBoolean()) {
+			if (formatData.m_hasBT) {
+				return formatData.m_strBT;
+			}
+		}
+		else {
+			if (formatData.m_hasBF) {
+				return formatData.m_strBF;
 			}
+		}
+		return cData.GetString();
+	}
+	case eValueTypes::TYPE_NUMBER:
+	{
+		const number_t &number = cData.GetNumber();
+
+		if (formatData.m_hasNZ && number.IsZero()) {
+			return formatData.m_strNZ;
+		}
 
-			//minute
-			if (newFormat.Replace("MM", "%M") == 0) {
-				newFormat.Replace("M", "%M");
+		return number.ToString(formatData.m_conv);
+	}
+	case eValueTypes::TYPE_DATE:
+
+		if (cData.IsEmpty()) {
+			if (formatData.m_hasDE) {
+				return formatData.m_strDE;
 			}
+		}
 
-			//secound
-			if (newFormat.Replace("SS", "%S") == 0) {
-				newFormat.Replace("S", "%S");
+		if (formatData.m_hasDF) {
+
+			int nYear, nMonth, nDay, nHour, nMinute, nSecond;
+			DateUtils::Split(cData.GetDate(), nYear, nMonth, nDay, nHour, nMinute, nSecond);
+
+			wxString result;
+			for (auto &dateFormat : formatData.m_aDateFormat) {
+				switch (dateFormat.m_token) {
+				case formatData_t::dateLiteral: result += dateFormat.m_literal; break;
+				case formatData_t::dateYear: AppendDigits(result, nYear, 4); break;
+				case formatData_t::dateShortYear: AppendDigits(result, nYear % 100, 2); break;
+				case formatData_t::dateMonth: AppendDigits(result, nMonth, 2); break;
+				case formatData_t::dateDay: AppendDigits(result, nDay, 2); break;
+				case formatData_t::dateHour: AppendDigits(result, nHour, 2); break;
+				case formatData_t::dateMinute: AppendDigits(result, nMinute, 2); break;
+				case formatData_t::dateSecond: AppendDigits(result, nSecond, 2); break;
+				}
 			}
 
-			wxDateTime dateTime = wxLongLong(cData.GetDate());
-			return dateTime.Format(newFormat);
+			return result;
 		}
 
 		return cData.GetString();
@@ -912,19 +1060,30 @@ void CSystemObjects::BeginTransaction()
 {
 	if (CTranslateError::IsSimpleMode()) 
 		return;
-	databaseLayer->BeginTransaction();
+	//pick up changes of other sessions before the transaction starts
+	if (!databaseLayer->IsTransactionOpen()) {
+		objectCache->Refresh();
+	}
+	databaseLayer->BeginWrite();
 }
 
 void CSystemObjects::CommitTransaction()
 {
 	if (CTranslateError::IsSimpleMode()) 
 		return;
-	databaseLayer->Commit();
+	databaseLayer->CommitWrite();
 }
 
 void CSystemObjects::RollBackTransaction()
 {
 	if (CTranslateError::IsSimpleMode())
 		return;
-	databaseLayer->RollBack();
+	databaseLayer->RollBackWrite();
+}
+
+void CSystemObjects::SetGroupCommit(unsigned int count)
+{
+	if (CTranslateError::IsSimpleMode())
+		return;
+	databaseLayer->SetGroupCommitSize(count);
 }
\ No newline at end of file
@@ -103,7 +103,8 @@ enum
 	enShowCommonForm,
 	enBeginTransaction,
 	enCommitTransaction,
-	enRollBackTransaction
+	enRollBackTransaction,
+	enSetGroupCommit
 };
 
 void CSystemObjects::PrepareNames() const
@@ -204,7 +205,8 @@ void CSystemObjects::PrepareNames() const
 
 		{"beginTransaction", "beginTransaction()"},
 		{"commitTransaction", "commitTransaction()"},
-		{"rollBackTransaction", "rollBackTransaction()"}
+		{"rollBackTransaction", "rollBackTransaction()"},
+		{"setGroupCommit", "setGroupCommit(count)"}
 	};
 
 	m_methods.PrepareMethods(aMethods.data(), aMethods.size());
@@ -314,6 +316,7 @@ CValue CSystemObjects::Method(methodArg_t &aParams)
 		case enBeginTransaction: BeginTransaction(); break;
 		case enCommitTransaction: CommitTransaction(); break;
 		case enRollBackTransaction: RollBackTransaction(); break;
+		case enSetGroupCommit: SetGroupCommit(aParams[0].ToUInt()); break;
 		}
 	}
 	else
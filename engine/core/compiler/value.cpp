@@ -10,6 +10,7 @@
 #include "methods.h"
 #include "functions.h"
 #include "utils/stringUtils.h"
+#include "utils/dateUtils.h"
 
 #include <map>
 #include <wx/datetime.h>
@@ -102,11 +103,8 @@ CValue::CValue(const wxDateTime &cParam)
 CValue::CValue(int nYear, int nMonth, int nDay, unsigned short nHour, unsigned short nMinute, unsigned short nSecond)
 	: ITypeValue(eValueTypes::TYPE_DATE), m_refCount(0), m_pRef(NULL), m_bReadOnly(false)
 {
-	wxDateTime m_dataVal(nDay, (wxDateTime::Month)(nMonth - 1), nYear, nHour, nMinute, nSecond);
-
-	if (m_dataVal.IsValid()) {
-		wxLongLong m_llData = m_dataVal.GetValue();
-		m_dData = m_llData.GetValue();
+	if (!DateUtils::Compose(m_dData, nYear, nMonth, nDay, nHour, nMinute, nSecond)) {
+		m_dData = emptyDate;
 	}
 
 	_DEBUG_VALUE_CREATE();
@@ -542,43 +540,27 @@ CValue *CValue::GetRef() const
 
 void CValue::FromDate(int &nYear, int &nMonth, int &nDay) const
 {
-	wxLongLong nCurDate = wxLongLong(GetDate());
-	wxDateTime currentTime(nCurDate);
-
-	nYear = currentTime.GetYear();
-	nMonth = currentTime.GetMonth() + 1;
-	nDay = currentTime.GetDay();
+	DateUtils::Split(GetDate(), nYear, nMonth, nDay);
 }
 
 void CValue::FromDate(int &nYear, int &nMonth, int &nDay, unsigned short &nHour, unsigned short &nMinute, unsigned short &nSecond) const
 {
-	wxLongLong nCurDate = wxLongLong(GetDate());
-	wxDateTime currentTime(nCurDate);
+	int nH, nM, nS;
+	DateUtils::Split(GetDate(), nYear, nMonth, nDay, nH, nM, nS);
 
-	nYear = currentTime.GetYear();
-	nMonth = currentTime.GetMonth() + 1;
-	nDay = currentTime.GetDay();
-	nHour = currentTime.GetHour();
-	nMinute = currentTime.GetMinute();
-	nSecond = currentTime.GetSecond();
+	nHour = nH;
+	nMinute = nM;
+	nSecond = nS;
 }
 
 void CValue::FromDate(int &nYear, int &nMonth, int &nDay, int &DayOfWeek, int &DayOfYear, int &WeekOfYear) const
 {
-	wxLongLong nCurDate = wxLongLong(GetDate());
-	wxDateTime currentTime(nCurDate);
-
-	nYear = currentTime.GetYear();
-	nMonth = currentTime.GetMonth() - 1;
-	nDay = currentTime.GetDay();
-
-	WeekOfYear = DayOfWeek = DayOfYear = 0;
-
-	wxDateTime m_DateTime(nDay, (wxDateTime::Month)nMonth, nYear);
-	DayOfYear = m_DateTime.GetDayOfYear();
-	DayOfWeek = m_DateTime.GetWeekDay() - 1;
+	wxLongLong_t nDays, nTime;
+	DateUtils::SplitDays(GetDate(), nDays, nTime);
+	DateUtils::CivilFromDays(nDays, nYear, nMonth, nDay);
 
-	if (DayOfWeek < 1) DayOfWeek = 7;
+	DayOfYear = (int)(nDays - DateUtils::DaysFromCivil(nYear, 1, 1)) + 1;
+	DayOfWeek = DateUtils::WeekDayFromDays(nDays);
 
 	WeekOfYear = 1 + (DayOfYear - 1) / 7;
 
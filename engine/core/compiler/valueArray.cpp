@@ -50,7 +50,13 @@ enum
 	enClear,
 	enGet,
 	enSet,
-	enRemove
+	enRemove,
+	enSort,
+	enBinarySearch,
+	enDistinct,
+	enAddRange,
+	enReverse,
+	enSlice
 };
 
 void CValueArray::PrepareNames() const
@@ -67,6 +73,12 @@ void CValueArray::PrepareNames() const
 		{"get","get(index)"},
 		{"set","get(index)"},
 		{"remove","remove(index)"},
+		{"sort","sort(direction, comparer)"},
+		{"binarySearch","binarySearch(value)"},
+		{"distinct","distinct()"},
+		{"addRange","addRange(array)"},
+		{"reverse","reverse()"},
+		{"slice","slice(index, count)"},
 	};
 
 	int nCountM = sizeof(aMethods) / sizeof(aMethods[0]);
@@ -85,6 +97,13 @@ CValue CValueArray::Method(methodArg_t &aParams)
 	case enGet: return GetAt(aParams[0]);
 	case enSet: SetAt(aParams[0], aParams[1]); break;
 	case enRemove: Remove(aParams[0].ToUInt()); break;
+	case enSort: Sort(aParams.GetParamCount() > 0 ? aParams[0].ConvertToEnumType<eSortDirection>() : eSortDirection::eSortDirection_Ascending, 
+		aParams.GetParamCount() > 1 ? aParams[1] : CValue()); break;
+	case enBinarySearch: return BinarySearch(aParams[0]);
+	case enDistinct: Distinct(); break;
+	case enAddRange: AddRange(aParams[0]); break;
+	case enReverse: Reverse(); break;
+	case enSlice: return Slice(aParams[0].ToUInt(), aParams.GetParamCount() > 1 ? aParams[1].ToUInt() : Count());
 	}
 
 	return CValue();
@@ -110,10 +129,203 @@ void CValueArray::Remove(unsigned int index)
 CValue CValueArray::Find(CValue &cVal)
 {
 	auto foundedIt = std::find(m_aValuesArray.begin(), m_aValuesArray.end(), cVal);
-	if (foundedIt != m_aValuesArray.end()) return std::distance(m_aValuesArray.begin(), foundedIt);
+	if (foundedIt != m_aValuesArray.end()) return (unsigned int)std::distance(m_aValuesArray.begin(), foundedIt);
 	return CValue();
 }
 
+//**********************************************************************
+//*                       Sort & search                                *
+//**********************************************************************
+
+//order of types for arrays with values of different types
+static inline int GetTypeOrder(const CValue *cValue)
+{
+	switch (cValue->GetType())
+	{
+	case eValueTypes::TYPE_EMPTY: return 0;
+	case eValueTypes::TYPE_NULL: return 1;
+	case eValueTypes::TYPE_BOOLEAN: return 2;
+	case eValueTypes::TYPE_NUMBER: return 3;
+	case eValueTypes::TYPE_DATE: return 4;
+	case eValueTypes::TYPE_STRING: return 5;
+	}
+
+	return 6;
+}
+
+//returns <0, 0, >0 like strcmp
+static inline int CompareTyped(const CValue *lhs, const CValue *rhs)
+{
+	const int lhsOrder = GetTypeOrder(lhs), rhsOrder = GetTypeOrder(rhs);
+	if (lhsOrder != rhsOrder)
+		return lhsOrder < rhsOrder ? -1 : 1;
+
+	switch (lhs->GetType())
+	{
+	case eValueTypes::TYPE_EMPTY:
+	case eValueTypes::TYPE_NULL: return 0;
+	case eValueTypes::TYPE_BOOLEAN: return (int)lhs->m_bData - (int)rhs->m_bData;
+	case eValueTypes::TYPE_NUMBER: return lhs->m_fData < rhs->m_fData ? -1 : (rhs->m_fData < lhs->m_fData ? 1 : 0);
+	case eValueTypes::TYPE_DATE: return lhs->m_dData < rhs->m_dData ? -1 : (rhs->m_dData < lhs->m_dData ? 1 : 0);
+	case eValueTypes::TYPE_STRING: return lhs->m_sData.compare(rhs->m_sData);
+	}
+
+	if (lhs->CompareValueEQ(*rhs))
+		return 0;
+
+	int result = lhs->GetTypeString().compare(rhs->GetTypeString());
+	if (result != 0)
+		return result;
+
+	return lhs->GetString().compare(rhs->GetString());
+}
+
+//user comparer: object with method compare(value1, value2)
+static inline int CompareByComparer(const CValue &cComparer, int nMethod, const CValue *lhs, const CValue *rhs)
+{
+	CValue *aParams[2] = { const_cast<CValue *>(lhs), const_cast<CValue *>(rhs) };
+	methodArg_t aMethParams(aParams, 2, nMethod, wxT("compare"));
+	return const_cast<CValue &>(cComparer).Method(aMethParams).ToInt();
+}
+
+void CValueArray::Sort(eSortDirection direction, const CValue &cComparer)
+{
+	if (m_aValuesArray.size() < 2)
+		return;
+
+	const bool descending = direction == eSortDirection::eSortDirection_Descending;
+
+	std::vector<const CValue *> aSorted; aSorted.reserve(m_aValuesArray.size());
+	for (auto &value : m_aValuesArray) {
+		aSorted.push_back(&value);
+	}
+
+	if (cComparer.GetType() != eValueTypes::TYPE_EMPTY) {
+		int nMethod = cComparer.FindMethod(wxT("compare"));
+		if (nMethod == wxNOT_FOUND)
+			CTranslateError::Error(_("Comparer must have method 'compare'"));
+		std::stable_sort(aSorted.begin(), aSorted.end(), [&cComparer, nMethod, descending](const CValue *lhs, const CValue *rhs) {
+			int result = CompareByComparer(cComparer, nMethod, lhs, rhs);
+			return descending ? result > 0 : result < 0;
+		});
+	}
+	else {
+		//typed fast path for homogeneous arrays
+		eValueTypes valType = m_aValuesArray[0].GetType();
+		bool homogeneous = std::all_of(m_aValuesArray.begin(), m_aValuesArray.end(), [valType](const CValue &value) { return value.GetType() == valType; });
+		if (homogeneous && valType == eValueTypes::TYPE_NUMBER) {
+			std::stable_sort(aSorted.begin(), aSorted.end(), [descending](const CValue *lhs, const CValue *rhs) {
+				return descending ? rhs->m_fData < lhs->m_fData : lhs->m_fData < rhs->m_fData;
+			});
+		}
+		else if (homogeneous && valType == eValueTypes::TYPE_STRING) {
+			std::stable_sort(aSorted.begin(), aSorted.end(), [descending](const CValue *lhs, const CValue *rhs) {
+				return descending ? rhs->m_sData < lhs->m_sData : lhs->m_sData < rhs->m_sData;
+			});
+		}
+		else if (homogeneous && valType == eValueTypes::TYPE_DATE) {
+			std::stable_sort(aSorted.begin(), aSorted.end(), [descending](const CValue *lhs, const CValue *rhs) {
+				return descending ? rhs->m_dData < lhs->m_dData : lhs->m_dData < rhs->m_dData;
+			});
+		}
+		else {
+			std::stable_sort(aSorted.begin(), aSorted.end(), [descending](const CValue *lhs, const CValue *rhs) {
+				int result = CompareTyped(lhs, rhs);
+				return descending ? result > 0 : result < 0;
+			});
+		}
+	}
+
+	std::vector<CValue> aValuesArray; aValuesArray.reserve(aSorted.size());
+	for (auto value : aSorted) {
+		aValuesArray.push_back(*value);
+	}
+
+	m_aValuesArray.swap(aValuesArray);
+}
+
+CValue CValueArray::BinarySearch(const CValue &cVal) const
+{
+	const CValue *pValue = &cVal;
+	if (cVal.GetType() == eValueTypes::TYPE_REFFER)
+		pValue = cVal.GetRef();
+
+	auto foundedIt = std::lower_bound(m_aValuesArray.begin(), m_aValuesArray.end(), pValue, [](const CValue &lhs, const CValue *rhs) {
+		return CompareTyped(&lhs, rhs) < 0;
+	});
+
+	if (foundedIt != m_aValuesArray.end() && CompareTyped(&*foundedIt, pValue) == 0)
+		return (unsigned int)std::distance(m_aValuesArray.begin(), foundedIt);
+
+	return CValue();
+}
+
+void CValueArray::Distinct()
+{
+	if (m_aValuesArray.size() < 2)
+		return;
+
+	std::vector<unsigned int> aSorted(m_aValuesArray.size());
+	for (unsigned int idx = 0; idx < aSorted.size(); idx++) {
+		aSorted[idx] = idx;
+	}
+
+	std::stable_sort(aSorted.begin(), aSorted.end(), [this](unsigned int lhs, unsigned int rhs) {
+		return CompareTyped(&m_aValuesArray[lhs], &m_aValuesArray[rhs]) < 0;
+	});
+
+	//equal values are neighbours now, keep the first one by position
+	std::vector<bool> aDuplicates(m_aValuesArray.size(), false);
+	for (unsigned int idx = 1; idx < aSorted.size(); idx++) {
+		const CValue &prevValue = m_aValuesArray[aSorted[idx - 1]];
+		const CValue &currValue = m_aValuesArray[aSorted[idx]];
+		if (CompareTyped(&prevValue, &currValue) == 0) {
+			aDuplicates[aSorted[idx]] = true;
+		}
+	}
+
+	std::vector<CValue> aValuesArray; aValuesArray.reserve(m_aValuesArray.size());
+	for (unsigned int idx = 0; idx < m_aValuesArray.size(); idx++) {
+		if (!aDuplicates[idx]) {
+			aValuesArray.push_back(m_aValuesArray[idx]);
+		}
+	}
+
+	m_aValuesArray.swap(aValuesArray);
+}
+
+void CValueArray::AddRange(CValue &cVal)
+{
+	CValueArray *valueArray = NULL;
+	if (cVal.ConvertToValue(valueArray)) {
+		std::vector<CValue> aValuesArray(valueArray->m_aValuesArray);
+		m_aValuesArray.insert(m_aValuesArray.end(), aValuesArray.begin(), aValuesArray.end());
+		return;
+	}
+
+	if (!cVal.HasIterator())
+		CTranslateError::Error(_("Undefined value iterator"));
+
+	unsigned int count = cVal.GetItSize();
+	m_aValuesArray.reserve(m_aValuesArray.size() + count);
+	for (unsigned int idx = 0; idx < count; idx++) {
+		m_aValuesArray.push_back(cVal.GetItAt(idx));
+	}
+}
+
+CValueArray *CValueArray::Slice(unsigned int index, unsigned int count) const
+{
+	if (index >= m_aValuesArray.size())
+		return new CValueArray();
+
+	unsigned int last = std::min<unsigned int>(m_aValuesArray.size(), index + std::min<unsigned int>(count, m_aValuesArray.size()));
+	std::vector<CValue> aValuesArray(m_aValuesArray.begin() + index, m_aValuesArray.begin() + last);
+
+	CValueArray *valueArray = new CValueArray();
+	valueArray->m_aValuesArray.swap(aValuesArray);
+	return valueArray;
+}
+
 void CValueArray::SetAt(const CValue &cKey, CValue &cVal)//     0
 {
 	CheckIndex(cKey.ToUInt());
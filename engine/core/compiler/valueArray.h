@@ -2,6 +2,7 @@
 #define _VALUEARRAY_H__
 
 #include "value.h"
+#include "systemEnums.h"
 
 // 
 class CValueArray : public CValue
@@ -49,6 +50,14 @@ public:
 	void Remove(unsigned int index);
 	void Clear() { m_aValuesArray.clear(); }
 
+	//bulk operations
+	void Sort(eSortDirection direction = eSortDirection::eSortDirection_Ascending, const CValue &cComparer = CValue());
+	CValue BinarySearch(const CValue &cVal) const;
+	void Distinct();
+	void AddRange(CValue &cVal);
+	void Reverse() { std::reverse(m_aValuesArray.begin(), m_aValuesArray.end()); }
+	CValueArray *Slice(unsigned int index, unsigned int count) const;
+
 	//array support 
 	virtual CValue GetAt(const CValue &cKey);
 	virtual void SetAt(const CValue &cKey, CValue &cVal);
@@ -36,6 +36,8 @@ public:
 		CValueReturnContainer() : CValue(eValueTypes::TYPE_VALUE, true) { PrepareNames(); }
 		CValueReturnContainer(const CValue &key, CValue &value) : CValue(eValueTypes::TYPE_VALUE, true), m_key(key), m_value(value) { PrepareNames(); }
 
+		const CValue &GetKey() const { return m_key; }
+
 		virtual CMethods* GetPMethods() const { return &m_methods; }; //         
 		virtual void PrepareNames() const;
 
@@ -107,6 +107,12 @@ CValue CValueTable::Method(methodArg_t &aParams)
 }
 
 #include "appData.h"
+#include "metadata/objects/reference/reference.h"
+
+void CValueTable::PrepareReferences()
+{
+	CValueReference::PrepareReferences(m_aObjectValues);
+}
 
 CValue CValueTable::GetAt(const CValue &cKey)
 {
@@ -124,8 +130,8 @@ CValue CValueTable::GetAt(const CValue &cKey)
 
 wxIMPLEMENT_DYNAMIC_CLASS(CValueTable::CValueTableColumns, IValueTable::IValueTableColumns);
 
-CValueTable::CValueTableColumns::CValueTableColumns() : IValueTableColumns(), m_methods(NULL), m_ownerTable(NULL) {}
-CValueTable::CValueTableColumns::CValueTableColumns(CValueTable *ownerTable) : IValueTableColumns(), m_methods(new CMethods()), m_ownerTable(ownerTable) {}
+CValueTable::CValueTableColumns::CValueTableColumns() : IValueTableColumns(), m_methods(NULL), m_lineMethods(NULL), m_lineMethodsChanged(false), m_ownerTable(NULL) {}
+CValueTable::CValueTableColumns::CValueTableColumns(CValueTable *ownerTable) : IValueTableColumns(), m_methods(new CMethods()), m_lineMethods(new CMethods()), m_lineMethodsChanged(true), m_ownerTable(ownerTable) {}
 CValueTable::CValueTableColumns::~CValueTableColumns()
 {
 	for (auto& colInfo : m_aColumnInfo) {
@@ -134,6 +140,7 @@ CValueTable::CValueTableColumns::~CValueTableColumns()
 	}
 
 	wxDELETE(m_methods);
+	wxDELETE(m_lineMethods);
 }
 
 //      
@@ -155,6 +162,27 @@ void CValueTable::CValueTableColumns::PrepareNames() const
 	m_methods->PrepareMethods(aMethods.data(), aMethods.size());
 }
 
+void CValueTable::CValueTableColumns::PrepareLineNames()
+{
+	std::vector<SEng> aAttributes;
+
+	for (auto &colInfo : m_aColumnInfo)
+	{
+		wxASSERT(colInfo);
+
+		SEng aAttribute;
+
+		aAttribute.sName = colInfo->GetColumnName();
+		aAttribute.sSynonym = wxT("default");
+		aAttribute.iName = colInfo->GetColumnID();
+
+		aAttributes.push_back(aAttribute);
+	}
+
+	m_lineMethods->PrepareAttributes(aAttributes.data(), aAttributes.size());
+	m_lineMethodsChanged = false;
+}
+
 #include "valueType.h"
 
 CValue CValueTable::CValueTableColumns::Method(methodArg_t &aParams)
@@ -281,9 +309,9 @@ CValue CValueTable::CValueTableColumns::CValueTableColumnInfo::GetAttribute(attr
 
 wxIMPLEMENT_DYNAMIC_CLASS(CValueTable::CValueTableReturnLine, IValueTable::IValueTableReturnLine);
 
-CValueTable::CValueTableReturnLine::CValueTableReturnLine() : IValueTableReturnLine(), m_methods(NULL), m_ownerTable(NULL), m_lineTable(wxNOT_FOUND) {}
-CValueTable::CValueTableReturnLine::CValueTableReturnLine(CValueTable *ownerTable, int line) : IValueTableReturnLine(), m_methods(new CMethods()), m_ownerTable(ownerTable), m_lineTable(line) {}
-CValueTable::CValueTableReturnLine::~CValueTableReturnLine() { if (m_methods) delete m_methods; }
+CValueTable::CValueTableReturnLine::CValueTableReturnLine() : IValueTableReturnLine(), m_ownerTable(NULL), m_lineTable(wxNOT_FOUND) {}
+CValueTable::CValueTableReturnLine::CValueTableReturnLine(CValueTable *ownerTable, int line) : IValueTableReturnLine(), m_ownerTable(ownerTable), m_lineTable(line) {}
+CValueTable::CValueTableReturnLine::~CValueTableReturnLine() {}
 
 void CValueTable::CValueTableReturnLine::SetValueByMetaID(meta_identifier_t id, const CValue & cVal)
 {
@@ -307,33 +335,16 @@ CValue CValueTable::CValueTableReturnLine::GetValueByMetaID(meta_identifier_t id
 	return CValue();
 }
 
-void CValueTable::CValueTableReturnLine::PrepareNames() const
-{
-	std::vector<SEng> aAttributes;
-
-	for (auto &colInfo : m_ownerTable->m_aDataColumns->m_aColumnInfo)
-	{
-		wxASSERT(colInfo);
-
-		SEng aAttribute;
-
-		aAttribute.sName = colInfo->GetColumnName();
-		aAttribute.sSynonym = wxT("default");
-		aAttribute.iName = colInfo->GetColumnID();
-
-		aAttributes.push_back(aAttribute);
-	}
-
-	m_methods->PrepareAttributes(aAttributes.data(), aAttributes.size());
-}
-
 void CValueTable::CValueTableReturnLine::SetAttribute(attributeArg_t &aParams, CValue &cVal)
 {
 	if (appData->DesignerMode())
 		return;
 
+	CMethods *lineMethods = GetPMethods();
+	wxASSERT(lineMethods);
+
 	SetValueByMetaID(
-		m_methods->GetAttributePosition(aParams.GetIndex()),
+		lineMethods->GetAttributePosition(aParams.GetIndex()),
 		cVal
 	);
 }
@@ -343,8 +354,11 @@ CValue CValueTable::CValueTableReturnLine::GetAttribute(attributeArg_t &aParams)
 	if (appData->DesignerMode())
 		return CValue();
 
+	CMethods *lineMethods = GetPMethods();
+	wxASSERT(lineMethods);
+
 	return GetValueByMetaID(
-		m_methods->GetAttributePosition(aParams.GetIndex())
+		lineMethods->GetAttributePosition(aParams.GetIndex())
 	);
 }
 
@@ -80,6 +80,8 @@ public:
 			for (auto &rowValue : m_ownerTable->m_aObjectValues)
 				rowValue.insert_or_assign(max_id + 1, types ? types->AdjustValue() : CValue());
 
+			m_lineMethodsChanged = true;
+
 			columnInfo->IncrRef();
 			return columnInfo;
 		}
@@ -110,6 +112,8 @@ public:
 			columnInfo->DecrRef();
 
 			m_aColumnInfo.erase(foundedIt);
+
+			m_lineMethodsChanged = true;
 		}
 
 		virtual IValueTableColumnsInfo *GetColumnInfo(unsigned int idx) const
@@ -148,17 +152,33 @@ public:
 
 		virtual unsigned int GetItSize() const { return GetColumnCount(); }
 
+		//attribute table shared by all rows of the table, rebuilt only after the columns have changed
+		CMethods *GetLineMethods() {
+			if (m_lineMethodsChanged) {
+				PrepareLineNames();
+			}
+			return m_lineMethods;
+		}
+
 		friend class CValueTable;
 
+	protected:
+
+		void PrepareLineNames();
+
 	protected:
 
 		CValueTable *m_ownerTable;
 		CMethods *m_methods;
+		CMethods *m_lineMethods;
+
+		bool m_lineMethodsChanged;
 
 		std::vector<CValueTableColumnInfo *> m_aColumnInfo;
 
 	} *m_aDataColumns;
 
+	//row handle: owner table and line index only, names are shared through columns 
 	class CValueTableReturnLine : public IValueTableReturnLine {
 		wxDECLARE_DYNAMIC_CLASS(CValueTableReturnLine);
 	public:
@@ -176,18 +196,13 @@ public:
 		virtual void SetValueByMetaID(meta_identifier_t id, const CValue &cVal);
 		virtual CValue GetValueByMetaID(meta_identifier_t id) const;
 
-		virtual CMethods* GetPMethods() const { PrepareNames(); return m_methods; }; //         
-		virtual void PrepareNames() const;                         //         
+		virtual CMethods* GetPMethods() const { return m_ownerTable ? m_ownerTable->m_aDataColumns->GetLineMethods() : NULL; } //         
 
 		virtual wxString GetTypeString() const { return wxT("tableValueRow"); }
 		virtual wxString GetString() const { return wxT("tableValueRow"); }
 
 		virtual void SetAttribute(attributeArg_t &aParams, CValue &cVal); // 
 		virtual CValue GetAttribute(attributeArg_t &aParams); // 
-
-	private:
-
-		CMethods *m_methods;
 	};
 
 public:
@@ -270,6 +285,8 @@ public:
 
 	virtual unsigned int GetItSize() const override { return m_aObjectValues.size(); }
 
+	virtual void PrepareReferences();
+
 protected:
 
 	std::vector<std::map<unsigned int, CValue>> m_aObjectValues;
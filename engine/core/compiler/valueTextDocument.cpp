@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////
+//	Author		: Maxim Kornienko
+//	Description : text document value
+////////////////////////////////////////////////////////////////////////////
+
+#include "valueTextDocument.h"
+#include "methods.h"
+#include "functions.h"
+
+#include <wx/wfstream.h>
+#include <wx/txtstrm.h>
+
+wxIMPLEMENT_DYNAMIC_CLASS(CValueTextDocument, CValue);
+
+//////////////////////////////////////////////////////////////////////
+
+CMethods CValueTextDocument::m_methods;
+
+CValueTextDocument::CValueTextDocument() : CValue(eValueTypes::TYPE_VALUE) {}
+
+CValueTextDocument::~CValueTextDocument() { Clear(); }
+
+#include "appData.h"
+
+void CValueTextDocument::CheckLine(unsigned int line) const //line numbers start with 1
+{
+	if ((line < 1 || line > m_aLines.size()) && !appData->DesignerMode())
+		CTranslateError::Error(_("Line number goes beyond text document"));
+}
+
+enum
+{
+	enRead = 0,
+	enWrite,
+	enLineCount,
+	enGetLine,
+	enAddLine,
+	enInsertLine,
+	enReplaceLine,
+	enDeleteLine,
+	enGetText,
+	enSetText,
+	enClear
+};
+
+void CValueTextDocument::PrepareNames() const
+{
+	m_methods.AppendConstructor("textDocument", "textDocument()");
+
+	SEng aMethods[] =
+	{
+		{"read","read(fileName, encoding)"},
+		{"write","write(fileName, encoding)"},
+		{"lineCount","lineCount()"},
+		{"getLine","getLine(number)"},
+		{"addLine","addLine(string)"},
+		{"insertLine","insertLine(number, string)"},
+		{"replaceLine","replaceLine(number, string)"},
+		{"deleteLine","deleteLine(number)"},
+		{"getText","getText()"},
+		{"setText","setText(string)"},
+		{"clear","clear()"},
+	};
+
+	int nCountM = sizeof(aMethods) / sizeof(aMethods[0]);
+	m_methods.PrepareMethods(aMethods, nCountM);
+}
+
+CValue CValueTextDocument::Method(methodArg_t &aParams)
+{
+	switch (aParams.GetIndex())
+	{
+	case enRead: return Read(aParams[0].GetString(), aParams.GetParamCount() > 1 ? aParams[1].GetString() : wxEmptyString);
+	case enWrite: return Write(aParams[0].GetString(), aParams.GetParamCount() > 1 ? aParams[1].GetString() : wxEmptyString);
+	case enLineCount: return LineCount();
+	case enGetLine: return GetLine(aParams[0].ToUInt());
+	case enAddLine: AddLine(aParams[0].GetString()); break;
+	case enInsertLine: InsertLine(aParams[0].ToUInt(), aParams[1].GetString()); break;
+	case enReplaceLine: ReplaceLine(aParams[0].ToUInt(), aParams[1].GetString()); break;
+	case enDeleteLine: DeleteLine(aParams[0].ToUInt()); break;
+	case enGetText: return GetText();
+	case enSetText: SetText(aParams[0].GetString()); break;
+	case enClear: Clear(); break;
+	}
+
+	return CValue();
+}
+
+bool CValueTextDocument::Read(const wxString &fileName, const wxString &encoding)
+{
+	wxFileInputStream inputStream(fileName);
+	if (!inputStream.IsOk())
+		return false;
+
+	wxCSConv convEncoding(encoding.IsEmpty() ? wxT("UTF-8") : encoding);
+	wxTextInputStream textStream(inputStream, wxT(" \t"), convEncoding);
+
+	m_aLines.clear();
+
+	while (inputStream.IsOk() && !inputStream.Eof()) {
+		wxString line = textStream.ReadLine();
+		if (line.IsEmpty() && inputStream.Eof())
+			break;
+		m_aLines.push_back(line);
+	}
+
+	return true;
+}
+
+bool CValueTextDocument::Write(const wxString &fileName, const wxString &encoding) const
+{
+	wxFileOutputStream outputStream(fileName);
+	if (!outputStream.IsOk())
+		return false;
+
+	wxCSConv convEncoding(encoding.IsEmpty() ? wxT("UTF-8") : encoding);
+	wxTextOutputStream textStream(outputStream, wxEOL_NATIVE, convEncoding);
+
+	for (auto &line : m_aLines) {
+		textStream.WriteString(line);
+		textStream.WriteString(wxT("\n"));
+	}
+
+	textStream.Flush();
+	return outputStream.IsOk();
+}
+
+wxString CValueTextDocument::GetLine(unsigned int line) const
+{
+	CheckLine(line);
+	return m_aLines[line - 1];
+}
+
+void CValueTextDocument::InsertLine(unsigned int line, const wxString &text)
+{
+	if (line == m_aLines.size() + 1) {
+		AddLine(text); return;
+	}
+
+	CheckLine(line);
+	m_aLines.insert(m_aLines.begin() + line - 1, text);
+}
+
+void CValueTextDocument::ReplaceLine(unsigned int line, const wxString &text)
+{
+	CheckLine(line);
+	m_aLines[line - 1] = text;
+}
+
+void CValueTextDocument::DeleteLine(unsigned int line)
+{
+	CheckLine(line);
+	m_aLines.erase(m_aLines.begin() + line - 1);
+}
+
+wxString CValueTextDocument::GetText() const
+{
+	size_t length = 0;
+	for (auto &line : m_aLines) {
+		length += line.length() + 1;
+	}
+
+	wxString text;
+	text.reserve(length);
+
+	for (auto itLine = m_aLines.begin(); itLine != m_aLines.end(); itLine++) {
+		if (itLine != m_aLines.begin()) {
+			text += wxT('\n');
+		}
+		text += *itLine;
+	}
+
+	return text;
+}
+
+void CValueTextDocument::SetText(const wxString &text)
+{
+	m_aLines.clear();
+
+	size_t start = 0;
+	for (;;) {
+		size_t end = text.find(wxT('\n'), start);
+		size_t last = (end == wxString::npos) ? text.length() : end;
+		size_t length = last - start;
+		if (length > 0 && text[last - 1] == wxT('\r')) {
+			length--;
+		}
+		m_aLines.push_back(text.substr(start, length));
+		if (end == wxString::npos)
+			break;
+		start = end + 1;
+	}
+}
+
+//**********************************************************************
+//*                       Runtime register                             *
+//**********************************************************************
+
+VALUE_REGISTER(CValueTextDocument, "textDocument", TEXT2CLSID("VL_TXTD"));
@@ -0,0 +1,55 @@
+#ifndef _VALUE_TEXT_DOCUMENT_H__
+#define _VALUE_TEXT_DOCUMENT_H__
+
+#include "compiler/value.h"
+
+//text document - lines are kept separately, so line access and append do not rescan the text
+class CValueTextDocument : public CValue {
+	wxDECLARE_DYNAMIC_CLASS(CValueTextDocument);
+public:
+
+	virtual CMethods* GetPMethods() const { return &m_methods; };
+	virtual void PrepareNames() const;
+	virtual CValue Method(methodArg_t &aParams);
+
+	CValueTextDocument();
+	virtual ~CValueTextDocument();
+
+	virtual inline bool IsEmpty() const override { return m_aLines.empty(); }
+
+	virtual wxString GetTypeString() const { return wxT("textDocument"); }
+	virtual wxString GetString() const { return wxT("textDocument"); }
+
+	//file support
+	bool Read(const wxString &fileName, const wxString &encoding = wxEmptyString);
+	bool Write(const wxString &fileName, const wxString &encoding = wxEmptyString) const;
+
+	//line support
+	unsigned int LineCount() const { return m_aLines.size(); }
+	wxString GetLine(unsigned int line) const;
+	void AddLine(const wxString &text) { m_aLines.push_back(text); }
+	void InsertLine(unsigned int line, const wxString &text);
+	void ReplaceLine(unsigned int line, const wxString &text);
+	void DeleteLine(unsigned int line);
+
+	wxString GetText() const;
+	void SetText(const wxString &text);
+
+	void Clear() { m_aLines.clear(); }
+
+	//iterator support
+	virtual bool HasIterator() const { return true; }
+	virtual CValue GetItAt(unsigned int idx) { return m_aLines[idx]; }
+	virtual unsigned int GetItSize() const { return LineCount(); }
+
+private:
+
+	inline void CheckLine(unsigned int line) const;
+
+private:
+
+	std::vector<wxString> m_aLines;
+	static CMethods m_methods;
+};
+
+#endif
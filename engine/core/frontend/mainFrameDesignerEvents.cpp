@@ -241,6 +241,8 @@ void CMainFrameDesigner::OnDebugEvent(wxDebugEvent &event)
 }
 
 #include "metadata/metadata.h"
+#include "metadata/objects/restructurePlan.h"
+#include "compiler/systemObjects.h"
 
 void CMainFrameDesigner::OnToolbarClicked(wxEvent &event)
 {
@@ -261,6 +263,16 @@ void CMainFrameDesigner::OnToolbarClicked(wxEvent &event)
 			canSave = m_document->OnSaveModified();
 		}
 
+		//dry run: the user sees the rows to be converted or lost before the save
+		CConfigStorageMetadata *storageMetadata = dynamic_cast<CConfigStorageMetadata *>(metadata);
+		CRestructurePlan restructurePlan;
+		if (canSave && storageMetadata != NULL && storageMetadata->GetRestructurePlan(restructurePlan) && restructurePlan.HasRowChanges()) {
+			CSystemObjects::Message(restructurePlan.GetDescription());
+			if (wxMessageBox(_("Changes of the configuration convert or delete the saved data:\n\n") + restructurePlan.GetDescription() + _("\n\nDo you want to continue?"), wxMessageBoxCaptionStr, wxYES_NO | wxCENTRE | wxICON_WARNING, this) == wxNO) {
+				return;
+			}
+		}
+
 		if (canSave && !appData->SaveConfiguration()) {
 			wxMessageBox("Failed to save metadata!", wxMessageBoxCaptionStr, wxOK | wxCENTRE | wxICON_ERROR, this);
 		}
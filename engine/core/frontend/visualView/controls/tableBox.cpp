@@ -188,6 +188,11 @@ void CValueTableBox::CreateModel()
 
 	CreateTable();
 
+	//one query per referenced table instead of one per cell
+	if (m_tableModel && !appData->DesignerMode()) {
+		m_tableModel->PrepareReferences();
+	}
+
 	IValueFrame *ownerControl = m_formOwner->GetOwnerControl();
 	if (ownerControl) {
 		CValueReference *refValue = NULL;
@@ -27,8 +27,14 @@ void CUserWnd::OnOKButtonClick(wxCommandEvent &event)
 		return; 
 	}
 
+	wxArrayString aColumns, aValues, aKeyColumns;
+	aColumns.Add(wxT("guid")); aColumns.Add(wxT("name")); aColumns.Add(wxT("fullName"));
+	aColumns.Add(wxT("changed")); aColumns.Add(wxT("dataSize")); aColumns.Add(wxT("binaryData"));
+	aValues.Add(wxT("?"), aColumns.size());
+	aKeyColumns.Add(wxT("guid"));
+
 	PreparedStatement *prepStatement =
-		databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (guid, name, fullName, changed, dataSize, binaryData) VALUES(?, ?, ?, ?, ?, ?) MATCHING (guid);", IConfigMetadata::GetUsersTableName());
+		databaseLayer->PrepareStatement(databaseLayer->GetDialect()->GetUpsert(IConfigMetadata::GetUsersTableName(), aColumns, aValues, aKeyColumns));
 
 	if (prepStatement) {
 		if (!m_userGuid.isValid()) {
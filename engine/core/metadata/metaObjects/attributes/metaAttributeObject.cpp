@@ -5,6 +5,8 @@
 
 #include "metaAttributeObject.h"
 #include "metadata/metadata.h"
+#include "databaseLayer/databaseLayer.h"
+#include "appData.h"
 
 wxIMPLEMENT_ABSTRACT_CLASS(IMetaAttributeObject, IMetaObject)
 wxIMPLEMENT_DYNAMIC_CLASS(CMetaAttributeObject, IMetaAttributeObject)
@@ -37,6 +39,7 @@ CMetaAttributeObject::CMetaAttributeObject() : IMetaAttributeObject()
 
 	PropertyContainer *categoryAttribute = IObjectBase::CreatePropertyContainer("Attribute");
 	categoryAttribute->AddProperty("fill_check", PropertyType::PT_BOOL);
+	categoryAttribute->AddProperty("indexed", PropertyType::PT_BOOL);
 	m_category->AddCategory(categoryAttribute);
 }
 
@@ -65,22 +68,16 @@ bool IMetaAttributeObject::OnDeleteMetaObject()
 
 wxString IMetaAttributeObject::GetSQLTypeObject()
 {
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
 	switch (IMetaAttributeObject::GetTypeObject())
 	{
-	case eValueTypes::TYPE_BOOLEAN: return wxString::Format("SMALLINT"); break;
-	case eValueTypes::TYPE_NUMBER:
-	{
-		if (m_typeDescription.GetScale() > 0) {
-			return wxString::Format("NUMERIC(%i,%i)", m_typeDescription.GetPrecision(), m_typeDescription.GetScale());
-		}
-		else {
-			return wxString::Format("NUMERIC(%i)", m_typeDescription.GetPrecision());
-		}
-		break;
-	}
-	case eValueTypes::TYPE_DATE: return wxString::Format("TIMESTAMP"); break;
-	case eValueTypes::TYPE_STRING: return wxString::Format("VARCHAR(%i)", m_typeDescription.GetLength()); break;
-	default: return wxString::Format("BLOB"); break;
+	case eValueTypes::TYPE_BOOLEAN: return dialect->GetBooleanType(); break;
+	case eValueTypes::TYPE_NUMBER: return dialect->GetNumberType(m_typeDescription.GetPrecision(), m_typeDescription.GetScale()); break;
+	case eValueTypes::TYPE_DATE: return dialect->GetDateTimeType(); break;
+	case eValueTypes::TYPE_STRING: return dialect->GetStringType(m_typeDescription.GetLength()); break;
+	//references are fixed binary (meta id, guid), read inline with the row
+	default: return dialect->GetBinaryType((int)sizeof(reference_t)); break;
 	}
 
 	return wxEmptyString;
@@ -104,6 +101,25 @@ bool IMetaAttributeObject::SaveData(CMemoryWriter &writer)
 	return true;
 }
 
+bool CMetaAttributeObject::LoadData(CMemoryReader &reader)
+{
+	if (!IMetaAttributeObject::LoadData(reader))
+		return false;
+
+	//attribute data has its own chunk, configurations saved before the flag have no byte for it
+	m_bIndexed = !reader.eof() ? reader.r_u8() : false;
+	return true;
+}
+
+bool CMetaAttributeObject::SaveData(CMemoryWriter &writer)
+{
+	if (!IMetaAttributeObject::SaveData(writer))
+		return false;
+
+	writer.w_u8(m_bIndexed);
+	return true;
+}
+
 //***********************************************************************
 //*                          Read&save property                         *
 //***********************************************************************
@@ -128,6 +144,7 @@ void CMetaAttributeObject::ReadProperty()
 	}
 
 	IObjectBase::SetPropertyValue("fill_check", m_bFillCheck);
+	IObjectBase::SetPropertyValue("indexed", m_bIndexed);
 }
 
 void CMetaAttributeObject::SaveProperty()
@@ -182,6 +199,7 @@ void CMetaAttributeObject::SaveProperty()
 	}
 
 	IObjectBase::GetPropertyValue("fill_check", m_bFillCheck);
+	IObjectBase::GetPropertyValue("indexed", m_bIndexed);
 }
 
 //***********************************************************************
@@ -10,7 +10,7 @@ class IMetaAttributeObject : public IMetaObject,
 public:
 
 	IMetaAttributeObject(const wxString &name = wxEmptyString, const wxString &synonym = wxEmptyString, const wxString &comment = wxEmptyString) :
-		IMetaObject(name, synonym, comment), IAttributeInfo(), m_bFillCheck(false)
+		IMetaObject(name, synonym, comment), IAttributeInfo(), m_bFillCheck(false), m_bIndexed(false)
 	{
 	}
 
@@ -33,6 +33,9 @@ public:
 	//check if attribute is fill 
 	virtual bool FillCheck() const { return m_bFillCheck; }
 
+	//check if attribute has an index in db
+	virtual bool IsIndexed() const { return m_bIndexed; }
+
 	//events:
 	virtual bool OnCreateMetaObject(IMetadata *metaData);
 	virtual bool OnDeleteMetaObject();
@@ -50,6 +53,7 @@ protected:
 protected:
 
 	bool m_bFillCheck; 
+	bool m_bIndexed;
 
 protected:
 
@@ -86,6 +90,11 @@ public:
 	//read & save property
 	virtual void ReadProperty() override;
 	virtual void SaveProperty() override;
+
+protected:
+
+	virtual bool LoadData(CMemoryReader &reader);
+	virtual bool SaveData(CMemoryWriter &writer = CMemoryWriter());
 };
 
 class CMetaDefaultAttributeObject : public IMetaAttributeObject {
@@ -85,6 +85,16 @@ wxString IConfigMetadata::GetConfigParamsTableName()
 	return wxT("CONFIG_PARAMS");
 }
 
+wxString IConfigMetadata::GetObjectChangesTableName()
+{
+	return wxT("OBJECT_CHANGES");
+}
+
+wxString IConfigMetadata::GetObjectNumbersTableName()
+{
+	return wxT("OBJECT_NUMBERS");
+}
+
 #include "utils/stringUtils.h"
 
 //**************************************************************************************************
@@ -1028,7 +1038,7 @@ bool CConfigStorageMetadata::CreateMetadata()
 			"fileName VARCHAR(128) NOT NULL PRIMARY KEY,"
 			"attributes INTEGER,"
 			"dataSize INTEGER NOT NULL," 			//binary medatadata
-			"binaryData BLOB NOT NULL);", IConfigMetadata::GetConfigSaveTableName());         	//size of binary medatadata
+			"binaryData %s NOT NULL);", IConfigMetadata::GetConfigSaveTableName(), databaseLayer->GetDialect()->GetBlobType());         	//size of binary medatadata
 
 		databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s ("
 			"fileName);", IConfigMetadata::GetConfigSaveTableName(), IConfigMetadata::GetConfigSaveTableName());
@@ -1040,7 +1050,7 @@ bool CConfigStorageMetadata::CreateMetadata()
 			"fileName VARCHAR(128) NOT NULL PRIMARY KEY,"
 			"attributes INTEGER,"
 			"dataSize INTEGER NOT NULL," 			//binary medatadata
-			"binaryData BLOB NOT NULL);", GetConfigTableName());         	//size of binary medatadata
+			"binaryData %s NOT NULL);", GetConfigTableName(), databaseLayer->GetDialect()->GetBlobType());         	//size of binary medatadata
 
 		databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s ("
 			"fileName);", GetConfigTableName(), GetConfigTableName());
@@ -1051,7 +1061,7 @@ bool CConfigStorageMetadata::CreateMetadata()
 		databaseLayer->RunQuery("CREATE TABLE %s ("
 			"fileName VARCHAR(128) NOT NULL,"
 			"dataSize INTEGER NOT NULL," 			//binary medatadata
-			"binaryData BLOB NOT NULL);", GetCompileDataTableName());         	//size of binary medatadata
+			"binaryData %s NOT NULL);", GetCompileDataTableName(), databaseLayer->GetDialect()->GetBlobType());         	//size of binary medatadata
 
 		databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s ("
 			"fileName);", GetCompileDataTableName(), GetCompileDataTableName());
@@ -1065,7 +1075,7 @@ bool CConfigStorageMetadata::CreateMetadata()
 			"fullName          VARCHAR(128)  NOT NULL,"
 			"changed		   TIMESTAMP  NOT NULL,"
 			"dataSize          INTEGER       NOT NULL,"
-			"binaryData        BLOB      NOT NULL);", GetUsersTableName());
+			"binaryData        %s      NOT NULL);", GetUsersTableName(), databaseLayer->GetDialect()->GetBlobType());
 
 		databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s ("
 			"guid,"
@@ -1087,6 +1097,23 @@ bool CConfigStorageMetadata::CreateMetadata()
 			"userName);", GetActiveUsersTableName(), GetActiveUsersTableName());
 	}
 
+	// change counters of objects, read by the object cache of other sessions
+	if (!databaseLayer->TableExists(GetObjectChangesTableName())) {
+		databaseLayer->RunQuery("CREATE TABLE %s ("
+			"metaID            INTEGER       NOT NULL PRIMARY KEY,"
+			"generation        BIGINT        DEFAULT 0 NOT NULL);", GetObjectChangesTableName());
+	}
+
+	// counters of codes and numbers
+	if (!databaseLayer->TableExists(GetObjectNumbersTableName())) {
+		databaseLayer->RunQuery("CREATE TABLE %s ("
+			"metaID            INTEGER       NOT NULL,"
+			"prefix            VARCHAR(32)   DEFAULT '' NOT NULL,"
+			"period            VARCHAR(16)   DEFAULT '' NOT NULL,"
+			"lastNumber        NUMERIC(18)   DEFAULT 0 NOT NULL,"
+			"PRIMARY KEY (metaID, prefix, period));", GetObjectNumbersTableName());
+	}
+
 	//config params 
 	if (!databaseLayer->TableExists(GetConfigParamsTableName())) {
 		int retCode = databaseLayer->RunQuery("CREATE TABLE %s ("
@@ -1094,7 +1121,7 @@ bool CConfigStorageMetadata::CreateMetadata()
 			"guid              VARCHAR(36)   NOT NULL PRIMARY KEY,"
 			"name              VARCHAR(64)  NOT NULL,"
 			"dataSize          INTEGER    DEFAULT 0 NOT NULL,"
-			"binaryData        BLOB);", GetConfigParamsTableName());
+			"binaryData        %s);", GetConfigParamsTableName(), databaseLayer->GetDialect()->GetBlobType());
 
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 			return false;
@@ -1110,7 +1137,8 @@ bool CConfigStorageMetadata::CreateMetadata()
 	wxString constName =
 		CMetaConstantObject::GetTableNameDB();
 	if (!databaseLayer->TableExists(constName)) {
-		int retCode = databaseLayer->RunQuery("CREATE TABLE %s (RECORD_KEY CHAR DEFAULT '6');", constName);
+		//the key is unique, values are written by an upsert on it
+		int retCode = databaseLayer->RunQuery("CREATE TABLE %s (RECORD_KEY CHAR(1) DEFAULT '6' NOT NULL PRIMARY KEY);", constName);
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 			return false;
 		}
@@ -1203,8 +1231,14 @@ bool CConfigStorageMetadata::SaveMetadata(int flags)
 #endif
 	}
 
+	wxArrayString aColumns, aValues, aKeyColumns;
+	aColumns.Add(wxT("fileName")); aValues.Add(wxT("?"));
+	aColumns.Add(wxT("dataSize")); aValues.Add(wxT("?"));
+	aColumns.Add(wxT("binaryData")); aValues.Add(wxT("?"));
+	aKeyColumns.Add(wxT("fileName"));
+
 	PreparedStatement *prepStatement =
-		databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (fileName, dataSize, binaryData) VALUES(?, ?, ?) MATCHING (fileName); ", GetConfigSaveTableName());
+		databaseLayer->PrepareStatement(databaseLayer->GetDialect()->GetUpsert(GetConfigSaveTableName(), aColumns, aValues, aKeyColumns));
 
 	if (!prepStatement)
 		return false;
@@ -1266,6 +1300,45 @@ bool CConfigStorageMetadata::SaveMetadata(int flags)
 	return true;
 }
 
+#include "objects/baseObject.h"
+#include "objects/restructurePlan.h"
+
+bool CConfigStorageMetadata::GetRestructurePlan(CRestructurePlan &restructurePlan)
+{
+	if (!databaseLayer->IsOpen())
+		return false;
+
+	IMetaObject *commonObject = m_metaConfig->GetCommonMetaObject();
+	wxASSERT(commonObject);
+
+	//the same pairs of objects as in SaveMetadata
+	for (auto obj : commonObject->GetObjects()) {
+		IMetaObject *foundedMeta =
+			m_commonObject->FindByName(obj->GetDocPath());
+		IMetaObjectRefValue *refValue = NULL;
+		if (foundedMeta == NULL && obj->ConvertToValue(refValue)) {
+			refValue->PlanTableDB(NULL, restructurePlan, deleteMetaTable);
+		}
+	}
+
+	for (auto obj : m_commonObject->GetObjects()) {
+		IMetaObject *foundedMeta =
+			commonObject->FindByName(obj->GetDocPath());
+		IMetaObjectRefValue *refValue = NULL;
+		if (!obj->ConvertToValue(refValue))
+			continue;
+		if (foundedMeta == NULL) {
+			refValue->PlanTableDB(NULL, restructurePlan, createMetaTable);
+		}
+		else {
+			refValue->PlanTableDB(foundedMeta, restructurePlan, updateMetaTable);
+		}
+	}
+
+	restructurePlan.Estimate();
+	return true;
+}
+
 bool CConfigStorageMetadata::RoolbackToConfigDatabase()
 {
 	bool hasError =
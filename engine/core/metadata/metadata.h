@@ -6,6 +6,7 @@
 #include "metadata/metaObjects/metaObjectMetadata.h"
 
 class CDocument;
+class CRestructurePlan;
 
 #define metadata             (IConfigMetadata::Get())
 #define metadataCreate(mode) (IConfigMetadata::Initialize(mode))
@@ -163,6 +164,8 @@ public:
 	static wxString GetUsersTableName();
 	static wxString GetActiveUsersTableName();
 	static wxString GetConfigParamsTableName();
+	static wxString GetObjectChangesTableName();
+	static wxString GetObjectNumbersTableName();
 
 	//rollback to config db
 	virtual bool RoolbackToConfigDatabase() { return true; }
@@ -301,6 +304,9 @@ public:
 
 	virtual bool SaveMetadata(int flags = defaultFlag);
 
+	//dry run of the save: changes of the tables with the estimated rows
+	bool GetRestructurePlan(CRestructurePlan &restructurePlan);
+
 	//rollback to config db
 	virtual bool RoolbackToConfigDatabase();
 
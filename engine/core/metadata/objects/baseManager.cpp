@@ -33,6 +33,12 @@ enum
 	enExternalReports,
 };
 
+enum
+{
+	enImportConstants = 0,
+	enExportConstants,
+};
+
 void CSystemManager::PrepareNames() const
 {
 	SEng aAttributes[] =
@@ -49,6 +55,15 @@ void CSystemManager::PrepareNames() const
 
 	int nCountA = sizeof(aAttributes) / sizeof(aAttributes[0]);
 	m_methods->PrepareAttributes(aAttributes, nCountA);
+
+	SEng aMethods[] =
+	{
+		{"importConstants","importConstants(fileName)"},
+		{"exportConstants","exportConstants(fileName)"},
+	};
+
+	int nCountM = sizeof(aMethods) / sizeof(aMethods[0]);
+	m_methods->PrepareMethods(aMethods, nCountM);
 }
 
 #include "catalogManager.h"
@@ -146,6 +161,34 @@ CValue CSystemManager::GetAttribute(attributeArg_t &aParams)
 	return CValue();
 }
 
+#include "metadata/objects/objectDataTransfer.h"
+#include "compiler/systemObjects.h"
+#include "appData.h"
+
+CValue CSystemManager::Method(methodArg_t &aParams)
+{
+	if (!appData->EnterpriseMode())
+		return CValue();
+
+	CObjectDataTransfer dataTransfer(m_metaData);
+
+	switch (aParams.GetIndex())
+	{
+	case enImportConstants:
+		if (!dataTransfer.ImportData(aParams[0].GetString())) {
+			CSystemObjects::Raise(wxString::Format(_("Failed to import data from \"%s\""), aParams[0].GetString()));
+		}
+		break;
+	case enExportConstants:
+		if (!dataTransfer.ExportData(aParams[0].GetString())) {
+			CSystemObjects::Raise(wxString::Format(_("Failed to export data to \"%s\""), aParams[0].GetString()));
+		}
+		break;
+	}
+
+	return CValue();
+}
+
 //***********************************************************************
 //*                       Register in runtime                           *
 //***********************************************************************
@@ -17,6 +17,9 @@ public:
 	//attributes
 	virtual CValue GetAttribute(attributeArg_t &aParams);                   // 
 
+	//methods
+	virtual CValue Method(methodArg_t &aParams);
+
 	//types 
 	virtual wxString GetTypeString() const { return wxT("systemManager"); }
 	virtual wxString GetString() const { return wxT("systemManager"); }
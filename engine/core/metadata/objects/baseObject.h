@@ -18,10 +18,16 @@ class IDataObjectList;
 
 class IValueTabularSection;
 
+class CRestructurePlan;
+
 //special names 
 #define guidName wxT("UUID")
 #define guidRef wxT("UUIDREF")
 
+//column types: guids are kept as 16 bytes, references as bytes of reference_t
+#define guidType databaseLayer->GetDialect()->GetBinaryType(16)
+#define guidRefType databaseLayer->GetDialect()->GetBinaryType((int)sizeof(reference_t))
+
 enum
 {
 	METAOBJECT_NORMAL = 1,
@@ -201,9 +207,17 @@ public:
 		return NULL;
 	}
 
+	//get attribute for list order (scalar only) 
+	virtual IMetaAttributeObject *GetAttributeForSort() const {
+		return NULL;
+	}
+
 	//searched attributes 
 	virtual std::vector<IMetaAttributeObject *> GetSearchedAttributes() const = 0;
 
+	//attributes used by GetDescription, read without the rest of the row 
+	virtual std::vector<IMetaAttributeObject *> GetPresentationAttributes() const { return GetSearchedAttributes(); }
+
 	//support form 
 	virtual CValueForm *GetListForm(const wxString &formName = wxEmptyString, IValueFrame *ownerControl = NULL, const Guid &formGuid = Guid()) = 0;
 	virtual CValueForm *GetSelectForm(const wxString &formName = wxEmptyString, IValueFrame *ownerControl = NULL, const Guid &formGuid = Guid()) = 0;
@@ -217,6 +231,9 @@ public:
 	//create and update table 
 	virtual bool CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, IMetaObject *srcMetaObject, int flags);
 
+	//changes of the tables for the same flags, srcMetaObject is the saved object
+	virtual void PlanTableDB(IMetaObject *srcMetaObject, CRestructurePlan &restructurePlan, int flags);
+
 	//load & save metadata from DB 
 	virtual bool LoadData(CMemoryReader &reader) { return true; }
 	virtual bool SaveData(CMemoryWriter &writer = CMemoryWriter()) { return true; }
@@ -225,7 +242,18 @@ public:
 	//process default query
 	int ProcessAttribute(const wxString &tableName, IMetaAttributeObject *srcAttr, IMetaAttributeObject *dstAttr);
 	int ProcessEnumeration(const wxString &tableName, meta_identifier_t id, CMetaEnumerationObject *srcEnum, CMetaEnumerationObject *dstEnum);
-	int ProcessTable(const wxString &tabularName, CMetaTableObject *srcTable, CMetaTableObject *dstTable);
+	int ProcessTable(const wxString &tabularName, CMetaTableObject *srcTable, CMetaTableObject *dstTable, const CRestructurePlan *restructurePlan = NULL);
+
+	//tables of earlier versions keep guids as text and references as blobs
+	int ProcessStorage(const wxString &tableName, const std::vector<IMetaAttributeObject *> &aAttributes, const wxString &indexText, bool objectTable);
+	int ProcessBinaryColumn(const wxString &tableName, const wxString &fieldName, const wxString &sqlType, const wxString &convertText);
+
+	//secondary indexes: standard fields of the object table and attributes marked as indexed
+	int ProcessIndexes(const wxString &tableName, const std::vector<IMetaAttributeObject *> &aAttributes, bool objectTable);
+	int ProcessAttributeIndexes(const wxString &tableName, IMetaAttributeObject *attribute);
+
+	//changed columns of the table from the plan
+	int ProcessRestructure(const wxString &tableName, const CRestructurePlan &restructurePlan);
 
 protected:
 
@@ -378,8 +406,13 @@ protected:
 	class CCodeGenerator {
 		IMetaObjectRefValue *m_metaObject;
 		IMetaAttributeObject *m_metaAttribute;
+		//next value of the counter (metadata object, prefix, period)
+		number_t NextNumber(const wxString &prefix, const wxString &period) const;
+		//last number already used in the table, the counter starts from it
+		number_t ReadLastNumber(const wxString &prefix) const;
 	public:
-		CValue GenerateCode() const;
+		CValue GenerateCode(const wxString &prefix = wxEmptyString, const wxString &period = wxEmptyString) const;
+		bool IsUniqueCode(const CValue &code, const Guid &objGuid) const;
 		meta_identifier_t GetMetaID() const { return m_metaAttribute->GetMetaID(); }
 
 		CCodeGenerator(IMetaObjectRefValue *metaObject, IMetaAttributeObject *attribute) : m_metaObject(metaObject), m_metaAttribute(attribute) {}
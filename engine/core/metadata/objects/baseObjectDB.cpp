@@ -8,6 +8,10 @@
 #include "databaseLayer/databaseLayer.h"
 #include "databaseLayer/databaseErrorCodes.h"
 #include "metadata/objects/tabularSection/tabularSection.h"
+#include "metadata/objects/objectCache.h"
+#include "metadata/objects/objectRowMapper.h"
+#include "metadata/objects/restructurePlan.h"
+#include "compiler/systemObjects.h"
 #include "utils/stringUtils.h"
 
 //**********************************************************************************************************
@@ -23,24 +27,40 @@ wxString IMetaObjectRefValue::GetTableNameDB()
 
 int IMetaObjectRefValue::ProcessAttribute(const wxString &tableName, IMetaAttributeObject *srcAttr, IMetaAttributeObject *dstAttr) {
 
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
 	int retCode = 1;
 	//is null - create
 	if (dstAttr == NULL) {
 		wxString fieldName = srcAttr->GetFieldNameDB();
-		retCode = databaseLayer->RunQuery("ALTER TABLE %s ADD %s %s;", tableName, fieldName, srcAttr->GetSQLTypeObject());
+		retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, fieldName, srcAttr->GetSQLTypeObject()));
 	}
 	// update 
 	else if (srcAttr != NULL) {
 		if (srcAttr->GetTypeDescription() != dstAttr->GetTypeDescription()) {
 			wxString fieldName = srcAttr->GetFieldNameDB();
 			if (srcAttr->GetTypeObject() == dstAttr->GetTypeObject()) {
-				retCode = databaseLayer->RunQuery("ALTER TABLE %s ALTER COLUMN %s TYPE %s;", tableName, fieldName, srcAttr->GetSQLTypeObject());
+				wxString alterText = dialect->GetAlterColumnType(tableName, fieldName, srcAttr->GetSQLTypeObject());
+				if (!alterText.IsEmpty()) {
+					retCode = databaseLayer->RunQuery(alterText);
+				}
+				else {
+					//the type can not be changed in place, the values are copied
+					retCode = ProcessAttributeIndexes(tableName, dstAttr);
+					if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+						return retCode;
+					retCode = ProcessBinaryColumn(tableName, fieldName, srcAttr->GetSQLTypeObject(),
+						wxT("CAST(%s AS ") + srcAttr->GetSQLTypeObject() + wxT(")"));
+				}
 			}
 			else {
-				retCode = databaseLayer->RunQuery("ALTER TABLE %s DROP %s;", tableName, fieldName);
+				retCode = ProcessAttributeIndexes(tableName, dstAttr);
 				if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 					return retCode;
-				retCode = databaseLayer->RunQuery("ALTER TABLE %s ADD %s %s;", tableName, fieldName, srcAttr->GetSQLTypeObject());
+				retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
+				if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+					return retCode;
+				retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, fieldName, srcAttr->GetSQLTypeObject()));
 			}
 		}
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
@@ -49,23 +69,36 @@ int IMetaObjectRefValue::ProcessAttribute(const wxString &tableName, IMetaAttrib
 	//delete 
 	else if (srcAttr == NULL) {
 		wxString fieldName = dstAttr->GetFieldNameDB();
-		retCode = databaseLayer->RunQuery("ALTER TABLE %s DROP %s;", tableName, fieldName);
+		retCode = ProcessAttributeIndexes(tableName, dstAttr);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+		retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
 	}
 
 	return retCode;
 }
 
+//insert or update of the row with the guid of an enumeration
+static wxString GetEnumerationUpsert(const wxString &tableName)
+{
+	wxArrayString aColumns, aValues, aKeyColumns;
+	aColumns.Add(guidName); aValues.Add(wxT("?"));
+	aColumns.Add(guidRef); aValues.Add(wxT("?"));
+	aKeyColumns.Add(guidName);
+	return databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aKeyColumns);
+}
+
 int IMetaObjectRefValue::ProcessEnumeration(const wxString &tableName, meta_identifier_t id, CMetaEnumerationObject *srcEnum, CMetaEnumerationObject *dstEnum)
 {
 	int retCode = 1;
 	//is null - create
 	if (dstEnum == NULL) {	
 		PreparedStatement *prepareStatement = 
-			databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (UUID, UUIDREF) VALUES (?, ?) MATCHING(UUID);", tableName);	
+			databaseLayer->PrepareStatement(GetEnumerationUpsert(tableName));	
 		if (!prepareStatement)
 			return 0;
 		reference_t *reference_impl = new reference_t{ id, srcEnum->GetGuid()};
-		prepareStatement->SetParamString(1, srcEnum->GetGuid().str());
+		CObjectRowMapper::SetParamGuid(prepareStatement, 1, srcEnum->GetGuid());
 		prepareStatement->SetParamBlob(2, reference_impl, sizeof(reference_t));
 		retCode = prepareStatement->RunQuery();
 		delete reference_impl;
@@ -73,29 +106,29 @@ int IMetaObjectRefValue::ProcessEnumeration(const wxString &tableName, meta_iden
 	// update 
 	else if (srcEnum != NULL) {
 		PreparedStatement *prepareStatement = 
-			databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (UUID, UUIDREF) VALUES (?, ?) MATCHING(UUID);", tableName);
+			databaseLayer->PrepareStatement(GetEnumerationUpsert(tableName));
 		if (!prepareStatement)
 			return 0;
 		reference_t *reference_impl = new reference_t{ id, srcEnum->GetGuid() };
-		prepareStatement->SetParamString(1, srcEnum->GetGuid().str());
+		CObjectRowMapper::SetParamGuid(prepareStatement, 1, srcEnum->GetGuid());
 		prepareStatement->SetParamBlob(2, reference_impl, sizeof(reference_t));
 		retCode = prepareStatement->RunQuery();
 		delete reference_impl;
 	}
 	//delete 
 	else if (srcEnum == NULL) {
-		retCode = databaseLayer->RunQuery("DELETE FROM %s WHERE UUID = '%s' ;", tableName, dstEnum->GetGuid().str());
+		retCode = databaseLayer->RunQuery("DELETE FROM %s WHERE UUID = %s;", tableName, CObjectRowMapper::GetGuidLiteral(dstEnum->GetGuid()));
 	}
 
 	return retCode;
 }
 
-int IMetaObjectRefValue::ProcessTable(const wxString &tabularName, CMetaTableObject *srcTable, CMetaTableObject *dstTable)
+int IMetaObjectRefValue::ProcessTable(const wxString &tabularName, CMetaTableObject *srcTable, CMetaTableObject *dstTable, const CRestructurePlan *restructurePlan)
 {
 	int retCode = 1;
 	//is null - create
 	if (dstTable == NULL) {
-		retCode = databaseLayer->RunQuery("CREATE TABLE %s (UUID VARCHAR(36) NOT NULL, UUIDREF BLOB);", tabularName);
+		retCode = databaseLayer->RunQuery("CREATE TABLE %s (UUID %s NOT NULL, UUIDREF %s);", tabularName, guidType, guidRefType);
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) return retCode;
 		CMetaDefaultAttributeObject *attrNumberLine = srcTable->GetNumberLine();
 		wxASSERT(attrNumberLine);
@@ -104,17 +137,27 @@ int IMetaObjectRefValue::ProcessTable(const wxString &tabularName, CMetaTableObj
 			retCode = ProcessAttribute(tabularName,
 				attribute, NULL);
 		}
-		retCode = databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s (UUID, %s);", tabularName, tabularName, attrNumberLine->GetFieldNameDB());
+		//unique, rows are written by an upsert on these columns
+		retCode = databaseLayer->RunQuery(databaseLayer->GetDialect()->GetCreateIndex(tabularName + wxT("_INDEX"), tabularName,
+			wxString::Format(wxT("UUID, %s"), attrNumberLine->GetFieldNameDB()), true));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+		retCode = ProcessIndexes(tabularName, srcTable->GetObjectAttributes(), false);
 	}
 	// update 
 	else if (srcTable != NULL) {
-		for (auto attribute : srcTable->GetObjectAttributes()) {
-			retCode = ProcessAttribute(tabularName,
-				attribute, dstTable->FindAttributeByName(attribute->GetDocPath())
-			);
+		CMetaDefaultAttributeObject *attrNumberLine = srcTable->GetNumberLine();
+		wxASSERT(attrNumberLine);
+		retCode = ProcessStorage(tabularName, dstTable->GetObjectAttributes(),
+			wxString::Format(wxT("UUID, %s"), attrNumberLine->GetFieldNameDB()), false);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+		if (restructurePlan != NULL) {
+			retCode = ProcessRestructure(tabularName, *restructurePlan);
 			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 				return retCode;
 		}
+		retCode = ProcessIndexes(tabularName, srcTable->GetObjectAttributes(), false);
 	}
 	//delete 
 	else if (srcTable == NULL) {
@@ -124,6 +167,425 @@ int IMetaObjectRefValue::ProcessTable(const wxString &tabularName, CMetaTableObj
 	return retCode;
 }
 
+//RDB$FIELD_TYPE of every column of the table by the column name in upper case
+static std::map<wxString, short> GetFieldTypesDB(const wxString &tableName)
+{
+	std::map<wxString, short> aFieldTypes;
+
+	DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT R.RDB$FIELD_NAME AS fieldName, F.RDB$FIELD_TYPE AS fieldType "
+		"FROM RDB$RELATION_FIELDS R JOIN RDB$FIELDS F ON F.RDB$FIELD_NAME = R.RDB$FIELD_SOURCE "
+		"WHERE R.RDB$RELATION_NAME = '%s';", tableName.Upper());
+
+	if (resultSet == NULL)
+		return aFieldTypes;
+
+	while (resultSet->Next()) {
+		aFieldTypes.insert_or_assign(resultSet->GetResultString(wxT("fieldName")).Trim(), resultSet->GetResultInt(wxT("fieldType")));
+	}
+
+	resultSet->Close();
+	return aFieldTypes;
+}
+
+#define fieldTypeVarying 37
+#define fieldTypeBlob 261
+
+//the column still has the old type, or a copy interrupted by a restart has left its new column
+static bool IsColumnPending(const std::map<wxString, short> &aFieldTypes, const wxString &fieldName, short fieldType)
+{
+	if (aFieldTypes.find(fieldName.Upper() + wxT("_BIN")) != aFieldTypes.end())
+		return true;
+
+	auto foundedType = aFieldTypes.find(fieldName.Upper());
+	return foundedType != aFieldTypes.end() && foundedType->second == fieldType;
+}
+
+int IMetaObjectRefValue::ProcessStorage(const wxString &tableName, const std::vector<IMetaAttributeObject *> &aAttributes, const wxString &indexText, bool objectTable)
+{
+	//string guids were only kept by firebird databases
+	if (databaseLayer->GetDialect()->GetDialectType() != DATABASE_DIALECT_FIREBIRD)
+		return 1;
+
+	std::map<wxString, short> aFieldTypes = GetFieldTypesDB(tableName);
+
+	bool guidPending = IsColumnPending(aFieldTypes, guidName, fieldTypeVarying);
+	bool refPending = IsColumnPending(aFieldTypes, guidRef, fieldTypeBlob);
+	std::vector<IMetaAttributeObject *> aPendingAttributes;
+	for (auto attribute : aAttributes) {
+		if (IsColumnPending(aFieldTypes, attribute->GetFieldNameDB(), fieldTypeBlob)) {
+			aPendingAttributes.push_back(attribute);
+		}
+	}
+
+	//nothing to do for tables created with binary guids or converted completely
+	if (!guidPending && !refPending && aPendingAttributes.empty())
+		return 1;
+
+	int retCode = 1;
+
+	//the key and the indexes on UUID go before the column
+	if (objectTable) {
+		wxString constraintName;
+		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT RDB$CONSTRAINT_NAME AS constraintName "
+			"FROM RDB$RELATION_CONSTRAINTS WHERE RDB$RELATION_NAME = '%s' AND RDB$CONSTRAINT_TYPE = 'PRIMARY KEY';", tableName.Upper());
+		if (resultSet != NULL) {
+			if (resultSet->Next()) {
+				constraintName = resultSet->GetResultString(wxT("constraintName")).Trim();
+			}
+			resultSet->Close();
+		}
+		if (!constraintName.IsEmpty()) {
+			retCode = databaseLayer->RunQuery("ALTER TABLE %s DROP CONSTRAINT %s;", tableName, constraintName);
+			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+				return retCode;
+		}
+	}
+
+	wxArrayString aIndexes = databaseLayer->GetIndexes(tableName);
+	if (aIndexes.Index(tableName.Upper() + wxT("_INDEX"), false) != wxNOT_FOUND) {
+		retCode = databaseLayer->RunQuery("DROP INDEX %s_INDEX;", tableName);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+	if (aIndexes.Index(tableName.Upper() + wxT("_SORT"), false) != wxNOT_FOUND) {
+		retCode = databaseLayer->RunQuery("DROP INDEX %s_SORT;", tableName);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	if (guidPending) {
+		retCode = ProcessBinaryColumn(tableName, guidName, guidType, wxT("CHAR_TO_UUID(%s)"));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+		retCode = databaseLayer->RunQuery("ALTER TABLE %s ALTER UUID SET NOT NULL;", tableName);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	//references keep their bytes, only the column type changes
+	if (refPending) {
+		wxString castText = wxT("CAST(%s AS ") + guidRefType + wxT(")");
+		retCode = ProcessBinaryColumn(tableName, guidRef, guidRefType, castText);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	for (auto attribute : aPendingAttributes) {
+		wxString fieldName = attribute->GetFieldNameDB();
+		retCode = ProcessBinaryColumn(tableName, fieldName, attribute->GetSQLTypeObject(),
+			wxT("CAST(%s AS ") + attribute->GetSQLTypeObject() + wxT(")"));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	if (objectTable) {
+		retCode = databaseLayer->RunQuery("ALTER TABLE %s ADD PRIMARY KEY (UUID);", tableName);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	retCode = databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s (%s);", tableName, tableName, indexText);
+	if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+		return retCode;
+
+	IMetaAttributeObject *sortAttribute = objectTable ? GetAttributeForSort() : NULL;
+	if (sortAttribute != NULL) {
+		retCode = databaseLayer->RunQuery("CREATE INDEX %s_SORT ON %s (%s, UUID);", tableName, tableName, sortAttribute->GetFieldNameDB());
+	}
+
+	return retCode;
+}
+
+int IMetaObjectRefValue::ProcessBinaryColumn(const wxString &tableName, const wxString &fieldName, const wxString &sqlType, const wxString &convertText)
+{
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
+	//the values are copied into a new column, which then takes the name of the old one
+	wxString binaryName = fieldName + wxT("_BIN");
+
+	//every step is committed on its own, a copy interrupted by a restart goes on from the columns it has left:
+	//both columns - the copy is repeated, only the new one - the old column is already dropped
+	wxArrayString aColumns = databaseLayer->GetColumns(tableName);
+	bool hasField = aColumns.Index(fieldName, false) != wxNOT_FOUND;
+	bool hasBinary = aColumns.Index(binaryName, false) != wxNOT_FOUND;
+
+	int retCode = 1;
+	if (!hasBinary) {
+		retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, binaryName, sqlType));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+	if (hasField || !hasBinary) {
+		retCode = databaseLayer->RunQuery("UPDATE %s SET %s = %s;", tableName, binaryName, wxString::Format(convertText, fieldName));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+		retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+	return databaseLayer->RunQuery(dialect->GetRenameColumn(tableName, binaryName, fieldName));
+}
+
+int IMetaObjectRefValue::ProcessIndexes(const wxString &tableName, const std::vector<IMetaAttributeObject *> &aAttributes, bool objectTable)
+{
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
+	//index name -> create statement
+	std::map<wxString, wxString> aIndexes;
+
+	if (objectTable) {
+		//list order and range selections (document date) 
+		IMetaAttributeObject *sortAttribute = GetAttributeForSort();
+		if (sortAttribute != NULL) {
+			wxString indexName = tableName.Upper() + wxT("_SORT");
+			aIndexes.insert_or_assign(indexName,
+				dialect->GetCreateIndex(indexName, tableName, wxString::Format(wxT("%s, UUID"), sortAttribute->GetFieldNameDB())));
+		}
+		//uniqueness check and search of codes and numbers
+		IMetaAttributeObject *codeAttribute = GetAttributeForCode();
+		if (codeAttribute != NULL) {
+			wxString indexName = tableName.Upper() + wxT("_CODE");
+			aIndexes.insert_or_assign(indexName,
+				dialect->GetCreateIndex(indexName, tableName, codeAttribute->GetFieldNameDB()));
+		}
+		//input by string and search by name (without case)
+		for (auto attribute : GetSearchedAttributes()) {
+			if (attribute->GetTypeObject() != eValueTypes::TYPE_STRING)
+				continue;
+			wxString indexName = wxString::Format(wxT("%s_SEARCH%i"), tableName.Upper(), attribute->GetMetaID());
+			aIndexes.insert_or_assign(indexName,
+				dialect->GetCreateExpressionIndex(indexName, tableName, wxString::Format(wxT("UPPER(%s)"), attribute->GetFieldNameDB())));
+		}
+	}
+
+	for (auto attribute : aAttributes) {
+		if (!attribute->IsIndexed())
+			continue;
+		wxString indexName = wxString::Format(wxT("%s_IDX%i"), tableName.Upper(), attribute->GetMetaID());
+		aIndexes.insert_or_assign(indexName,
+			dialect->GetCreateIndex(indexName, tableName, attribute->GetFieldNameDB()));
+	}
+
+	int retCode = 1;
+
+	wxArrayString aExistIndexes = databaseLayer->GetIndexes(tableName);
+
+	//drop generated indexes the metadata no longer has, others are left alone
+	wxString prefix = tableName.Upper() + wxT("_");
+	for (auto indexName : aExistIndexes) {
+		wxString suffix;
+		if (!indexName.Upper().StartsWith(prefix, &suffix))
+			continue;
+		if (suffix != wxT("SORT") && suffix != wxT("CODE") && !suffix.StartsWith(wxT("SEARCH")) && !suffix.StartsWith(wxT("IDX")))
+			continue;
+		if (aIndexes.find(indexName.Upper()) != aIndexes.end())
+			continue;
+		retCode = databaseLayer->RunQuery(dialect->GetDropIndex(indexName, tableName));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	for (auto &index : aIndexes) {
+		if (aExistIndexes.Index(index.first, false) != wxNOT_FOUND)
+			continue;
+		retCode = databaseLayer->RunQuery(index.second);
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	return retCode;
+}
+
+int IMetaObjectRefValue::ProcessAttributeIndexes(const wxString &tableName, IMetaAttributeObject *attribute)
+{
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
+	//the column can not be dropped while an index uses it
+	wxArrayString aExistIndexes = databaseLayer->GetIndexes(tableName);
+
+	int retCode = 1;
+
+	wxString indexName = wxString::Format(wxT("%s_IDX%i"), tableName.Upper(), attribute->GetMetaID());
+	if (aExistIndexes.Index(indexName, false) != wxNOT_FOUND) {
+		retCode = databaseLayer->RunQuery(dialect->GetDropIndex(indexName, tableName));
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	indexName = wxString::Format(wxT("%s_SEARCH%i"), tableName.Upper(), attribute->GetMetaID());
+	if (aExistIndexes.Index(indexName, false) != wxNOT_FOUND) {
+		retCode = databaseLayer->RunQuery(dialect->GetDropIndex(indexName, tableName));
+	}
+
+	return retCode;
+}
+
+int IMetaObjectRefValue::ProcessRestructure(const wxString &tableName, const CRestructurePlan &restructurePlan)
+{
+	const CRestructurePlan::table_t *table = restructurePlan.FindTable(tableName);
+	if (table == NULL)
+		return 1;
+
+	if (table->m_action != CRestructurePlan::eTableAlter && table->m_action != CRestructurePlan::eTableRebuild)
+		return 1;
+
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
+	int retCode = 1;
+
+	if (table->m_action == CRestructurePlan::eTableRebuild) {
+		CSystemObjects::SetStatus(wxString::Format(_("Restructuring %s: adding columns"), table->m_objectName));
+
+		//the server applies DDL on commit, new columns are filled after they are committed
+		std::vector<wxString> aShadowNames;
+		wxString setText;
+
+		for (auto &column : table->m_aColumns) {
+			if (column.m_action != CRestructurePlan::eColumnRebuild)
+				continue;
+			wxString shadowName = column.m_fieldName + wxT("_NEW");
+			retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, shadowName, column.m_newType));
+			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+				break;
+			aShadowNames.push_back(shadowName);
+			wxString convertText = column.m_convertText;
+			convertText.Replace(wxT("%s"), column.m_fieldName);
+			if (!setText.IsEmpty())
+				setText += wxT(", ");
+			setText += wxString::Format(wxT("%s = %s"), shadowName, convertText);
+		}
+
+		//all rows are converted by one statement in one transaction
+		if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR) {
+			CSystemObjects::SetStatus(wxString::Format(_("Restructuring %s: copying values"), table->m_objectName));
+			databaseLayer->BeginWrite();
+			retCode = databaseLayer->RunQuery("UPDATE %s SET %s;", tableName, setText);
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR) {
+				databaseLayer->CommitWrite();
+			}
+			else {
+				databaseLayer->RollBackWrite();
+			}
+		}
+
+		//the table is left as it was
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) {
+			for (auto &shadowName : aShadowNames) {
+				databaseLayer->RunQuery(dialect->GetDropColumn(tableName, shadowName));
+			}
+			CSystemObjects::Message(wxString::Format(_("Values of %s can not be converted, the table is not changed"), table->m_objectName),
+				eStatusMessage::eStatusMessage_Error);
+			return retCode;
+		}
+	}
+
+	CSystemObjects::SetStatus(wxString::Format(_("Restructuring %s: changing columns"), table->m_objectName));
+
+	for (auto &column : table->m_aColumns) {
+		switch (column.m_action)
+		{
+		case CRestructurePlan::eColumnAdd:
+			retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, column.m_fieldName, column.m_newType));
+			break;
+		case CRestructurePlan::eColumnAlter:
+			retCode = databaseLayer->RunQuery(dialect->GetAlterColumnType(tableName, column.m_fieldName, column.m_newType));
+			break;
+		case CRestructurePlan::eColumnRebuild:
+			retCode = ProcessAttributeIndexes(tableName, column.m_oldAttribute);
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+				retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, column.m_fieldName));
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+				retCode = databaseLayer->RunQuery(dialect->GetRenameColumn(tableName, column.m_fieldName + wxT("_NEW"), column.m_fieldName));
+			break;
+		case CRestructurePlan::eColumnReplace:
+			retCode = ProcessAttributeIndexes(tableName, column.m_oldAttribute);
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+				retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, column.m_fieldName));
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+				retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, column.m_fieldName, column.m_newType));
+			break;
+		case CRestructurePlan::eColumnDrop:
+			retCode = ProcessAttributeIndexes(tableName, column.m_oldAttribute);
+			if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+				retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, column.m_fieldName));
+			break;
+		}
+
+		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+			return retCode;
+	}
+
+	return retCode;
+}
+
+//columns of a table, srcObject is the new object and dstObject the saved one
+template <typename objectType>
+static std::vector<CRestructurePlan::column_t> PlanColumns(objectType *srcObject, objectType *dstObject)
+{
+	std::vector<CRestructurePlan::column_t> aColumns;
+
+	for (auto attribute : dstObject->GetObjectAttributes()) {
+		CRestructurePlan::column_t column;
+		if (srcObject->FindAttributeByName(attribute->GetDocPath()) == NULL
+			&& CRestructurePlan::PlanColumn(NULL, attribute, column)) {
+			aColumns.push_back(column);
+		}
+	}
+
+	for (auto attribute : srcObject->GetObjectAttributes()) {
+		CRestructurePlan::column_t column;
+		if (CRestructurePlan::PlanColumn(attribute, dstObject->FindAttributeByName(attribute->GetDocPath()), column)) {
+			aColumns.push_back(column);
+		}
+	}
+
+	return aColumns;
+}
+
+void IMetaObjectRefValue::PlanTableDB(IMetaObject *srcMetaObject, CRestructurePlan &restructurePlan, int flags)
+{
+	wxString tableName = GetTableNameDB();
+
+	if ((flags & createMetaTable) != 0) {
+		restructurePlan.AddTable(tableName, GetName(), CRestructurePlan::eTableCreate);
+		for (auto table : GetObjectTables()) {
+			restructurePlan.AddTable(table->GetTableNameDB(), GetName() + wxT(".") + table->GetName(), CRestructurePlan::eTableCreate);
+		}
+	}
+	else if ((flags & updateMetaTable) != 0) {
+		IMetaObjectRefValue *dstValue = NULL;
+		if (srcMetaObject->ConvertToValue(dstValue)) {
+			restructurePlan.AddTable(tableName, GetName(), CRestructurePlan::eTableAlter,
+				PlanColumns<IMetaObjectRefValue>(this, dstValue)
+			);
+			//tables from dst 
+			for (auto table : dstValue->GetObjectTables()) {
+				if (IMetaObjectRefValue::FindTableByName(table->GetDocPath()) == NULL) {
+					restructurePlan.AddTable(table->GetTableNameDB(), GetName() + wxT(".") + table->GetName(), CRestructurePlan::eTableDrop);
+				}
+			}
+			//tables current 
+			for (auto table : GetObjectTables()) {
+				CMetaTableObject *dstTable = dstValue->FindTableByName(table->GetDocPath());
+				if (dstTable != NULL) {
+					restructurePlan.AddTable(table->GetTableNameDB(), GetName() + wxT(".") + table->GetName(), CRestructurePlan::eTableAlter,
+						PlanColumns<CMetaTableObject>(table, dstTable)
+					);
+				}
+				else {
+					restructurePlan.AddTable(table->GetTableNameDB(), GetName() + wxT(".") + table->GetName(), CRestructurePlan::eTableCreate);
+				}
+			}
+		}
+	}
+	else if ((flags & deleteMetaTable) != 0) {
+		restructurePlan.AddTable(tableName, GetName(), CRestructurePlan::eTableDrop);
+		for (auto table : GetObjectTables()) {
+			restructurePlan.AddTable(table->GetTableNameDB(), GetName() + wxT(".") + table->GetName(), CRestructurePlan::eTableDrop);
+		}
+	}
+}
+
 bool IMetaObjectRefValue::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, IMetaObject *srcMetaObject, int flags)
 {
 	wxString tableName = GetTableNameDB();
@@ -131,7 +593,7 @@ bool IMetaObjectRefValue::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 	int retCode = DATABASE_LAYER_QUERY_RESULT_ERROR;
 
 	if ((flags & createMetaTable) != 0) {
-		retCode = databaseLayer->RunQuery("CREATE TABLE %s (UUID VARCHAR(36) NOT NULL PRIMARY KEY, UUIDREF BLOB);", tableName);
+		retCode = databaseLayer->RunQuery("CREATE TABLE %s (UUID %s NOT NULL PRIMARY KEY, UUIDREF %s);", tableName, guidType, guidRefType);
 		for (auto attribute : GetObjectAttributes()) {
 			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 				return false;
@@ -142,11 +604,13 @@ bool IMetaObjectRefValue::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 			return false;
 
-		retCode = databaseLayer->RunQuery("CREATE INDEX %s_INDEX ON %s (UUID);", tableName, tableName);
+		retCode = databaseLayer->RunQuery(databaseLayer->GetDialect()->GetCreateIndex(tableName + wxT("_INDEX"), tableName, guidName));
 
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 			return false;
 
+		retCode = ProcessIndexes(tableName, GetObjectAttributes(), true);
+
 		for (auto enumeration : GetObjectEnums()) {
 			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 				return false;
@@ -168,24 +632,21 @@ bool IMetaObjectRefValue::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 		//if src is null then delete
 		IMetaObjectRefValue *dstValue = NULL;
 		if (srcMetaObject->ConvertToValue(dstValue)) {
-			//attributes from dst 
-			for (auto attribute : dstValue->GetObjectAttributes()) {
-				IMetaObject *foundedMeta =
-					IMetaObjectRefValue::FindAttributeByName(attribute->GetDocPath());
-				if (foundedMeta == NULL) {
-					retCode = ProcessAttribute(tableName, NULL, attribute);
-					if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
-						return false;
-				}
-			}
-			//attributes current
-			for (auto attribute : GetObjectAttributes()) {
-				retCode = ProcessAttribute(tableName,
-					attribute, dstValue->FindAttributeByName(attribute->GetDocPath())
-				);
-				if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
-					return false;
-			}
+			//binary guids and references
+			retCode = ProcessStorage(tableName, dstValue->GetObjectAttributes(), guidName, true);
+			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+				return false;
+			//added, changed and dropped columns of the object and its tables
+			CRestructurePlan restructurePlan;
+			PlanTableDB(srcMetaObject, restructurePlan, updateMetaTable);
+
+			retCode = ProcessRestructure(tableName, restructurePlan);
+			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+				return false;
+
+			retCode = ProcessIndexes(tableName, GetObjectAttributes(), true);
+			if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
+				return false;
 
 			//enums from dst 
 			for (auto enumeration : dstValue->GetObjectEnums()) {
@@ -219,7 +680,7 @@ bool IMetaObjectRefValue::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 			//tables current 
 			for (auto table : GetObjectTables()) {
 				retCode = ProcessTable(table->GetTableNameDB(),
-					table, dstValue->FindTableByName(table->GetDocPath())
+					table, dstValue->FindTableByName(table->GetDocPath()), &restructurePlan
 				);
 				if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR)
 					return false;
@@ -254,7 +715,7 @@ bool IDataObjectRefValue::ReadInDB()
 	wxString tableName = m_metaObject->GetTableNameDB();
 
 	if (databaseLayer->TableExists(tableName)) {
-		wxString queryText = "SELECT FIRST 1 * FROM " + tableName + " WHERE UUID = '" + m_objGuid.str() + "';";
+		wxString queryText = databaseLayer->GetDialect()->GetSelectLimit("* FROM " + tableName + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_objGuid), 1) + ";";
 		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(queryText);
 		if (!resultSet) {
 			return false;
@@ -267,36 +728,9 @@ bool IDataObjectRefValue::ReadInDB()
 		}
 		if (resultSet->Next()) {
 			//load other attributes 
-			for (auto attribute : m_metaObject->GetObjectAttributes()) {
-				wxString nameAttribute = attribute->GetFieldNameDB();
-				switch (attribute->GetTypeObject())
-				{
-				case eValueTypes::TYPE_BOOLEAN:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultBool(nameAttribute); break;
-				case eValueTypes::TYPE_NUMBER:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultNumber(nameAttribute); break;
-				case eValueTypes::TYPE_DATE:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultDate(nameAttribute); break;
-				case eValueTypes::TYPE_STRING:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultString(nameAttribute); break;
-				default:
-				{
-					wxMemoryBuffer bufferData;
-					resultSet->GetResultBlob(nameAttribute, bufferData);
-					if (!bufferData.IsEmpty()) {
-						m_aObjectValues[attribute->GetMetaID()] = CValueReference::CreateFromPtr(
-							m_metaObject->GetMetadata(), bufferData.GetData()
-						);
-					}
-					else {
-						m_aObjectValues[attribute->GetMetaID()] = new CValueReference(
-							m_metaObject->GetMetadata(), attribute->GetTypeObject()
-						);
-					}
-					break;
-				}
-				}
-			}
+			CObjectRowMapper rowMapper(m_metaObject->GetMetadata(), m_metaObject->GetObjectAttributes());
+			rowMapper.Prepare(resultSet);
+			rowMapper.ReadRow(resultSet, m_aObjectValues);
 			for (auto tabularSection : m_aObjectTables) {
 				tabularSection->LoadDataFromDB();
 			}
@@ -313,9 +747,51 @@ bool IDataObjectRefValue::SaveInDB()
 {
 	wxASSERT(m_metaObject);
 
+	//header and tabular sections are written in one transaction, unless the caller has already opened it
+	const bool ownWrite = !databaseLayer->IsWriteActive();
+
+	if (ownWrite) {
+		databaseLayer->BeginWrite();
+	}
+
+	//the code is taken inside the write, so the counter rolls back together with the object
+	bool generatedCode = false;
+	CValue emptyCode;
+
 	if (m_codeGenerator) {
-		if (m_aObjectValues[m_codeGenerator->GetMetaID()].IsEmpty()) {
-			m_aObjectValues[m_codeGenerator->GetMetaID()] = m_codeGenerator->GenerateCode();
+		meta_identifier_t codeID = m_codeGenerator->GetMetaID();
+		bool codeCheck = true;
+		if (m_aObjectValues[codeID].IsEmpty()) {
+			emptyCode = m_aObjectValues[codeID];
+			m_aObjectValues[codeID] = m_codeGenerator->GenerateCode();
+			generatedCode = true;
+		}
+		//a code entered by hand may already hold the next number of the counter
+		while (!m_codeGenerator->IsUniqueCode(m_aObjectValues[codeID], m_objGuid)) {
+			if (!generatedCode) {
+				wxString codeError =
+					wxString::Format(_("""%s"" is not unique"), m_metaObject->GetAttributeForCode()->GetSynonym());
+				CSystemObjects::Message(codeError, eStatusMessage::eStatusMessage_Information);
+				codeCheck = false;
+				break;
+			}
+			m_aObjectValues[codeID] = m_codeGenerator->GenerateCode();
+		}
+		//the counter could not be advanced
+		if (codeCheck && generatedCode && m_aObjectValues[codeID].IsEmpty()) {
+			wxString codeError =
+				wxString::Format(_("Failed to get the next number for ""%s"""), m_metaObject->GetAttributeForCode()->GetSynonym());
+			CSystemObjects::Message(codeError, eStatusMessage::eStatusMessage_Information);
+			codeCheck = false;
+		}
+		if (!codeCheck) {
+			if (generatedCode) {
+				m_aObjectValues[codeID] = emptyCode;
+			}
+			if (ownWrite) {
+				databaseLayer->RollBackWrite();
+			}
+			return false;
 		}
 	}
 
@@ -334,40 +810,53 @@ bool IDataObjectRefValue::SaveInDB()
 	}
 
 	if (!fillCheck) {
+		//the number goes back to the counter with the rollback
+		if (generatedCode) {
+			m_aObjectValues[m_codeGenerator->GetMetaID()] = emptyCode;
+		}
+		if (ownWrite) {
+			databaseLayer->RollBackWrite();
+		}
 		return false; 
 	}
 
 	wxString tableName = m_metaObject->GetTableNameDB();
-	wxString queryText = "UPDATE OR INSERT INTO " + tableName + " (";
-	queryText += "UUID, UUIDREF";
+	wxArrayString aColumns, aValues, aKeyColumns;
+	aColumns.Add(guidName); aValues.Add(wxT("?"));
+	aColumns.Add(guidRef); aValues.Add(wxT("?"));
 	for (auto attribute : m_metaObject->GetObjectAttributes()) {
-		queryText = queryText + ", " + attribute->GetFieldNameDB();
-
-	}
-	queryText += ") VALUES (?, ?";
-	for (auto attribute : m_metaObject->GetObjectAttributes()) {
-		queryText += ", ?";
-	}
-	queryText += ") MATCHING (UUID);";
-	PreparedStatement *statement = databaseLayer->PrepareStatement(queryText);
-	if (!statement) {
-		return false;
+		aColumns.Add(attribute->GetFieldNameDB()); aValues.Add(wxT("?"));
 	}
+	aKeyColumns.Add(guidName);
+	wxString queryText = databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aKeyColumns);
 
-	m_objGuid = m_reference_impl->m_guid;
+	bool hasError = false;
 
-	statement->SetParamString(1, m_objGuid.str());
-	statement->SetParamBlob(2, m_reference_impl, sizeof(reference_t));
+	{
+		DatabaseStatementLocker statement(databaseLayer, queryText);
+		if (!statement.IsOk()) {
+			if (generatedCode) {
+				m_aObjectValues[m_codeGenerator->GetMetaID()] = emptyCode;
+			}
+			if (ownWrite) {
+				databaseLayer->RollBackWrite();
+			}
+			return false;
+		}
 
-	int position = 3;
+		m_objGuid = m_reference_impl->m_guid;
 
-	for (auto attribute : m_metaObject->GetObjectAttributes()) {
-		m_aObjectValues[attribute->GetMetaID()].SetBinaryData(position++, statement);
-	}
+		CObjectRowMapper::SetParamGuid(statement.GetStatement(), 1, m_objGuid);
+		statement->SetParamBlob(2, m_reference_impl, sizeof(reference_t));
 
-	bool hasError = statement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR;
+		int position = 3;
 
-	databaseLayer->CloseStatement(statement);
+		for (auto attribute : m_metaObject->GetObjectAttributes()) {
+			m_aObjectValues[attribute->GetMetaID()].SetBinaryData(position++, statement.GetStatement());
+		}
+
+		hasError = statement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR;
+	}
 
 	//table parts
 	if (!hasError) {
@@ -378,9 +867,25 @@ bool IDataObjectRefValue::SaveInDB()
 		}
 	}
 
+	if (!hasError) {
+		objectCache->Invalidate(m_metaObject->GetMetaID(), m_objGuid);
+	}
+
+	if (ownWrite) {
+		if (hasError) {
+			databaseLayer->RollBackWrite();
+		}
+		else {
+			databaseLayer->CommitWrite();
+		}
+	}
+
 	if (!hasError) {
 		m_bNewObject = false;
 	}
+	else if (generatedCode) {
+		m_aObjectValues[m_codeGenerator->GetMetaID()] = emptyCode;
+	}
 
 	return !hasError;
 }
@@ -390,8 +895,14 @@ bool IDataObjectRefValue::DeleteInDB()
 	if (m_bNewObject)
 		return false;
 
+	const bool ownWrite = !databaseLayer->IsWriteActive();
+
+	if (ownWrite) {
+		databaseLayer->BeginWrite();
+	}
+
 	wxString tableName = m_metaObject->GetTableNameDB();
-	bool hasError = databaseLayer->RunQuery("DELETE FROM " + tableName + " WHERE UUID = '" + m_objGuid.str() + "';") == DATABASE_LAYER_QUERY_RESULT_ERROR;
+	bool hasError = databaseLayer->RunQuery("DELETE FROM " + tableName + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_objGuid) + ";") == DATABASE_LAYER_QUERY_RESULT_ERROR;
 
 	//table parts
 	for (auto table : m_aObjectTables) {
@@ -400,6 +911,19 @@ bool IDataObjectRefValue::DeleteInDB()
 		}
 	}
 
+	if (!hasError) {
+		objectCache->Invalidate(m_metaObject->GetMetaID(), m_objGuid);
+	}
+
+	if (ownWrite) {
+		if (hasError) {
+			databaseLayer->RollBackWrite();
+		}
+		else {
+			databaseLayer->CommitWrite();
+		}
+	}
+
 	return !hasError;
 }
 
@@ -410,53 +934,179 @@ bool IDataObjectRefValue::DeleteInDB()
 //*                                          Code generator												   *
 //**********************************************************************************************************
 
-CValue IDataObjectRefValue::CCodeGenerator::GenerateCode() const
+#define nextNumberAttempts 5
+
+number_t IDataObjectRefValue::CCodeGenerator::NextNumber(const wxString &prefix, const wxString &period) const
+{
+	number_t number = 0;
+
+	//the row of the counter stays locked until the end of the write
+	bool ownWrite = !databaseLayer->IsWriteActive();
+	if (ownWrite) {
+		databaseLayer->BeginWrite();
+	}
+
+	wxString tableName = IConfigMetadata::GetObjectNumbersTableName();
+
+	//transactions are read committed, so a retry sees the row changed or inserted by another session
+	for (int attempt = 0; attempt < nextNumberAttempts; attempt++) {
+		PreparedStatement *statement = databaseLayer->PrepareStatement("UPDATE %s SET lastNumber = lastNumber + 1 WHERE metaID = ? AND prefix = ? AND period = ?;", tableName);
+		if (statement == NULL)
+			break;
+		statement->SetParamInt(1, m_metaObject->GetMetaID());
+		statement->SetParamString(2, prefix);
+		statement->SetParamString(3, period);
+		int retCode = statement->RunQuery();
+		//zero rows and an error share the same return code
+		bool updateFailed = statement->GetErrorCode() != DATABASE_LAYER_OK;
+		databaseLayer->CloseStatement(statement);
+
+		//update conflict with another session
+		if (updateFailed)
+			continue;
+
+		//first number of the scope
+		if (retCode == 0) {
+			statement = databaseLayer->PrepareStatement("INSERT INTO %s (metaID, prefix, period, lastNumber) VALUES (?, ?, ?, ?);", tableName);
+			if (statement == NULL)
+				break;
+			statement->SetParamInt(1, m_metaObject->GetMetaID());
+			statement->SetParamString(2, prefix);
+			statement->SetParamString(3, period);
+			statement->SetParamNumber(4, ReadLastNumber(prefix) + 1);
+			statement->RunQuery();
+			bool insertFailed = statement->GetErrorCode() != DATABASE_LAYER_OK;
+			databaseLayer->CloseStatement(statement);
+			//another session has inserted it a moment ago
+			if (insertFailed)
+				continue;
+		}
+
+		statement = databaseLayer->PrepareStatement("SELECT lastNumber FROM %s WHERE metaID = ? AND prefix = ? AND period = ?;", tableName);
+		if (statement == NULL)
+			break;
+		statement->SetParamInt(1, m_metaObject->GetMetaID());
+		statement->SetParamString(2, prefix);
+		statement->SetParamString(3, period);
+		DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+		if (resultSet) {
+			if (resultSet->Next()) {
+				number = resultSet->GetResultNumber(wxT("lastNumber"));
+			}
+			resultSet->Close();
+		}
+		databaseLayer->CloseStatement(statement);
+		break;
+	}
+
+	if (ownWrite) {
+		if (number.IsZero()) {
+			databaseLayer->RollBackWrite();
+		}
+		else {
+			databaseLayer->CommitWrite();
+		}
+	}
+
+	return number;
+}
+
+number_t IDataObjectRefValue::CCodeGenerator::ReadLastNumber(const wxString &prefix) const
 {
-	wxASSERT(m_metaAttribute);
 	wxString tableName = m_metaObject->GetTableNameDB();
 	wxString fieldName = m_metaAttribute->GetFieldNameDB();
 
-	DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT %s FROM %s ORDER BY %s;", fieldName, tableName, fieldName);
-	if (!resultSet) {
+	number_t number = 0;
+
+	if (m_metaAttribute->GetTypeObject() == eValueTypes::TYPE_NUMBER) {
+		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT MAX(%s) AS lastNumber FROM %s;", fieldName, tableName);
+		if (resultSet) {
+			if (resultSet->Next()) {
+				number = resultSet->GetResultNumber(wxT("lastNumber"));
+			}
+			resultSet->Close();
+		}
+	}
+	else if (m_metaAttribute->GetTypeObject() == eValueTypes::TYPE_STRING) {
+		//codes have leading zeros, so the greatest string is the greatest number
+		PreparedStatement *statement = databaseLayer->PrepareStatement("SELECT MAX(" + fieldName + ") AS lastCode FROM " + tableName
+			+ " WHERE " + databaseLayer->GetDialect()->GetStartsWith(fieldName) + ";");
+		if (statement) {
+			statement->SetParamString(1, prefix);
+			DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+			if (resultSet) {
+				if (resultSet->Next()) {
+					wxString lastCode = resultSet->GetResultString(wxT("lastCode")).Mid(prefix.length()).Trim();
+					if (!lastCode.IsEmpty() && lastCode.IsNumber()) {
+						number.FromString(lastCode.ToStdString());
+					}
+				}
+				resultSet->Close();
+			}
+			databaseLayer->CloseStatement(statement);
+		}
+	}
+
+	return number;
+}
+
+CValue IDataObjectRefValue::CCodeGenerator::GenerateCode(const wxString &prefix, const wxString &period) const
+{
+	wxASSERT(m_metaAttribute);
+
+	number_t code = NextNumber(prefix, period);
+
+	if (code.IsZero()) {
 		wxString className = metadata->GetNameObjectFromID(
 			m_metaAttribute->GetClassTypeObject()
 		);
 		return metadata->CreateObject(className);
 	}
 
-	number_t code = 1;
 	if (m_metaAttribute->GetTypeObject() == eValueTypes::TYPE_NUMBER) {
-
-		while (resultSet->Next()) {
-			number_t fieldCode = resultSet->GetResultNumber(fieldName);
-			if (fieldCode == code) {
-				code++;
-			}
-		}
-		resultSet->Close();
 		return code;
 	}
 	else if (m_metaAttribute->GetTypeObject() == eValueTypes::TYPE_STRING) {
 
 		ttmath::Conv conv;
 
-		conv.precision = m_metaAttribute->GetLength();
+		conv.precision = m_metaAttribute->GetLength() - prefix.length();
 		conv.leading_zero = true;
-		wxString strCode = code.ToString(conv);
 
-		while (resultSet->Next()) {
-			wxString fieldCode = resultSet->GetResultString(fieldName);
-			if (fieldCode == strCode) {
-				code++;
-				strCode = code.ToString(conv);
-			}
-		}
-		resultSet->Close();
-		return strCode;
+		return prefix + wxString(code.ToString(conv));
 	}
 
 	wxASSERT_MSG(false, "m_metaAttribute->GetTypeObject() != eValueTypes::TYPE_NUMBER"
 		"|| m_metaAttribute->GetTypeObject() != eValueTypes::TYPE_STRING");
 
 	return CValue();
+}
+
+bool IDataObjectRefValue::CCodeGenerator::IsUniqueCode(const CValue &code, const Guid &objGuid) const
+{
+	if (code.IsEmpty())
+		return true;
+
+	wxString tableName = m_metaObject->GetTableNameDB();
+	wxString fieldName = m_metaAttribute->GetFieldNameDB();
+
+	PreparedStatement *statement = databaseLayer->PrepareStatement(
+		databaseLayer->GetDialect()->GetSelectLimit(wxString::Format("UUID FROM %s WHERE %s = ? AND UUID <> ?", tableName, fieldName), 1) + ";");
+	if (statement == NULL)
+		return true;
+
+	CValue cCode = code;
+	cCode.SetBinaryData(1, statement);
+	CObjectRowMapper::SetParamGuid(statement, 2, objGuid);
+
+	bool isUnique = true;
+
+	DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+	if (resultSet) {
+		isUnique = !resultSet->Next();
+		resultSet->Close();
+	}
+
+	databaseLayer->CloseStatement(statement);
+	return isUnique;
 }
\ No newline at end of file
@@ -97,11 +97,17 @@ public:
 		return m_attributeCode;
 	}
 
+	//get attribute for list order 
+	virtual IMetaAttributeObject *GetAttributeForSort() const {
+		return m_attributeName;
+	}
+
 	//override base objects 
 	virtual std::vector<IMetaAttributeObject *> GetObjectAttributes() const override;
 
 	//searched attributes 
 	virtual std::vector<IMetaAttributeObject *> GetSearchedAttributes() const override;
+	virtual std::vector<IMetaAttributeObject *> GetPresentationAttributes() const override;
 
 	//create associate value 
 	virtual CMetaFormObject *GetDefaultFormByID(form_identifier_t id);
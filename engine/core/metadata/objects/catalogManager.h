@@ -19,6 +19,10 @@ public:
 
 	CValue EmptyRef();
 
+	//bulk transfer of the catalog rows
+	CValue ImportData(const wxString &fileName);
+	CValue ExportData(const wxString &fileName);
+
 	virtual CMethods* GetPMethods() const { PrepareNames();  return m_methods; }; //         
 	virtual void PrepareNames() const;                         //         
 	virtual CValue Method(methodArg_t &aParams);// 
@@ -19,7 +19,10 @@ enum
 	eGetListForm,
 	eGetSelectForm,
 
-	eEmptyRef
+	eEmptyRef,
+
+	eImportData,
+	eExportData,
 };
 
 #include "metadata/metadata.h"
@@ -36,7 +39,7 @@ void CManagerCatalogValue::PrepareNames() const
 		{"createElement", "createElement()"},
 		{"createGroup", "createGroup()"},
 
-		{"select", "select()"},
+		{"select", "select(filter, order, limit)"},
 		{"findByCode", "findByCode(string)"},
 		{"findByName", "findByName(string)"},
 
@@ -45,6 +48,9 @@ void CManagerCatalogValue::PrepareNames() const
 		{"getSelectForm", "getSelectForm(string, owner, guid)"},
 
 		{"emptyRef", "emptyRef()"},
+
+		{"importData", "importData(fileName)"},
+		{"exportData", "exportData(fileName)"},
 	};
 
 	int nCountM = sizeof(aMethods) / sizeof(aMethods[0]);
@@ -81,7 +87,15 @@ CValue CManagerCatalogValue::Method(methodArg_t &aParams)
 			CSelectorCatalogValue(CMetaObjectCatalogValue *metaObject) : IDataSelectorValue(metaObject) {}
 		};
 
-		return new CSelectorCatalogValue(m_metaObject);
+		//freed if the selection is rejected
+		wxScopedPtr<CSelectorCatalogValue> selector(new CSelectorCatalogValue(m_metaObject));
+		if (aParams.GetParamCount() > 0) {
+			selector->SetSelection(aParams[0],
+				aParams.GetParamCount() > 1 ? aParams[1] : CValue(),
+				aParams.GetParamCount() > 2 ? aParams[2] : CValue()
+			);
+		}
+		return selector.release();
 	}
 	case eFindByCode: return FindByCode(aParams[0]);
 	case eFindByName: return FindByName(aParams[0]);
@@ -109,6 +123,8 @@ CValue CManagerCatalogValue::Method(methodArg_t &aParams)
 			guidVal ? *guidVal : Guid());
 	}
 	case eEmptyRef: return EmptyRef();
+	case eImportData: return ImportData(aParams[0].GetString());
+	case eExportData: return ExportData(aParams[0].GetString());
 	}
 
 	IMetadata *metaData = m_metaObject->GetMetadata();
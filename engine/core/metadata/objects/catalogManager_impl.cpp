@@ -6,6 +6,9 @@
 #include "catalogManager.h"
 #include "appData.h"
 #include "databaseLayer/databaseLayer.h"
+#include "metadata/objects/objectRowMapper.h"
+#include "metadata/objects/objectDataTransfer.h"
+#include "compiler/systemObjects.h"
 
 CValue CManagerCatalogValue::FindByCode(const CValue &vCode)
 {
@@ -17,7 +20,8 @@ CValue CManagerCatalogValue::FindByCode(const CValue &vCode)
 			CMetaDefaultAttributeObject *catCode = m_metaObject->GetCatCode();
 			wxASSERT(catCode);
 
-			wxString sqlQuery = "SELECT FIRST 1 UUID FROM %s WHERE %s LIKE ?";
+			//exact match, served by the code index
+			wxString sqlQuery = databaseLayer->GetDialect()->GetSelectLimit("UUID FROM %s WHERE %s = ?", 1);
 			PreparedStatement *statement = databaseLayer->PrepareStatement(sqlQuery, tableName, catCode->GetFieldNameDB());
 			if (statement == NULL) {
 				return new CValueReference(m_metaObject);
@@ -34,7 +38,7 @@ CValue CManagerCatalogValue::FindByCode(const CValue &vCode)
 			DatabaseResultSet *databaseResultSet = statement->RunQueryWithResults();
 			wxASSERT(databaseResultSet);
 			if (databaseResultSet->Next()) {
-				Guid foundedGuid = databaseResultSet->GetResultString(guidName);
+				Guid foundedGuid = CObjectRowMapper::GetResultGuid(databaseResultSet, guidName);
 				if (foundedGuid.isValid()) {
 					foundedReference = new CValueReference(m_metaObject, foundedGuid);
 				}
@@ -56,10 +60,11 @@ CValue CManagerCatalogValue::FindByName(const CValue &vName)
 		if (databaseLayer->TableExists(tableName)) {
 			wxString UUID = wxEmptyString;
 
-			CMetaDefaultAttributeObject *catName = m_metaObject->GetCatCode();
+			CMetaDefaultAttributeObject *catName = m_metaObject->GetCatName();
 			wxASSERT(catName);
 
-			wxString sqlQuery = "SELECT FIRST 1 UUID FROM %s WHERE %s LIKE ?";
+			//match without case, served by the search index on UPPER(name)
+			wxString sqlQuery = databaseLayer->GetDialect()->GetSelectLimit("UUID FROM %s WHERE UPPER(%s) = ?", 1);
 			PreparedStatement *statement = databaseLayer->PrepareStatement(sqlQuery, tableName, catName->GetFieldNameDB());
 			if (statement == NULL) {
 				return new CValueReference(m_metaObject);
@@ -69,14 +74,14 @@ CValue CManagerCatalogValue::FindByName(const CValue &vName)
 				catName->GetNumberQualifier(), catName->GetDateQualifier(), catName->GetStringQualifier());
 			CValue name = tdName->AdjustValue(vName);
 
-			statement->SetParamString(1, name.GetString());
+			statement->SetParamString(1, name.GetString().Upper());
 			wxDELETE(tdName);
 
 			CValueReference *foundedReference = NULL;
 			DatabaseResultSet *databaseResultSet = statement->RunQueryWithResults();
 			wxASSERT(databaseResultSet);
 			if (databaseResultSet->Next()) {
-				Guid foundedGuid = databaseResultSet->GetResultString(guidName);
+				Guid foundedGuid = CObjectRowMapper::GetResultGuid(databaseResultSet, guidName);
 				if (foundedGuid.isValid()) {
 					foundedReference = new CValueReference(m_metaObject, foundedGuid);
 				}
@@ -89,4 +94,30 @@ CValue CManagerCatalogValue::FindByName(const CValue &vName)
 		}
 	}
 	return new CValueReference(m_metaObject);
+}
+
+CValue CManagerCatalogValue::ImportData(const wxString &fileName)
+{
+	if (!appData->EnterpriseMode())
+		return 0;
+
+	CObjectDataTransfer dataTransfer(m_metaObject);
+	if (!dataTransfer.ImportData(fileName)) {
+		CSystemObjects::Raise(wxString::Format(_("Failed to import data from \"%s\""), fileName));
+	}
+
+	return dataTransfer.GetRowCount();
+}
+
+CValue CManagerCatalogValue::ExportData(const wxString &fileName)
+{
+	if (!appData->EnterpriseMode())
+		return 0;
+
+	CObjectDataTransfer dataTransfer(m_metaObject);
+	if (!dataTransfer.ExportData(fileName)) {
+		CSystemObjects::Raise(wxString::Format(_("Failed to export data to \"%s\""), fileName));
+	}
+
+	return dataTransfer.GetRowCount();
 }
\ No newline at end of file
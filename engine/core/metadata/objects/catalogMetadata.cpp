@@ -354,6 +354,13 @@ std::vector<IMetaAttributeObject*> CMetaObjectCatalogValue::GetSearchedAttribute
 
 }
 
+std::vector<IMetaAttributeObject*> CMetaObjectCatalogValue::GetPresentationAttributes() const
+{
+	std::vector<IMetaAttributeObject *> attributes;
+	attributes.push_back(m_attributeName);
+	return attributes;
+}
+
 //***************************************************************************
 //*                       Save & load metadata                              *
 //***************************************************************************
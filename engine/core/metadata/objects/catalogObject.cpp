@@ -125,20 +125,21 @@ bool CObjectCatalogValue::WriteObject()
 	{
 		if (!CTranslateError::IsSimpleMode())
 		{
-			databaseLayer->BeginTransaction();
+			//the scope is rolled back when the module code throws
+			DatabaseWriteScope writeScope(databaseLayer);
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("BeforeWrite", cancel);
 
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
+					writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
 					return false;
 				}
 			}
 
 			if (!SaveInDB()) {
-				databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
+				writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
 				return false;
 			}
 
@@ -146,12 +147,12 @@ bool CObjectCatalogValue::WriteObject()
 				CValue cancel = false;
 				m_procUnit->CallFunction("OnWrite", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
+					writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!"));
 					return false;
 				}
 			}
 
-			databaseLayer->Commit();
+			writeScope.Commit();
 
 			CValueForm *valueForm = GetFrame();
 
@@ -173,29 +174,30 @@ bool CObjectCatalogValue::DeleteObject()
 	{
 		if (!CTranslateError::IsSimpleMode())
 		{
-			databaseLayer->BeginTransaction();
+			//the scope is rolled back when the module code throws
+			DatabaseWriteScope writeScope(databaseLayer);
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("BeforeDelete", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
 				}
 			}
 
 			if (!DeleteInDB()) {
-				databaseLayer->RollBack(); CSystemObjects::Raise("failed to delete object in db!"); return false;
+				writeScope.RollBack(); CSystemObjects::Raise("failed to delete object in db!"); return false;
 			}
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("OnDelete", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
 				}
 			}
 
-			databaseLayer->Commit();
+			writeScope.Commit();
 		}
 	}
 
@@ -15,10 +15,12 @@ bool CMetaConstantObject::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 	wxString tableName = GetTableNameDB();
 	wxString fieldName = GetFieldNameDB();
 
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
 	int retCode = 1;
 
 	if ((flags & createMetaTable) != 0) {
-		retCode = databaseLayer->RunQuery("ALTER TABLE %s ADD %s %s;", tableName, fieldName, GetSQLTypeObject());
+		retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, fieldName, GetSQLTypeObject()));
 	}
 	else if ((flags & updateMetaTable) != 0) {
 
@@ -26,21 +28,33 @@ bool CMetaConstantObject::CreateAndUpdateTableDB(IConfigMetadata *srcMetaData, I
 		CMetaConstantObject *dstValue = NULL;
 		if (srcMetaObject->ConvertToValue(dstValue)) {
 			if (CMetaConstantObject::GetTypeDescription() != dstValue->GetTypeDescription()) {
-				if (CMetaConstantObject::GetTypeObject() == dstValue->GetTypeObject()) {
-					retCode = databaseLayer->RunQuery("ALTER TABLE %s ALTER COLUMN %s TYPE %s;", tableName, fieldName, GetSQLTypeObject());
+				wxString alterText = dialect->GetAlterColumnType(tableName, fieldName, GetSQLTypeObject());
+				if (CMetaConstantObject::GetTypeObject() == dstValue->GetTypeObject() && !alterText.IsEmpty()) {
+					retCode = databaseLayer->RunQuery(alterText);
+				}
+				else if (CMetaConstantObject::GetTypeObject() == dstValue->GetTypeObject()) {
+					//the value is copied into a column of the new type
+					wxString newName = fieldName + wxT("_NEW");
+					retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, newName, GetSQLTypeObject()));
+					if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+						retCode = databaseLayer->RunQuery("UPDATE %s SET %s = CAST(%s AS %s);", tableName, newName, fieldName, GetSQLTypeObject());
+					if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+						retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
+					if (retCode != DATABASE_LAYER_QUERY_RESULT_ERROR)
+						retCode = databaseLayer->RunQuery(dialect->GetRenameColumn(tableName, newName, fieldName));
 				}
 				else {
-					retCode = databaseLayer->RunQuery("ALTER TABLE %s DROP %s;", tableName, fieldName);
+					retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
 					if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 						return false;
 					}
-					retCode = databaseLayer->RunQuery("ALTER TABLE %s ADD %s %s;", tableName, fieldName, GetSQLTypeObject());
+					retCode = databaseLayer->RunQuery(dialect->GetAddColumn(tableName, fieldName, GetSQLTypeObject()));
 				} 
 			}
 		}
 	}
 	else if ((flags & deleteMetaTable) != 0) {
-		retCode = databaseLayer->RunQuery("ALTER TABLE %s DROP %s;", tableName, fieldName);
+		retCode = databaseLayer->RunQuery(dialect->GetDropColumn(tableName, fieldName));
 		if (retCode == DATABASE_LAYER_QUERY_RESULT_ERROR) {
 			return false;
 		}
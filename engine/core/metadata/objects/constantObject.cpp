@@ -82,6 +82,7 @@ CConstantObjectValue::CConstantObjectValue(CMetaConstantObject *metaObject)
 }
 
 #include "databaseLayer/databaseLayer.h"
+#include "objectCache.h"
 
 CValue CConstantObjectValue::GetConstValue()
 {
@@ -92,8 +93,16 @@ CValue CConstantObjectValue::GetConstValue()
 		wxString tableName = m_metaObject->GetTableNameDB();
 		wxString fieldName = m_metaObject->GetFieldNameDB();
 
+		//constants are kept in the cache with an empty guid
+		std::map<meta_identifier_t, CValue> aCachedValues;
+
+		if (objectCache->GetValues(m_metaObject->GetMetaID(), Guid(), aCachedValues)) {
+			return aCachedValues[m_metaObject->GetMetaID()];
+		}
+
 		if (databaseLayer->TableExists(tableName)) {
-			DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT FIRST 1 %s FROM %s", fieldName, tableName);
+			DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(
+				databaseLayer->GetDialect()->GetSelectLimit(fieldName + wxT(" FROM ") + tableName, 1));
 
 			if (resultSet == NULL) {
 				return ret;
@@ -132,6 +141,9 @@ CValue CConstantObjectValue::GetConstValue()
 			}
 
 			resultSet->Close();
+
+			aCachedValues[m_metaObject->GetMetaID()] = ret;
+			objectCache->PutValues(m_metaObject->GetMetaID(), Guid(), aCachedValues);
 		}
 	}
 
@@ -149,14 +161,15 @@ void CConstantObjectValue::SetConstValue(const CValue &cValue)
 
 		if (databaseLayer->TableExists(tableName)) {
 
-			databaseLayer->BeginTransaction();
+			//the scope is rolled back when the module code throws
+			DatabaseWriteScope writeScope(databaseLayer);
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("BeforeWrite", cancel);
 
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return;
 				}
 			}
 
@@ -182,14 +195,19 @@ void CConstantObjectValue::SetConstValue(const CValue &cValue)
 			}
 
 			if (!fillCheck) {
-				return;
+				writeScope.RollBack(); return;
 			}
 
-			PreparedStatement *statement = 
-				databaseLayer->PrepareStatement("UPDATE OR INSERT INTO %s (%s, RECORD_KEY) VALUES (?, '6') MATCHING(RECORD_KEY);", tableName, fieldName);
+			wxArrayString aColumns, aValues, aKeyColumns;
+			aColumns.Add(fieldName); aValues.Add(wxT("?"));
+			aColumns.Add(wxT("RECORD_KEY")); aValues.Add(wxT("'6'"));
+			aKeyColumns.Add(wxT("RECORD_KEY"));
 
-			if (statement == NULL) {
-				return;
+			DatabaseStatementLocker statement(databaseLayer,
+				databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aKeyColumns));
+
+			if (!statement.IsOk()) {
+				writeScope.RollBack(); return;
 			}
 
 			switch (m_metaObject->GetTypeObject())
@@ -202,23 +220,28 @@ void CConstantObjectValue::SetConstValue(const CValue &cValue)
 			{
 				CValueReference *reference = dynamic_cast<CValueReference *>(adjustVal.GetRef());
 				if (reference) {
-					reference->SetBinaryData(1, statement);
+					reference->SetBinaryData(1, statement.GetStatement());
 				}
 			}
 			}
 
 			bool hasError = statement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR;
-			databaseLayer->CloseStatement(statement);
+
+			if (hasError) {
+				writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return;
+			}
+
+			objectCache->Invalidate(m_metaObject->GetMetaID());
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("OnWrite", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return;
 				}
 			}
 
-			databaseLayer->Commit();
+			writeScope.Commit();
 		}
 	}
 }
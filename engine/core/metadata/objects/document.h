@@ -99,6 +99,11 @@ public:
 		return m_attributeNumber;
 	}
 
+	//get attribute for list order 
+	virtual IMetaAttributeObject *GetAttributeForSort() const {
+		return m_attributeDate;
+	}
+
 	//override base objects 
 	virtual std::vector<IMetaAttributeObject *> GetObjectAttributes() const override;
 
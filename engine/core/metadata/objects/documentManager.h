@@ -18,6 +18,10 @@ public:
 	CValue FindByNumber(const CValue &vCode, const CValue &vPeriod);
 	CValue EmptyRef();
 
+	//bulk transfer of the document rows
+	CValue ImportData(const wxString &fileName);
+	CValue ExportData(const wxString &fileName);
+
 	virtual CMethods* GetPMethods() const { PrepareNames(); return m_methods; }; //         
 	virtual void PrepareNames() const;                         //         
 	virtual CValue Method(methodArg_t &aParams);// 
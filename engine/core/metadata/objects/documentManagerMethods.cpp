@@ -17,7 +17,10 @@ enum
 	eGetListForm,
 	eGetSelectForm,
 
-	eEmptyRef
+	eEmptyRef,
+
+	eImportData,
+	eExportData,
 };
 
 #include "metadata/metadata.h"
@@ -33,7 +36,7 @@ void CManagerDocumentValue::PrepareNames() const
 	{
 		{"createElement", "createElement()"},
 
-		{"select", "select()"},
+		{"select", "select(filter, order, limit)"},
 
 		{"findByNumber", "findByNumber(string, date)"},
 
@@ -42,6 +45,9 @@ void CManagerDocumentValue::PrepareNames() const
 		{"getSelectForm", "getSelectForm(string, owner, guid)"},
 
 		{"emptyRef", "emptyRef()"},
+
+		{"importData", "importData(fileName)"},
+		{"exportData", "exportData(fileName)"},
 	};
 
 	int nCountM = sizeof(aMethods) / sizeof(aMethods[0]);
@@ -80,7 +86,15 @@ CValue CManagerDocumentValue::Method(methodArg_t &aParams)
 			CSelectorDocumentValue(CMetaObjectDocumentValue *metaObject) : IDataSelectorValue(metaObject) {}
 		};
 
-		return new CSelectorDocumentValue(m_metaObject);
+		//freed if the selection is rejected
+		wxScopedPtr<CSelectorDocumentValue> selector(new CSelectorDocumentValue(m_metaObject));
+		if (aParams.GetParamCount() > 0) {
+			selector->SetSelection(aParams[0],
+				aParams.GetParamCount() > 1 ? aParams[1] : CValue(),
+				aParams.GetParamCount() > 2 ? aParams[2] : CValue()
+			);
+		}
+		return selector.release();
 	}
 	case eFindByNumber:
 	{
@@ -113,6 +127,8 @@ CValue CManagerDocumentValue::Method(methodArg_t &aParams)
 	{
 		return EmptyRef();
 	}
+	case eImportData: return ImportData(aParams[0].GetString());
+	case eExportData: return ExportData(aParams[0].GetString());
 	}
 
 	IMetadata *metaData = m_metaObject->GetMetadata();
@@ -6,6 +6,9 @@
 #include "documentManager.h"
 #include "appData.h"
 #include "databaseLayer/databaseLayer.h"
+#include "metadata/objects/objectRowMapper.h"
+#include "metadata/objects/objectDataTransfer.h"
+#include "compiler/systemObjects.h"
 #include "compiler/valueTypeDescription.h"
 
 CValue CManagerDocumentValue::FindByNumber(const CValue &vNumber, const CValue &vPeriod)
@@ -19,15 +22,18 @@ CValue CManagerDocumentValue::FindByNumber(const CValue &vNumber, const CValue &
 			CMetaDefaultAttributeObject *docDate = m_metaObject->GetDocDate();
 			wxASSERT(docNumber && docDate);
 
-			wxString sqlQuery = "SELECT FIRST 1 UUID FROM %s WHERE %s LIKE ?";
+			//exact match, served by the number index; the latest document up to the period wins
+			wxString sqlQuery = "UUID FROM %s WHERE %s = ?";
 
 			if (!vPeriod.IsEmpty()) {
-				sqlQuery += "%s <= ?";
+				sqlQuery += " AND %s <= ? ORDER BY %s DESC";
 			}
 
+			sqlQuery = databaseLayer->GetDialect()->GetSelectLimit(sqlQuery, 1);
+
 			PreparedStatement *statement = NULL;
 			if (!vPeriod.IsEmpty()) {
-				statement = databaseLayer->PrepareStatement(sqlQuery, tableName, docNumber->GetFieldNameDB(), docDate->GetFieldNameDB());
+				statement = databaseLayer->PrepareStatement(sqlQuery, tableName, docNumber->GetFieldNameDB(), docDate->GetFieldNameDB(), docDate->GetFieldNameDB());
 				if (statement == NULL) {
 					return new CValueReference(m_metaObject);
 				}
@@ -65,7 +71,7 @@ CValue CManagerDocumentValue::FindByNumber(const CValue &vNumber, const CValue &
 			DatabaseResultSet *databaseResultSet = statement->RunQueryWithResults();
 			wxASSERT(databaseResultSet);
 			if (databaseResultSet->Next()) {
-				Guid foundedGuid = databaseResultSet->GetResultString(guidName);
+				Guid foundedGuid = CObjectRowMapper::GetResultGuid(databaseResultSet, guidName);
 				if (foundedGuid.isValid()) {
 					foundedReference = new CValueReference(m_metaObject, foundedGuid);
 				}
@@ -79,3 +85,29 @@ CValue CManagerDocumentValue::FindByNumber(const CValue &vNumber, const CValue &
 	}
 	return new CValueReference(m_metaObject);
 }
+
+CValue CManagerDocumentValue::ImportData(const wxString &fileName)
+{
+	if (!appData->EnterpriseMode())
+		return 0;
+
+	CObjectDataTransfer dataTransfer(m_metaObject);
+	if (!dataTransfer.ImportData(fileName)) {
+		CSystemObjects::Raise(wxString::Format(_("Failed to import data from \"%s\""), fileName));
+	}
+
+	return dataTransfer.GetRowCount();
+}
+
+CValue CManagerDocumentValue::ExportData(const wxString &fileName)
+{
+	if (!appData->EnterpriseMode())
+		return 0;
+
+	CObjectDataTransfer dataTransfer(m_metaObject);
+	if (!dataTransfer.ExportData(fileName)) {
+		CSystemObjects::Raise(wxString::Format(_("Failed to export data to \"%s\""), fileName));
+	}
+
+	return dataTransfer.GetRowCount();
+}
\ No newline at end of file
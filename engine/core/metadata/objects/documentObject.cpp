@@ -123,20 +123,21 @@ bool CObjectDocumentValue::WriteObject()
 	{
 		if (!CTranslateError::IsSimpleMode())
 		{
-			databaseLayer->BeginTransaction();
+			//the scope is rolled back when the module code throws
+			DatabaseWriteScope writeScope(databaseLayer);
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("BeforeWrite", cancel);
 
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
+					writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
 					return false;
 				}
 			}
 
 			if (!SaveInDB()) {
-				databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
+				writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
 				return false;
 			}
 
@@ -144,12 +145,12 @@ bool CObjectDocumentValue::WriteObject()
 				CValue cancel = false;
 				m_procUnit->CallFunction("OnWrite", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
+					writeScope.RollBack(); CSystemObjects::Raise(_("failed to write object in db!")); 
 					return false;
 				}
 			}
 
-			databaseLayer->Commit();
+			writeScope.Commit();
 
 			CValueForm *valueForm = GetFrame();
 
@@ -171,29 +172,30 @@ bool CObjectDocumentValue::DeleteObject()
 	{
 		if (!CTranslateError::IsSimpleMode())
 		{
-			databaseLayer->BeginTransaction();
+			//the scope is rolled back when the module code throws
+			DatabaseWriteScope writeScope(databaseLayer);
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("BeforeDelete", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
 				}
 			}
 
 			if (!DeleteInDB()) {
-				databaseLayer->RollBack(); CSystemObjects::Raise("failed to delete object in db!"); return false;
+				writeScope.RollBack(); CSystemObjects::Raise("failed to delete object in db!"); return false;
 			}
 
 			{
 				CValue cancel = false;
 				m_procUnit->CallFunction("OnDelete", cancel);
 				if (cancel.GetBoolean()) {
-					databaseLayer->RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
+					writeScope.RollBack(); CSystemObjects::Raise("failed to write object in db!"); return false;
 				}
 			}
 
-			databaseLayer->Commit();
+			writeScope.Commit();
 		}
 	}
 
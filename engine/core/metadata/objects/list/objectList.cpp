@@ -11,21 +11,26 @@
 wxIMPLEMENT_ABSTRACT_CLASS(IDataObjectList, IValueTable);
 wxIMPLEMENT_DYNAMIC_CLASS(CDataObjectList, IDataObjectList);
 
-wxDataViewItem IDataObjectList::GetLineByGuid(const Guid &guid) const
-{
-	auto foundedIt = m_aObjectValues.find(guid);
-	if (foundedIt == m_aObjectValues.end()) {
-		return wxDataViewItem(0);
+IDataObjectList::IDataObjectList(IMetaObjectRefValue *metaObject, form_identifier_t formType) :
+	IDataObjectSource(), m_metaObject(metaObject), m_sortAttribute(NULL), m_objGuid(Guid::newGuid()),
+	m_nRowCount(0), m_nLastPage(0)
+{
+	//keyset paging needs a scalar sort field, otherwise the list is ordered by guid only
+	IMetaAttributeObject *sortAttribute = metaObject ? metaObject->GetAttributeForSort() : NULL;
+	if (sortAttribute != NULL) {
+		switch (sortAttribute->GetTypeObject())
+		{
+		case eValueTypes::TYPE_BOOLEAN:
+		case eValueTypes::TYPE_NUMBER:
+		case eValueTypes::TYPE_DATE:
+		case eValueTypes::TYPE_STRING:
+			m_sortAttribute = sortAttribute;
+			break;
+		default:
+			break;
+		}
 	}
 
-	return GetItem(
-		std::distance(m_aObjectValues.begin(), foundedIt)
-	);
-}
-
-IDataObjectList::IDataObjectList(IMetaObjectRefValue *metaObject, form_identifier_t formType) :
-	IDataObjectSource(), m_metaObject(metaObject), m_objGuid(Guid::newGuid())
-{
 	if (appData->EnterpriseMode()) {
 		UpdateModel();
 	}
@@ -115,9 +120,6 @@ void IDataObjectList::
 {
 	int index = m_methods->GetAttributePosition(aParams.GetIndex());
 
-	auto itFoundedByLine = m_ownerTable->m_aObjectValues.begin();
-	std::advance(itFoundedByLine, m_lineTable);
-
 	//CValueTypeDescription *m_typeDescription = m_ownerTable->m_aDataColumns->GetColumnType(index);
 	//itFoundedByLine->insert_or_assign(index, m_typeDescription ? m_typeDescription->AdjustValue(cVal) : cVal);
 }
@@ -130,9 +132,14 @@ CValue IDataObjectList::
 
 	meta_identifier_t id = m_methods->GetAttributePosition(aParams.GetIndex());
 
-	auto itFoundedByLine = m_ownerTable->m_aObjectValues.begin();
-	std::advance(itFoundedByLine, m_lineTable);
-	auto &rowValues = itFoundedByLine->second;
+	listRow_t *rowData = m_lineTable != wxNOT_FOUND ?
+		m_ownerTable->GetRowData(m_lineTable) : NULL;
+
+	if (rowData == NULL) {
+		return CValue();
+	}
+
+	auto &rowValues = rowData->m_aObjectValues;
 
 	auto itFoundedByIndex = rowValues.find(id);
 	if (itFoundedByIndex != rowValues.end()) {
@@ -172,11 +179,12 @@ void CDataObjectList::CopyValue()
 	if (currentLine == wxNOT_FOUND)
 		return;
 
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, currentLine);
+	listRow_t *rowData = GetRowData(currentLine);
+	if (rowData == NULL)
+		return;
 
 	IDataObjectValue *dataValue =
-		m_metaObject->CreateObjectRefValue(itFounded->first);
+		m_metaObject->CreateObjectRefValue(rowData->m_rowGuid);
 	if (dataValue) {
 		CValue reference = dataValue->CopyObjectValue();
 		reference.ShowValue();
@@ -189,11 +197,12 @@ void CDataObjectList::EditValue()
 	if (currentLine == wxNOT_FOUND)
 		return;
 
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, currentLine);
+	listRow_t *rowData = GetRowData(currentLine);
+	if (rowData == NULL)
+		return;
 
 	CValue reference =
-		m_metaObject->CreateObjectRefValue(itFounded->first);
+		m_metaObject->CreateObjectRefValue(rowData->m_rowGuid);
 
 	reference.ShowValue();
 }
@@ -204,11 +213,12 @@ void CDataObjectList::DeleteValue()
 	if (currentLine == wxNOT_FOUND)
 		return;
 
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, currentLine);
+	listRow_t *rowData = GetRowData(currentLine);
+	if (rowData == NULL)
+		return;
 
 	IDataObjectValue *objData =
-		m_metaObject->CreateObjectRefValue(itFounded->first);
+		m_metaObject->CreateObjectRefValue(rowData->m_rowGuid);
 
 	if (objData) {
 		//objData->DeleteObject();
@@ -223,11 +233,12 @@ void CDataObjectList::ChooseValue(CValueForm *srcForm)
 	if (currentLine == wxNOT_FOUND)
 		return;
 
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, currentLine);
+	listRow_t *rowData = GetRowData(currentLine);
+	if (rowData == NULL)
+		return;
 
 	CValue reference =
-		m_metaObject->FindObjectValue(itFounded->first);
+		m_metaObject->FindObjectValue(rowData->m_rowGuid);
 
 	srcForm->NotifyChoice(reference);
 }
@@ -3,6 +3,8 @@
 
 #include "metadata/objects/baseObject.h"
 
+#include <list>
+
 class IDataObjectList : public IValueTable,
 	public IDataObjectSource {
 	wxDECLARE_ABSTRACT_CLASS(IDataObjectList);
@@ -28,7 +30,7 @@ private:
 
 	virtual IValueTableReturnLine *GetRowAt(unsigned int line)
 	{
-		if (line > m_aObjectValues.size())
+		if (line >= GetItSize())
 			return NULL;
 
 		return new DataObjectListReturnLine(this, line);
@@ -74,13 +76,15 @@ public:
 
 	virtual CValue GetItAt(unsigned int idx) override
 	{
-		if (idx > m_aObjectValues.size())
+		if (idx >= GetItSize())
 			return CValue();
 
 		return new DataObjectListReturnLine(this, idx);
 	}
 
-	virtual unsigned int GetItSize() const override { return m_aObjectValues.size(); }
+	virtual unsigned int GetItSize() const override { return m_nRowCount; }
+
+	virtual void PrepareReferences();
 
 	virtual bool AutoCreateColumns() { return false; }
 	virtual bool EditableLine(const wxDataViewItem &item, unsigned int col) { return false; }
@@ -124,12 +128,60 @@ public:
 	//operator 
 	virtual operator CValue() const { return this; };
 
+protected:
+
+	struct listRow_t {
+		Guid m_rowGuid;
+		std::map<meta_identifier_t, CValue> m_aObjectValues;
+
+		//columns of the row, so rows can be passed to CValueReference::PrepareReferences
+		std::map<meta_identifier_t, CValue>::const_iterator begin() const { return m_aObjectValues.begin(); }
+		std::map<meta_identifier_t, CValue>::const_iterator end() const { return m_aObjectValues.end(); }
+	};
+
+	//position of a row in the list order
+	struct listKey_t {
+		CValue m_sortValue;
+		Guid m_rowGuid;
+	};
+
+	struct listPage_t {
+		std::vector<listRow_t> m_aRows;
+	};
+
+	//rows are read by pages around the shown lines, only a few pages are kept
+	listRow_t *GetRowData(unsigned int row) const;
+	listPage_t *LoadPage(unsigned int page) const;
+
+	bool ReadPage(unsigned int page, listPage_t &pageData) const;
+	void ReadRows(PreparedStatement *statement, std::vector<listRow_t> &aRows) const;
+
+	//keyset support
+	listKey_t GetRowKey(const listRow_t &rowData) const;
+	void BindKey(PreparedStatement *statement, int position, const listKey_t &key) const;
+	wxString GetKeyCondition(bool after) const;
+	wxString GetOrderText(bool reverse) const;
+
+	unsigned int ReadRowCount() const;
+	bool ReadRowPosition(const Guid &guid, unsigned int &row) const;
+
+	void ClearPages();
+
 protected:
 
 	IMetaObjectRefValue *m_metaObject;
+	IMetaAttributeObject *m_sortAttribute;
 
 	Guid m_objGuid;
-	std::map<Guid, std::map<meta_identifier_t, CValue>> m_aObjectValues;
+
+	unsigned int m_nRowCount;
+
+	mutable std::map<unsigned int, listPage_t> m_aPages;
+	mutable std::list<unsigned int> m_aPageOrder; //most recently used first
+	mutable std::map<unsigned int, std::pair<listKey_t, listKey_t>> m_aPageKeys; //first and last key of pages read near the shown one
+
+	std::map<Guid, std::map<meta_identifier_t, CValue>> m_aRowEdits; //values set by SetValueByRow, applied to every page read until UpdateModel
+	mutable unsigned int m_nLastPage;
 };
 
 class CDataObjectList : public IDataObjectList {
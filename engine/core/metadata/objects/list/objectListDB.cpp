@@ -4,66 +4,385 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "objectList.h"
+#include "metadata/objects/objectCache.h"
+#include "metadata/objects/objectRowMapper.h"
 #include "appData.h"
 #include "databaseLayer/databaseLayer.h"
 #include "utils/stringUtils.h"
 
+#include <algorithm>
+
+#define listPageSize 100
+#define listMaxPages 8
+#define listMaxPageKeys 256
+
 void IDataObjectList::UpdateModel()
 {
+	ClearPages();
+
+	//a refresh shows the rows as stored, e.g. written by the object form or other sessions
+	m_aRowEdits.clear();
+
+	m_nRowCount = ReadRowCount();
+
+	if (!CTranslateError::IsSimpleMode()) {
+		IValueTable::Reset(m_nRowCount);
+	}
+}
+
+void IDataObjectList::PrepareReferences()
+{
+	for (auto &page : m_aPages) {
+		CValueReference::PrepareReferences(page.second.m_aRows);
+	}
+}
+
+IDataObjectList::listRow_t *IDataObjectList::GetRowData(unsigned int row) const
+{
+	if (row >= m_nRowCount)
+		return NULL;
+
+	unsigned int page = row / listPageSize;
+	listPage_t *pageData = LoadPage(page);
+
+	//read the next page in the scroll direction ahead
+	if (page != m_nLastPage) {
+		bool forward = page > m_nLastPage;
+		m_nLastPage = page;
+		if (forward && (page + 1) * listPageSize < m_nRowCount) {
+			LoadPage(page + 1);
+		}
+		else if (!forward && page > 0) {
+			LoadPage(page - 1);
+		}
+	}
+
+	if (pageData == NULL)
+		return NULL;
+
+	unsigned int index = row - page * listPageSize;
+	if (index >= pageData->m_aRows.size())
+		return NULL;
+
+	return &pageData->m_aRows[index];
+}
+
+IDataObjectList::listPage_t *IDataObjectList::LoadPage(unsigned int page) const
+{
+	auto foundedIt = m_aPages.find(page);
+	if (foundedIt != m_aPages.end()) {
+		m_aPageOrder.remove(page);
+		m_aPageOrder.push_front(page);
+		return &foundedIt->second;
+	}
+
+	listPage_t pageData;
+	if (!ReadPage(page, pageData))
+		return NULL;
+
+	//edited values outlive the pages they were made on
+	for (auto &rowData : pageData.m_aRows) {
+		auto foundedEdits = m_aRowEdits.find(rowData.m_rowGuid);
+		if (foundedEdits == m_aRowEdits.end())
+			continue;
+		for (auto &colValue : foundedEdits->second) {
+			rowData.m_aObjectValues.insert_or_assign(colValue.first, colValue.second);
+		}
+	}
+
+	//presentations of the referenced objects are read per page, not per cell
+	CValueReference::PrepareReferences(pageData.m_aRows);
+
+	listPage_t &newPage = m_aPages[page];
+	newPage.m_aRows.swap(pageData.m_aRows);
+	m_aPageOrder.push_front(page);
+
+	//drop the least recently used pages, their keys stay for the keyset navigation
+	while (m_aPageOrder.size() > listMaxPages) {
+		m_aPages.erase(m_aPageOrder.back());
+		m_aPageOrder.pop_back();
+	}
+
+	return &newPage;
+}
+
+bool IDataObjectList::ReadPage(unsigned int page, listPage_t &pageData) const
+{
+	unsigned int start = page * listPageSize;
+	if (start >= m_nRowCount)
+		return false;
+
+	unsigned int count = std::min<unsigned int>(listPageSize, m_nRowCount - start);
+
 	wxString tableName = m_metaObject->GetTableNameDB();
-	wxString queryText = "SELECT * FROM " + tableName + " ORDER BY CAST(UUID AS VARCHAR(36)); ";
 
-	m_aObjectValues.clear();
+	DatabaseDialect *dialect = databaseLayer->GetDialect();
+
+	PreparedStatement *statement = NULL;
+	bool reverse = false;
+
+	auto prevKeys = page > 0 ? m_aPageKeys.find(page - 1) : m_aPageKeys.end();
+	auto nextKeys = m_aPageKeys.find(page + 1);
+
+	if (prevKeys != m_aPageKeys.end()) {
+		//rows after the last row of the previous page
+		statement = databaseLayer->PrepareStatement(dialect->GetSelectLimit(wxString::Format("* FROM %s WHERE %s ORDER BY %s",
+			tableName, GetKeyCondition(true), GetOrderText(false)), count) + ";");
+		if (statement != NULL) {
+			BindKey(statement, 1, prevKeys->second.second);
+		}
+	}
+	else if (nextKeys != m_aPageKeys.end()) {
+		//rows before the first row of the next page
+		statement = databaseLayer->PrepareStatement(dialect->GetSelectLimit(wxString::Format("* FROM %s WHERE %s ORDER BY %s",
+			tableName, GetKeyCondition(false), GetOrderText(true)), count) + ";");
+		if (statement != NULL) {
+			BindKey(statement, 1, nextKeys->second.first);
+		}
+		reverse = true;
+	}
+	else {
+		//jump to a page without known neighbours, the rows are skipped from the nearest
+		//page with known keys or from the nearer end of the list, not always from the first row
+		unsigned int skip = start;
+		const listKey_t *seekKey = NULL;
+
+		if (m_nRowCount - start - count < skip) {
+			skip = m_nRowCount - start - count;
+			reverse = true;
+		}
+
+		auto aboveKeys = m_aPageKeys.upper_bound(page);
+		if (aboveKeys != m_aPageKeys.end() && aboveKeys->first * listPageSize - start - count < skip) {
+			skip = aboveKeys->first * listPageSize - start - count;
+			seekKey = &aboveKeys->second.first;
+			reverse = true;
+		}
 
-	PreparedStatement *statement = databaseLayer->PrepareStatement(queryText);
+		auto belowKeys = m_aPageKeys.lower_bound(page);
+		if (belowKeys != m_aPageKeys.begin()) {
+			belowKeys--;
+			if (start - (belowKeys->first + 1) * listPageSize < skip) {
+				skip = start - (belowKeys->first + 1) * listPageSize;
+				seekKey = &belowKeys->second.second;
+				reverse = false;
+			}
+		}
+
+		wxString whereText = seekKey != NULL ? wxT(" WHERE ") + GetKeyCondition(!reverse) : wxString();
+		statement = databaseLayer->PrepareStatement(dialect->GetSelectLimit(wxString::Format("* FROM %s%s ORDER BY %s",
+			tableName, whereText, GetOrderText(reverse)), count, skip) + ";");
+		if (statement != NULL && seekKey != NULL) {
+			BindKey(statement, 1, *seekKey);
+		}
+	}
+
+	if (statement == NULL)
+		return false;
+
+	ReadRows(statement, pageData.m_aRows);
+	databaseLayer->CloseStatement(statement);
+
+	if (pageData.m_aRows.empty())
+		return false;
+
+	if (reverse) {
+		std::reverse(pageData.m_aRows.begin(), pageData.m_aRows.end());
+	}
+
+	m_aPageKeys.insert_or_assign(page,
+		std::make_pair(GetRowKey(pageData.m_aRows.front()), GetRowKey(pageData.m_aRows.back()))
+	);
+
+	//keys far from the shown page are dropped, such a page is found by position again
+	while (m_aPageKeys.size() > listMaxPageKeys) {
+		auto firstKeys = m_aPageKeys.begin();
+		auto lastKeys = std::prev(m_aPageKeys.end());
+		if (page - firstKeys->first > lastKeys->first - page) {
+			m_aPageKeys.erase(firstKeys);
+		}
+		else {
+			m_aPageKeys.erase(lastKeys);
+		}
+	}
+
+	return true;
+}
+
+void IDataObjectList::ReadRows(PreparedStatement *statement, std::vector<listRow_t> &aRows) const
+{
 	DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+	if (resultSet == NULL)
+		return;
+
+	//empty references are not shown in the list
+	CObjectRowMapper rowMapper(m_metaObject->GetMetadata(), m_metaObject->GetObjectAttributes(), false);
+	rowMapper.Prepare(resultSet);
 
 	while (resultSet->Next()) {
-		std::map<meta_identifier_t, CValue> valueRow;
+		listRow_t rowData;
+		rowData.m_rowGuid = rowMapper.ReadGuid(resultSet);
+
 		wxMemoryBuffer bufferData;
-		resultSet->GetResultBlob(guidRef, bufferData);
-		
-		if (!bufferData.IsEmpty()) {
-			valueRow.insert_or_assign(m_metaObject->GetMetaID(), CValueReference::CreateFromPtr(
+		if (rowMapper.ReadReference(resultSet, bufferData)) {
+			rowData.m_aObjectValues.insert_or_assign(m_metaObject->GetMetaID(), CValueReference::CreateFromPtr(
 				m_metaObject->GetMetadata(), bufferData.GetData())
 			);
 		}
-		
-		for (auto attribute : m_metaObject->GetObjectAttributes()) {
-			wxString fieldName = attribute->GetName();
-			switch (attribute->GetTypeObject())
-			{
-			case eValueTypes::TYPE_BOOLEAN:
-				valueRow.insert_or_assign(attribute->GetMetaID(), resultSet->GetResultBool(attribute->GetFieldNameDB()));
-				break;
-			case eValueTypes::TYPE_NUMBER:
-				valueRow.insert_or_assign(attribute->GetMetaID(), resultSet->GetResultDouble(attribute->GetFieldNameDB()));
-				break;
-			case eValueTypes::TYPE_DATE:
-				valueRow.insert_or_assign(attribute->GetMetaID(), resultSet->GetResultDate(attribute->GetFieldNameDB()));
-				break;
-			case eValueTypes::TYPE_STRING:
-				valueRow.insert_or_assign(attribute->GetMetaID(), resultSet->GetResultString(attribute->GetFieldNameDB()));
-				break;
-			default:
-				wxMemoryBuffer bufferData;
-				resultSet->GetResultBlob(attribute->GetFieldNameDB(), bufferData);
-				if (!bufferData.IsEmpty()) {
-					valueRow.insert_or_assign(attribute->GetMetaID(), CValueReference::CreateFromPtr(
-						m_metaObject->GetMetadata(), bufferData.GetData())
-					);
-				}
-				break;
-			}
-		}
-		m_aObjectValues.insert_or_assign(resultSet->GetResultString(guidName), valueRow);
+
+		rowMapper.ReadRow(resultSet, rowData.m_aObjectValues);
+
+		aRows.push_back(rowData);
 	};
 
 	resultSet->Close();
+}
 
-	if (!CTranslateError::IsSimpleMode()) {
-		IValueTable::Reset(m_aObjectValues.size());
+
+IDataObjectList::listKey_t IDataObjectList::GetRowKey(const listRow_t &rowData) const
+{
+	listKey_t key;
+	key.m_rowGuid = rowData.m_rowGuid;
+
+	if (m_sortAttribute != NULL) {
+		auto foundedIt = rowData.m_aObjectValues.find(m_sortAttribute->GetMetaID());
+		if (foundedIt != rowData.m_aObjectValues.end()) {
+			key.m_sortValue = foundedIt->second;
+		}
+	}
+
+	return key;
+}
+
+void IDataObjectList::BindKey(PreparedStatement *statement, int position, const listKey_t &key) const
+{
+	if (m_sortAttribute != NULL) {
+		CValue sortValue = key.m_sortValue;
+		sortValue.SetBinaryData(position++, statement);
+		sortValue.SetBinaryData(position++, statement);
+	}
+
+	CObjectRowMapper::SetParamGuid(statement, position, key.m_rowGuid);
+}
+
+wxString IDataObjectList::GetKeyCondition(bool after) const
+{
+	wxString compare = after ? wxT(">") : wxT("<");
+
+	if (m_sortAttribute != NULL) {
+		wxString fieldName = m_sortAttribute->GetFieldNameDB();
+		return wxString::Format(wxT("(%s %s ? OR (%s = ? AND %s %s ?))"),
+			fieldName, compare, fieldName, guidName, compare);
+	}
+
+	return wxString::Format(wxT("%s %s ?"), guidName, compare);
+}
+
+wxString IDataObjectList::GetOrderText(bool reverse) const
+{
+	wxString direction = reverse ? wxT("DESC") : wxT("ASC");
+
+	if (m_sortAttribute != NULL) {
+		return wxString::Format(wxT("%s %s, %s %s"),
+			m_sortAttribute->GetFieldNameDB(), direction, guidName, direction);
+	}
+
+	return wxString::Format(wxT("%s %s"), guidName, direction);
+}
+
+unsigned int IDataObjectList::ReadRowCount() const
+{
+	if (!databaseLayer->IsOpen())
+		return 0;
+
+	//the table is counted again only after a change of its objects
+	unsigned int count = 0;
+	if (objectCache->GetRowCount(m_metaObject->GetMetaID(), count))
+		return count;
+
+	DatabaseResultSet *resultSet =
+		databaseLayer->RunQueryWithResults("SELECT COUNT(*) AS rowCount FROM %s;", m_metaObject->GetTableNameDB());
+
+	if (resultSet == NULL)
+		return 0;
+
+	if (resultSet->Next()) {
+		count = resultSet->GetResultInt(wxT("rowCount"));
+		objectCache->PutRowCount(m_metaObject->GetMetaID(), count);
+	}
+
+	resultSet->Close();
+	return count;
+}
+
+bool IDataObjectList::ReadRowPosition(const Guid &guid, unsigned int &row) const
+{
+	wxString tableName = m_metaObject->GetTableNameDB();
+
+	PreparedStatement *statement = NULL;
+
+	//the position is the number of rows before the key of the object
+	if (m_sortAttribute != NULL) {
+		wxString fieldName = m_sortAttribute->GetFieldNameDB();
+		statement = databaseLayer->PrepareStatement(databaseLayer->GetDialect()->GetSelectWithoutTable(wxString::Format(
+			"(SELECT COUNT(*) FROM %s WHERE %s = ?) AS rowExists, "
+			"(SELECT COUNT(*) FROM %s WHERE %s < (SELECT %s FROM %s WHERE %s = ?) "
+			"OR (%s = (SELECT %s FROM %s WHERE %s = ?) AND %s < ?)) AS rowCount",
+			tableName, guidName,
+			tableName, fieldName, fieldName, tableName, guidName,
+			fieldName, fieldName, tableName, guidName, guidName
+		)) + ";");
+		if (statement != NULL) {
+			for (int position = 1; position <= 4; position++) {
+				CObjectRowMapper::SetParamGuid(statement, position, guid);
+			}
+		}
+	}
+	else {
+		statement = databaseLayer->PrepareStatement(databaseLayer->GetDialect()->GetSelectWithoutTable(wxString::Format(
+			"(SELECT COUNT(*) FROM %s WHERE %s = ?) AS rowExists, "
+			"(SELECT COUNT(*) FROM %s WHERE %s < ?) AS rowCount",
+			tableName, guidName, tableName, guidName
+		)) + ";");
+		if (statement != NULL) {
+			CObjectRowMapper::SetParamGuid(statement, 1, guid);
+			CObjectRowMapper::SetParamGuid(statement, 2, guid);
+		}
+	}
+
+	if (statement == NULL)
+		return false;
+
+	bool founded = false;
+
+	DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+	if (resultSet != NULL) {
+		if (resultSet->Next() && resultSet->GetResultInt(wxT("rowExists")) > 0) {
+			row = resultSet->GetResultInt(wxT("rowCount"));
+			founded = row < m_nRowCount;
+		}
+		resultSet->Close();
 	}
 
 	databaseLayer->CloseStatement(statement);
-}
\ No newline at end of file
+	return founded;
+}
+
+wxDataViewItem IDataObjectList::GetLineByGuid(const Guid &guid) const
+{
+	unsigned int row = 0;
+	if (!ReadRowPosition(guid, row)) {
+		return wxDataViewItem(0);
+	}
+
+	return GetItem(row);
+}
+
+void IDataObjectList::ClearPages()
+{
+	m_aPages.clear();
+	m_aPageOrder.clear();
+	m_aPageKeys.clear();
+	m_nLastPage = 0;
+	m_nRowCount = 0;
+}
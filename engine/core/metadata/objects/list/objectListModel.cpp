@@ -66,9 +66,11 @@ wxString IDataObjectList::GetColumnType(unsigned int col) const
 void IDataObjectList::GetValueByRow(wxVariant &variant,
 	unsigned int row, unsigned int col) const
 {
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, row);
-	auto &rowValues = itFounded->second;
+	listRow_t *rowData = GetRowData(row);
+	if (rowData == NULL)
+		return;
+
+	auto &rowValues = rowData->m_aObjectValues;
 
 	auto foundedColumn = rowValues.find(col);
 	if (foundedColumn != rowValues.end()) {
@@ -85,14 +87,18 @@ bool IDataObjectList::GetAttrByRow(unsigned int row, unsigned int col, wxDataVie
 bool IDataObjectList::SetValueByRow(const wxVariant &variant,
 	unsigned int row, unsigned int col)
 {
-	auto itFounded = m_aObjectValues.begin();
-	std::advance(itFounded, row);
-	auto &rowValues = itFounded->second;
+	listRow_t *rowData = GetRowData(row);
+	if (rowData == NULL)
+		return false;
+
+	auto &rowValues = rowData->m_aObjectValues;
 
 	auto foundedColumn = rowValues.find(col);
 	if (foundedColumn != rowValues.end()) {
 		CValue &cValue = foundedColumn->second;
 		cValue.SetValue(variant.GetString());
+		//the page may be dropped from the cache, the edit is kept apart
+		m_aRowEdits[rowData->m_rowGuid].insert_or_assign(col, cValue);
 	}
 
 	return false;
@@ -0,0 +1,266 @@
+////////////////////////////////////////////////////////////////////////////
+//	Author		: Maxim Kornienko
+//	Description : object cache
+////////////////////////////////////////////////////////////////////////////
+
+#include "objectCache.h"
+#include "metadata/metadata.h"
+#include "databaseLayer/databaseLayer.h"
+#include "appData.h"
+
+#define defaultMaxSize 4096
+#define defaultRefreshInterval 1000
+
+CObjectCache *CObjectCache::s_instance = NULL;
+
+CObjectCache::CObjectCache() : m_maxSize(defaultMaxSize),
+m_lastRefresh(0), m_refreshInterval(defaultRefreshInterval), m_nHits(0), m_nMisses(0), m_nInvalidations(0)
+{
+	databaseLayer->SetBeforeCommitHandler(&CObjectCache::OnBeforeCommit);
+}
+
+CObjectCache *CObjectCache::Get()
+{
+	if (!s_instance) {
+		s_instance = new CObjectCache();
+	}
+	return s_instance;
+}
+
+void CObjectCache::Destroy()
+{
+	if (s_instance) {
+		databaseLayer->SetBeforeCommitHandler(NULL);
+		wxDELETE(s_instance);
+	}
+}
+
+bool CObjectCache::GetValues(meta_identifier_t id, const Guid &guid, std::map<meta_identifier_t, CValue> &aObjectValues)
+{
+	CheckRefresh();
+
+	cacheEntry_t *entry = FindEntry(cacheKey_t(id, guid));
+	if (entry && entry->m_bValues) {
+		aObjectValues = entry->m_aObjectValues;
+		m_nHits++;
+		return true;
+	}
+
+	m_nMisses++;
+	return false;
+}
+
+void CObjectCache::PutValues(meta_identifier_t id, const Guid &guid, const std::map<meta_identifier_t, CValue> &aObjectValues)
+{
+	CheckRefresh();
+
+	if (!AllowStore())
+		return;
+
+	cacheEntry_t *entry = AddEntry(cacheKey_t(id, guid));
+	entry->m_aObjectValues = aObjectValues;
+	entry->m_bValues = true;
+}
+
+bool CObjectCache::GetPresentation(meta_identifier_t id, const Guid &guid, wxString &presentation)
+{
+	CheckRefresh();
+
+	cacheEntry_t *entry = FindEntry(cacheKey_t(id, guid));
+	if (entry && entry->m_bPresentation) {
+		presentation = entry->m_presentation;
+		m_nHits++;
+		return true;
+	}
+
+	m_nMisses++;
+	return false;
+}
+
+void CObjectCache::PutPresentation(meta_identifier_t id, const Guid &guid, const wxString &presentation)
+{
+	CheckRefresh();
+
+	if (!AllowStore())
+		return;
+
+	cacheEntry_t *entry = AddEntry(cacheKey_t(id, guid));
+	entry->m_presentation = presentation;
+	entry->m_bPresentation = true;
+}
+
+bool CObjectCache::GetRowCount(meta_identifier_t id, unsigned int &count)
+{
+	CheckRefresh();
+
+	auto foundedIt = m_aRowCounts.find(id);
+	if (foundedIt != m_aRowCounts.end()) {
+		count = foundedIt->second;
+		m_nHits++;
+		return true;
+	}
+
+	m_nMisses++;
+	return false;
+}
+
+void CObjectCache::PutRowCount(meta_identifier_t id, unsigned int count)
+{
+	CheckRefresh();
+
+	if (!AllowStore())
+		return;
+
+	m_aRowCounts.insert_or_assign(id, count);
+}
+
+void CObjectCache::Invalidate(meta_identifier_t id, const Guid &guid)
+{
+	auto foundedIt = m_aEntryKeys.find(cacheKey_t(id, guid));
+	if (foundedIt != m_aEntryKeys.end()) {
+		EraseEntry(foundedIt->second);
+		m_nInvalidations++;
+	}
+
+	//a new or deleted object changes the count
+	m_aRowCounts.erase(id);
+
+	//other sessions learn about it after the commit
+	m_aPendingChanges.insert(id);
+}
+
+void CObjectCache::Refresh()
+{
+	m_lastRefresh = wxGetLocalTimeMillis();
+
+	if (!databaseLayer->IsOpen())
+		return;
+
+	DatabaseResultSet *resultSet =
+		databaseLayer->RunQueryWithResults("SELECT metaID, generation FROM %s;", IConfigMetadata::GetObjectChangesTableName());
+
+	if (resultSet == NULL)
+		return;
+
+	while (resultSet->Next()) {
+		meta_identifier_t id = resultSet->GetResultInt(wxT("metaID"));
+		long long generation = resultSet->GetResultLong(wxT("generation"));
+		auto foundedIt = m_aGenerations.find(id);
+		if (foundedIt == m_aGenerations.end() || foundedIt->second != generation) {
+			InvalidateMetaObject(id);
+			m_aGenerations[id] = generation;
+		}
+	}
+
+	resultSet->Close();
+}
+
+void CObjectCache::Clear()
+{
+	m_aEntries.clear();
+	m_aEntryKeys.clear();
+	m_aRowCounts.clear();
+}
+
+void CObjectCache::SetMaxSize(size_t maxSize)
+{
+	m_maxSize = maxSize;
+
+	while (m_aEntries.size() > m_maxSize) {
+		EraseEntry(--m_aEntries.end());
+	}
+}
+
+CObjectCache::cacheEntry_t *CObjectCache::FindEntry(const cacheKey_t &key)
+{
+	auto foundedIt = m_aEntryKeys.find(key);
+	if (foundedIt == m_aEntryKeys.end())
+		return NULL;
+
+	//move to the front of the list
+	m_aEntries.splice(m_aEntries.begin(), m_aEntries, foundedIt->second);
+	return &m_aEntries.front();
+}
+
+CObjectCache::cacheEntry_t *CObjectCache::AddEntry(const cacheKey_t &key)
+{
+	cacheEntry_t *entry = FindEntry(key);
+	if (entry)
+		return entry;
+
+	cacheEntry_t newEntry;
+	newEntry.m_key = key;
+	newEntry.m_bValues = false;
+	newEntry.m_bPresentation = false;
+
+	m_aEntries.push_front(newEntry);
+	m_aEntryKeys[key] = m_aEntries.begin();
+
+	//drop the least recently used entries
+	while (m_aEntries.size() > m_maxSize && m_aEntries.size() > 1) {
+		EraseEntry(--m_aEntries.end());
+	}
+
+	return &m_aEntries.front();
+}
+
+void CObjectCache::EraseEntry(cacheEntryList_t::iterator itEntry)
+{
+	m_aEntryKeys.erase(itEntry->m_key);
+	m_aEntries.erase(itEntry);
+}
+
+void CObjectCache::InvalidateMetaObject(meta_identifier_t id)
+{
+	m_aRowCounts.erase(id);
+
+	auto itEntry = m_aEntries.begin();
+	while (itEntry != m_aEntries.end()) {
+		if (itEntry->m_key.first == id) {
+			auto itErase = itEntry++;
+			EraseEntry(itErase);
+			m_nInvalidations++;
+		}
+		else {
+			itEntry++;
+		}
+	}
+}
+
+void CObjectCache::CheckRefresh()
+{
+	if (wxGetLocalTimeMillis() - m_lastRefresh >= m_refreshInterval) {
+		Refresh();
+	}
+}
+
+bool CObjectCache::AllowStore() const
+{
+	return m_maxSize > 0 && !databaseLayer->IsTransactionOpen();
+}
+
+void CObjectCache::PublishChanges()
+{
+	wxString tableName = IConfigMetadata::GetObjectChangesTableName();
+
+	for (auto id : m_aPendingChanges) {
+		//rows are never deleted, a counter read by Refresh exists
+		if (m_aGenerations.find(id) == m_aGenerations.end()) {
+			wxArrayString aColumns, aValues, aKeyColumns;
+			aColumns.Add(wxT("metaID")); aValues.Add(wxString::Format(wxT("%i"), id));
+			aKeyColumns.Add(wxT("metaID"));
+			databaseLayer->RunQuery(databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aKeyColumns));
+		}
+		//the row stays locked up to the commit, concurrent writers are counted one after another
+		databaseLayer->RunQuery("UPDATE %s SET generation = generation + 1 WHERE metaID = %i;", tableName, id);
+	}
+
+	m_aPendingChanges.clear();
+}
+
+void CObjectCache::OnBeforeCommit()
+{
+	if (s_instance) {
+		s_instance->PublishChanges();
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef _OBJECT_CACHE_H__
+#define _OBJECT_CACHE_H__
+
+#include "compiler/value.h"
+#include "guid/guid.h"
+
+#include <list>
+#include <map>
+#include <set>
+
+#define objectCache (CObjectCache::Get())
+
+//session cache of object rows and presentations keyed by (meta id, guid).
+//local writes drop their entries, changes of other sessions are found
+//through the generation counters of OBJECT_CHANGES
+class CObjectCache {
+	CObjectCache();
+public:
+
+	static CObjectCache *Get();
+	static void Destroy();
+
+	//object rows (attributes without tabular sections)
+	bool GetValues(meta_identifier_t id, const Guid &guid, std::map<meta_identifier_t, CValue> &aObjectValues);
+	void PutValues(meta_identifier_t id, const Guid &guid, const std::map<meta_identifier_t, CValue> &aObjectValues);
+
+	//presentations
+	bool GetPresentation(meta_identifier_t id, const Guid &guid, wxString &presentation);
+	void PutPresentation(meta_identifier_t id, const Guid &guid, const wxString &presentation);
+
+	//row count of the table of an object, dropped by any change of the object
+	bool GetRowCount(meta_identifier_t id, unsigned int &count);
+	void PutRowCount(meta_identifier_t id, unsigned int count);
+
+	//object was written or deleted in this session
+	void Invalidate(meta_identifier_t id, const Guid &guid = Guid());
+
+	//read the change counters now
+	void Refresh();
+
+	void Clear();
+
+	//limits
+	void SetMaxSize(size_t maxSize);
+	size_t GetMaxSize() const { return m_maxSize; }
+	void SetRefreshInterval(long interval) { m_refreshInterval = interval; }
+	long GetRefreshInterval() const { return m_refreshInterval; }
+
+	//statistics
+	size_t GetSize() const { return m_aEntries.size(); }
+	unsigned long GetHits() const { return m_nHits; }
+	unsigned long GetMisses() const { return m_nMisses; }
+	unsigned long GetInvalidations() const { return m_nInvalidations; }
+
+private:
+
+	typedef std::pair<meta_identifier_t, Guid> cacheKey_t;
+
+	struct cacheEntry_t {
+		cacheKey_t m_key;
+		std::map<meta_identifier_t, CValue> m_aObjectValues;
+		wxString m_presentation;
+		bool m_bValues;
+		bool m_bPresentation;
+	};
+
+	typedef std::list<cacheEntry_t> cacheEntryList_t;
+
+	cacheEntry_t *FindEntry(const cacheKey_t &key);
+	cacheEntry_t *AddEntry(const cacheKey_t &key);
+	void EraseEntry(cacheEntryList_t::iterator itEntry);
+
+	void InvalidateMetaObject(meta_identifier_t id);
+
+	void CheckRefresh();
+
+	//entries are stored only outside of a transaction, so they never hold uncommitted data
+	bool AllowStore() const;
+
+	//count the changes of the transaction in OBJECT_CHANGES, inside the transaction before its commit
+	void PublishChanges();
+	static void OnBeforeCommit();
+
+private:
+
+	static CObjectCache *s_instance;
+
+	// most recently used entries go first
+	cacheEntryList_t m_aEntries;
+	std::map<cacheKey_t, cacheEntryList_t::iterator> m_aEntryKeys;
+
+	size_t m_maxSize;
+
+	std::map<meta_identifier_t, unsigned int> m_aRowCounts;
+
+	std::map<meta_identifier_t, long long> m_aGenerations;
+	std::set<meta_identifier_t> m_aPendingChanges;
+
+	wxLongLong m_lastRefresh;
+	long m_refreshInterval;
+
+	unsigned long m_nHits;
+	unsigned long m_nMisses;
+	unsigned long m_nInvalidations;
+};
+
+#endif
@@ -0,0 +1,889 @@
+////////////////////////////////////////////////////////////////////////////
+//	Author		: Maxim Kornienko
+//	Description : bulk import and export of object data
+////////////////////////////////////////////////////////////////////////////
+
+#include "objectDataTransfer.h"
+#include "metadata/metadata.h"
+#include "metadata/objects/baseObject.h"
+#include "metadata/objects/constant.h"
+#include "metadata/objects/objectCache.h"
+#include "metadata/objects/objectRowMapper.h"
+#include "compiler/systemObjects.h"
+#include "databaseLayer/databaseLayer.h"
+#include "databaseLayer/databaseErrorCodes.h"
+#include "appData.h"
+
+#include <wx/datstrm.h>
+#include <wx/filename.h>
+#include <wx/txtstrm.h>
+#include <wx/wfstream.h>
+
+#include <set>
+
+#define defaultCommitSize 10000
+
+//binary format: signature, version, columns (name, type), rows.
+//every row starts with transferRow, every value with a null flag
+#define transferSignature 0x4F424A44
+#define transferVersion 1
+
+#define transferRow 1
+#define transferEnd 0
+
+enum eTransferType {
+	eTransferGuid = 1,
+	eTransferBoolean,
+	eTransferNumber,
+	eTransferDate,
+	eTransferString,
+	eTransferReference,
+};
+
+#define transferDateFormat wxT("%d.%m.%Y %H:%M:%S")
+
+inline bool IsTextFile(const wxString &fileName)
+{
+	return wxFileName(fileName).GetExt().CmpNoCase(wxT("csv")) == 0;
+}
+
+inline unsigned char GetTransferType(IMetaAttributeObject *attribute)
+{
+	switch (attribute->GetTypeObject())
+	{
+	case eValueTypes::TYPE_BOOLEAN: return eTransferBoolean;
+	case eValueTypes::TYPE_NUMBER: return eTransferNumber;
+	case eValueTypes::TYPE_DATE: return eTransferDate;
+	case eValueTypes::TYPE_STRING: return eTransferString;
+	}
+
+	return eTransferReference;
+}
+
+inline wxString QuoteText(const wxString &text)
+{
+	if (text.find_first_of(wxT(",;\"\r\n")) == wxString::npos
+		&& !text.StartsWith(wxT(" ")) && !text.EndsWith(wxT(" "))) {
+		return text;
+	}
+
+	wxString quotedText = text;
+	quotedText.Replace(wxT("\""), wxT("\"\""));
+	return wxT("\"") + quotedText + wxT("\"");
+}
+
+CObjectDataTransfer::CObjectDataTransfer(IMetaObjectRefValue *metaObject) :
+	m_metaData(metaObject->GetMetadata()), m_metaObject(metaObject),
+	m_tableName(metaObject->GetTableNameDB()), m_aAttributes(metaObject->GetObjectAttributes()),
+	m_commitSize(defaultCommitSize), m_nRows(0), m_nSkipped(0), m_elapsedTime(0)
+{
+}
+
+CObjectDataTransfer::CObjectDataTransfer(IMetadata *metaData) :
+	m_metaData(metaData), m_metaObject(NULL),
+	m_tableName(CMetaConstantObject::GetTableNameDB()),
+	m_commitSize(defaultCommitSize), m_nRows(0), m_nSkipped(0), m_elapsedTime(0)
+{
+	for (auto obj : m_metaData->GetMetaObjects(g_metaConstantCLSID)) {
+		CMetaConstantObject *constant = NULL;
+		if (obj->ConvertToValue(constant)) {
+			m_aAttributes.push_back(constant);
+		}
+	}
+}
+
+bool CObjectDataTransfer::ImportData(const wxString &fileName)
+{
+	wxLongLong startTime = wxGetLocalTimeMillis();
+
+	m_nRows = m_nSkipped = 0;
+	m_elapsedTime = 0;
+	m_aReferences.clear();
+	m_aWrittenGuids.clear();
+
+	wxFileInputStream inputStream(fileName);
+	if (!inputStream.IsOk()) {
+		CSystemObjects::Message(wxString::Format(_("Cannot open file \"%s\""), fileName), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	const bool textFile = IsTextFile(fileName);
+
+	wxTextInputStream textStream(inputStream, wxT(" \t"), wxConvUTF8);
+	wxDataInputStream dataStream(inputStream, wxConvUTF8);
+
+	std::vector<wxString> aNames;
+	std::vector<unsigned char> aTypes;
+
+	wxChar separator = wxT(',');
+
+	if (textFile) {
+		wxString headerLine = textStream.ReadLine();
+		if (headerLine.StartsWith(wxT("\xFEFF"))) {
+			headerLine.Remove(0, 1);
+		}
+		if (headerLine.Find(wxT(';')) != wxNOT_FOUND) {
+			separator = wxT(';');
+		}
+		else if (headerLine.Find(wxT('\t')) != wxNOT_FOUND) {
+			separator = wxT('\t');
+		}
+		for (auto name : wxSplit(headerLine, separator, wxT('\0'))) {
+			name.Trim(true).Trim(false);
+			if (name.length() > 1 && name.StartsWith(wxT("\"")) && name.EndsWith(wxT("\""))) {
+				name = name.Mid(1, name.length() - 2);
+			}
+			aNames.push_back(name);
+		}
+	}
+	else {
+		if (dataStream.Read32() != transferSignature || dataStream.Read16() != transferVersion || !dataStream.IsOk()) {
+			CSystemObjects::Message(wxString::Format(_("\"%s\" is not a data file"), fileName), eStatusMessage::eStatusMessage_Error);
+			return false;
+		}
+		unsigned int columnCount = dataStream.Read32();
+		for (unsigned int col = 0; col < columnCount && dataStream.IsOk(); col++) {
+			aNames.push_back(dataStream.ReadString());
+			aTypes.push_back(dataStream.Read8());
+		}
+		if (!dataStream.IsOk()) {
+			CSystemObjects::Message(wxString::Format(_("\"%s\" is not a data file"), fileName), eStatusMessage::eStatusMessage_Error);
+			return false;
+		}
+	}
+
+	if (!PrepareColumns(aNames))
+		return false;
+
+	for (unsigned int col = 0; col < aTypes.size(); col++) {
+		m_aColumns[col].m_fileType = aTypes[col];
+	}
+
+	PreparedStatement *statement = databaseLayer->PrepareStatement(GetWriteQuery());
+	if (statement == NULL)
+		return false;
+
+	std::vector<field_t> aFields(m_aColumns.size());
+	std::vector<wxString> aValues;
+
+	const unsigned int commitSize = wxMax(m_commitSize, 1u);
+
+	bool endOfFile = false;
+	bool hasError = false;
+
+	while (!endOfFile && !hasError) {
+		//every chunk is committed on its own, a chunk left by an error is rolled back
+		DatabaseWriteScope writeScope(databaseLayer);
+
+		unsigned int pendingRows = 0;
+		while (pendingRows < commitSize) {
+			bool validRow = true;
+
+			if (textFile) {
+				if (!ReadTextRow(textStream, separator, aValues)) {
+					endOfFile = true; break;
+				}
+				for (unsigned int col = 0; col < m_aColumns.size(); col++) {
+					aFields[col].m_bNull = true;
+					//missing values at the end of the line stay empty
+					if (col < aValues.size() && !ParseText(m_aColumns[col], aValues[col], aFields[col])) {
+						validRow = false;
+					}
+				}
+			}
+			else {
+				bool endOfData = false;
+				//rows of the current chunk are not written from a damaged file
+				if (!ReadBinaryRow(dataStream, aFields, validRow, endOfData)) {
+					hasError = true; break;
+				}
+				if (endOfData) {
+					endOfFile = true; break;
+				}
+			}
+
+			if (!validRow) {
+				m_nSkipped++;
+				continue;
+			}
+
+			BindRow(statement, aFields);
+			statement->AddBatch();
+			pendingRows++;
+		}
+
+		if (hasError || !FlushWrite(statement)) {
+			statement->ClearBatch();
+			m_aWrittenGuids.clear();
+			hasError = true;
+			break;
+		}
+
+		writeScope.Commit();
+		m_nRows += pendingRows;
+	}
+
+	databaseLayer->CloseStatement(statement);
+
+	m_elapsedTime = (wxGetLocalTimeMillis() - startTime).ToLong();
+	ShowStatistics(_("Import"));
+
+	return !hasError;
+}
+
+bool CObjectDataTransfer::ExportData(const wxString &fileName)
+{
+	wxLongLong startTime = wxGetLocalTimeMillis();
+
+	m_nRows = m_nSkipped = 0;
+	m_elapsedTime = 0;
+
+	//constants are kept in a single row
+	wxString sqlQuery = m_metaObject != NULL ?
+		wxString::Format(wxT("SELECT * FROM %s;"), m_tableName) : databaseLayer->GetDialect()->GetSelectLimit(wxT("* FROM ") + m_tableName, 1) + wxT(";");
+
+	DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(sqlQuery);
+	if (resultSet == NULL)
+		return false;
+
+	wxFileOutputStream outputStream(fileName);
+	if (!outputStream.IsOk()) {
+		resultSet->Close();
+		CSystemObjects::Message(wxString::Format(_("Cannot create file \"%s\""), fileName), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	const bool textFile = IsTextFile(fileName);
+
+	wxTextOutputStream textStream(outputStream, wxEOL_NATIVE, wxConvUTF8);
+	wxDataOutputStream dataStream(outputStream, wxConvUTF8);
+
+	//column positions are found once
+	int guidPosition = m_metaObject != NULL ? resultSet->LookupField(guidName) : wxNOT_FOUND;
+
+	std::vector<int> aPositions;
+	for (auto attribute : m_aAttributes) {
+		aPositions.push_back(resultSet->LookupField(attribute->GetFieldNameDB()));
+	}
+
+	if (textFile) {
+		wxString headerLine = m_metaObject != NULL ? guidName : wxEmptyString;
+		for (auto attribute : m_aAttributes) {
+			if (!headerLine.IsEmpty()) {
+				headerLine += wxT(',');
+			}
+			headerLine += QuoteText(attribute->GetName());
+		}
+		textStream.WriteString(headerLine + wxT("\n"));
+	}
+	else {
+		dataStream.Write32(transferSignature);
+		dataStream.Write16(transferVersion);
+		dataStream.Write32(m_aAttributes.size() + (m_metaObject != NULL ? 1 : 0));
+		if (m_metaObject != NULL) {
+			dataStream.WriteString(guidName);
+			dataStream.Write8(eTransferGuid);
+		}
+		for (auto attribute : m_aAttributes) {
+			dataStream.WriteString(attribute->GetName());
+			dataStream.Write8(GetTransferType(attribute));
+		}
+	}
+
+	while (resultSet->Next()) {
+
+		wxString line;
+
+		if (guidPosition != wxNOT_FOUND) {
+			Guid rowGuid = CObjectRowMapper::GetResultGuid(resultSet, guidPosition);
+			if (textFile) {
+				line = rowGuid.str();
+			}
+			else {
+				dataStream.Write8(transferRow);
+				dataStream.Write8(1);
+				outputStream.Write(rowGuid.bytes().data(), rowGuid.bytes().size());
+			}
+		}
+		else if (!textFile) {
+			dataStream.Write8(transferRow);
+		}
+
+		for (unsigned int idx = 0; idx < m_aAttributes.size(); idx++) {
+			IMetaAttributeObject *attribute = m_aAttributes[idx];
+			int position = aPositions[idx];
+
+			if (textFile && (idx > 0 || guidPosition != wxNOT_FOUND)) {
+				line += wxT(',');
+			}
+
+			if (position == wxNOT_FOUND || resultSet->IsFieldNull(position)) {
+				if (!textFile) {
+					dataStream.Write8(0);
+				}
+				continue;
+			}
+
+			if (!textFile) {
+				dataStream.Write8(1);
+			}
+
+			switch (attribute->GetTypeObject())
+			{
+			case eValueTypes::TYPE_BOOLEAN:
+			{
+				bool value = resultSet->GetResultBool(position);
+				if (textFile) line += value ? wxT("true") : wxT("false");
+				else dataStream.Write8(value ? 1 : 0);
+				break;
+			}
+			case eValueTypes::TYPE_NUMBER:
+			{
+				wxString value = resultSet->GetResultNumber(position).ToString();
+				if (textFile) line += value;
+				else dataStream.WriteString(value);
+				break;
+			}
+			case eValueTypes::TYPE_DATE:
+			{
+				wxDateTime value = resultSet->GetResultDate(position);
+				if (textFile) line += value.Format(transferDateFormat);
+				else dataStream.Write64(value.GetValue().GetValue());
+				break;
+			}
+			case eValueTypes::TYPE_STRING:
+			{
+				wxString value = resultSet->GetResultString(position);
+				if (textFile) line += QuoteText(value);
+				else dataStream.WriteString(value);
+				break;
+			}
+			default:
+			{
+				//references are written as guids of the objects
+				Guid refGuid;
+				wxMemoryBuffer bufferData;
+				resultSet->GetResultBlob(position, bufferData);
+				if (bufferData.GetDataLen() == sizeof(reference_t)) {
+					refGuid = static_cast<reference_t *>(bufferData.GetData())->m_guid;
+				}
+				if (textFile) {
+					if (refGuid.isValid()) line += refGuid.str();
+				}
+				else {
+					outputStream.Write(refGuid.bytes().data(), refGuid.bytes().size());
+				}
+				break;
+			}
+			}
+		}
+
+		if (textFile) {
+			textStream.WriteString(line + wxT("\n"));
+		}
+
+		m_nRows++;
+	}
+
+	resultSet->Close();
+
+	if (textFile) {
+		textStream.Flush();
+	}
+	else {
+		dataStream.Write8(transferEnd);
+	}
+
+	m_elapsedTime = (wxGetLocalTimeMillis() - startTime).ToLong();
+	ShowStatistics(_("Export"));
+
+	return outputStream.IsOk();
+}
+
+double CObjectDataTransfer::GetRowsPerSecond() const
+{
+	if (m_elapsedTime <= 0)
+		return m_nRows;
+
+	return m_nRows * 1000.0 / m_elapsedTime;
+}
+
+bool CObjectDataTransfer::PrepareColumns(const std::vector<wxString> &aNames)
+{
+	m_aColumns.clear();
+
+	std::set<IMetaAttributeObject *> aUsedAttributes;
+	bool hasGuid = false, hasValues = false;
+
+	for (auto &name : aNames) {
+		column_t column;
+		column.m_name = name;
+		column.m_attribute = NULL;
+		column.m_bGuid = false;
+		column.m_fileType = 0;
+
+		if (m_metaObject != NULL && !hasGuid && name.CmpNoCase(guidName) == 0) {
+			column.m_bGuid = hasGuid = true;
+		}
+		else {
+			for (auto attribute : m_aAttributes) {
+				if (attribute->GetName().CmpNoCase(name) == 0) {
+					if (aUsedAttributes.insert(attribute).second) {
+						column.m_attribute = attribute;
+					}
+					break;
+				}
+			}
+			if (column.m_attribute != NULL) {
+				hasValues = true;
+			}
+			else {
+				CSystemObjects::Message(wxString::Format(_("Column \"%s\" is skipped"), name), eStatusMessage::eStatusMessage_Warning);
+			}
+		}
+
+		m_aColumns.push_back(column);
+	}
+
+	if (!hasValues) {
+		CSystemObjects::Message(_("The file has no columns to import"), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	return true;
+}
+
+wxString CObjectDataTransfer::GetWriteQuery() const
+{
+	wxArrayString aColumns, aValues, aKeyColumns;
+
+	if (m_metaObject != NULL) {
+		aColumns.Add(guidName); aValues.Add(wxT("?"));
+		aColumns.Add(guidRef); aValues.Add(wxT("?"));
+		aKeyColumns.Add(guidName);
+	}
+	else {
+		aColumns.Add(wxT("RECORD_KEY")); aValues.Add(wxT("'6'"));
+		aKeyColumns.Add(wxT("RECORD_KEY"));
+	}
+
+	for (auto &column : m_aColumns) {
+		if (column.m_attribute == NULL)
+			continue;
+		aColumns.Add(column.m_attribute->GetFieldNameDB()); aValues.Add(wxT("?"));
+	}
+
+	return databaseLayer->GetDialect()->GetUpsert(m_tableName, aColumns, aValues, aKeyColumns);
+}
+
+bool CObjectDataTransfer::ReadTextRow(wxTextInputStream &textStream, wxChar separator, std::vector<wxString> &aValues) const
+{
+	wxInputStream &inputStream = textStream.GetInputStream();
+
+	wxString line;
+
+	//empty lines are skipped
+	do {
+		if (inputStream.Eof())
+			return false;
+		line = textStream.ReadLine();
+	} while (line.IsEmpty());
+
+	aValues.clear();
+
+	wxString value;
+	bool quoted = false;
+	size_t pos = 0;
+
+	for (;;) {
+		if (pos >= line.length()) {
+			if (!quoted || inputStream.Eof())
+				break;
+			//quoted value goes on in the next line
+			value += wxT('\n');
+			line = textStream.ReadLine();
+			pos = 0;
+			continue;
+		}
+
+		wxChar ch = line[pos++];
+
+		if (quoted) {
+			if (ch != wxT('"')) {
+				value += ch;
+			}
+			else if (pos < line.length() && line[pos] == wxT('"')) {
+				value += ch; pos++;
+			}
+			else {
+				quoted = false;
+			}
+		}
+		else if (ch == wxT('"')) {
+			quoted = true;
+		}
+		else if (ch == separator) {
+			aValues.push_back(value);
+			value.clear();
+		}
+		else {
+			value += ch;
+		}
+	}
+
+	aValues.push_back(value);
+	return true;
+}
+
+bool CObjectDataTransfer::ReadBinaryRow(wxDataInputStream &dataStream, std::vector<field_t> &aFields, bool &validRow, bool &endOfData)
+{
+	//the rows end with transferEnd, a file cut short is damaged
+	wxUint8 marker = dataStream.Read8();
+	if (!dataStream.IsOk() || (marker != transferRow && marker != transferEnd)) {
+		CSystemObjects::Message(_("The data file is damaged"), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	if (marker == transferEnd) {
+		endOfData = true;
+		return true;
+	}
+
+	validRow = true;
+
+	for (unsigned int col = 0; col < m_aColumns.size(); col++) {
+		const column_t &column = m_aColumns[col];
+		field_t &field = aFields[col];
+
+		field.m_bNull = dataStream.Read8() == 0;
+		if (field.m_bNull)
+			continue;
+
+		//values of another type are converted like text
+		wxString text;
+		bool convertText = false;
+
+		switch (column.m_fileType)
+		{
+		case eTransferGuid:
+		case eTransferReference:
+		{
+			std::array<unsigned char, 16> guidBytes;
+			dataStream.Read8(guidBytes.data(), guidBytes.size());
+			Guid guid(guidBytes);
+			if (column.m_bGuid || (column.m_attribute != NULL && GetTransferType(column.m_attribute) == eTransferReference)) {
+				field.m_guid = guid;
+				field.m_bNull = !guid.isValid();
+			}
+			else {
+				text = guid.str(); convertText = true;
+			}
+			break;
+		}
+		case eTransferBoolean:
+		{
+			bool value = dataStream.Read8() != 0;
+			if (column.m_attribute != NULL && column.m_attribute->GetTypeObject() == eValueTypes::TYPE_BOOLEAN) {
+				field.m_value = value;
+			}
+			else {
+				text = value ? wxT("true") : wxT("false"); convertText = true;
+			}
+			break;
+		}
+		case eTransferDate:
+		{
+			wxDateTime value(wxLongLong(dataStream.Read64()));
+			if (column.m_attribute != NULL && column.m_attribute->GetTypeObject() == eValueTypes::TYPE_DATE) {
+				field.m_value = value;
+			}
+			else {
+				text = value.Format(transferDateFormat); convertText = true;
+			}
+			break;
+		}
+		case eTransferNumber:
+		case eTransferString:
+			text = dataStream.ReadString(); convertText = true;
+			break;
+		default:
+			CSystemObjects::Message(_("The data file is damaged"), eStatusMessage::eStatusMessage_Error);
+			return false;
+		}
+
+		if (convertText && !ParseText(column, text, field)) {
+			validRow = false;
+		}
+	}
+
+	if (!dataStream.IsOk()) {
+		CSystemObjects::Message(_("The data file is damaged"), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	return true;
+}
+
+bool CObjectDataTransfer::ParseText(const column_t &column, const wxString &text, field_t &field)
+{
+	field.m_bNull = true;
+
+	if (!column.m_bGuid && column.m_attribute == NULL)
+		return true;
+
+	wxString value = text;
+
+	//strings keep their spaces
+	if (column.m_bGuid || column.m_attribute->GetTypeObject() != eValueTypes::TYPE_STRING) {
+		value.Trim(true).Trim(false);
+		if (value.IsEmpty())
+			return true;
+	}
+
+	bool succeeded = true;
+
+	if (column.m_bGuid) {
+		field.m_guid = Guid(value);
+		succeeded = field.m_guid.isValid();
+	}
+	else {
+		switch (column.m_attribute->GetTypeObject())
+		{
+		case eValueTypes::TYPE_BOOLEAN:
+			if (value.CmpNoCase(wxT("true")) == 0 || value == wxT("1")) field.m_value = true;
+			else if (value.CmpNoCase(wxT("false")) == 0 || value == wxT("0")) field.m_value = false;
+			else succeeded = false;
+			break;
+		case eValueTypes::TYPE_NUMBER:
+		{
+			std::wstring numberText = value.ToStdWstring();
+			const wchar_t *afterNumber = NULL; bool numberRead = false;
+			number_t number;
+			succeeded = number.FromString(numberText.c_str(), 10, &afterNumber, &numberRead) == 0
+				&& numberRead && *afterNumber == L'\0';
+			field.m_value = number;
+			break;
+		}
+		case eValueTypes::TYPE_DATE:
+		{
+			wxDateTime dateTime;
+			succeeded = dateTime.ParseFormat(value, transferDateFormat)
+				|| dateTime.ParseFormat(value, wxT("%d.%m.%Y"))
+				|| dateTime.ParseISOCombined(value, wxT(' '))
+				|| dateTime.ParseISODate(value);
+			field.m_value = dateTime;
+			break;
+		}
+		case eValueTypes::TYPE_STRING:
+			field.m_value = value;
+			break;
+		default:
+			succeeded = ParseReference(column.m_attribute->GetTypeObject(), value, field.m_guid);
+		}
+	}
+
+	if (!succeeded) {
+		CSystemObjects::Message(wxString::Format(_("Row %u: \"%s\" is not a valid value of \"%s\""),
+			m_nRows + m_nSkipped + 1, text, column.m_name), eStatusMessage::eStatusMessage_Warning);
+		return false;
+	}
+
+	field.m_bNull = false;
+	return true;
+}
+
+bool CObjectDataTransfer::ParseReference(meta_identifier_t id, const wxString &text, Guid &guid)
+{
+	//guids as written by the export
+	if (text.length() == 36) {
+		guid = Guid(text);
+		if (guid.isValid())
+			return true;
+	}
+
+	referenceMap_t &aCodes = GetReferenceMap(id);
+
+	IMetaObjectRefValue *refObject = NULL;
+	IMetaObject *metaObject = m_metaData->GetMetaObject(id);
+	if (metaObject == NULL || !metaObject->ConvertToValue(refObject))
+		return false;
+
+	auto foundedIt = aCodes.find(GetCodeKey(refObject->isEnumeration() ? NULL : refObject->GetAttributeForCode(), text));
+	if (foundedIt == aCodes.end())
+		return false;
+
+	guid = foundedIt->second;
+	return true;
+}
+
+void CObjectDataTransfer::BindRow(PreparedStatement *statement, const std::vector<field_t> &aFields)
+{
+	int position = 1;
+
+	if (m_metaObject != NULL) {
+		Guid rowGuid;
+		std::wstring codeKey;
+
+		IMetaAttributeObject *codeAttribute = m_metaObject->GetAttributeForCode();
+
+		for (unsigned int col = 0; col < m_aColumns.size(); col++) {
+			const column_t &column = m_aColumns[col];
+			if (aFields[col].m_bNull)
+				continue;
+			if (column.m_bGuid) {
+				rowGuid = aFields[col].m_guid;
+			}
+			else if (codeAttribute != NULL && column.m_attribute == codeAttribute) {
+				codeKey = GetCodeKey(codeAttribute, aFields[col].m_value.GetString());
+			}
+		}
+
+		//rows without UUID are new objects
+		if (!rowGuid.isValid()) {
+			rowGuid = Guid::newGuid();
+		}
+
+		//later rows of the file may refer to this one by code
+		auto foundedIt = m_aReferences.find(m_metaObject->GetMetaID());
+		if (foundedIt != m_aReferences.end() && !codeKey.empty()) {
+			foundedIt->second.insert_or_assign(codeKey, rowGuid);
+		}
+
+		reference_t reference_impl{ m_metaObject->GetMetaID(), rowGuid };
+
+		CObjectRowMapper::SetParamGuid(statement, position++, rowGuid);
+		statement->SetParamBlob(position++, &reference_impl, sizeof(reference_t));
+
+		m_aWrittenGuids.push_back(rowGuid);
+	}
+
+	for (unsigned int col = 0; col < m_aColumns.size(); col++) {
+		const column_t &column = m_aColumns[col];
+		if (column.m_attribute == NULL)
+			continue;
+
+		const field_t &field = aFields[col];
+		if (field.m_bNull) {
+			statement->SetParamNull(position++);
+			continue;
+		}
+
+		switch (column.m_attribute->GetTypeObject())
+		{
+		case eValueTypes::TYPE_BOOLEAN: statement->SetParamBool(position, field.m_value.GetBoolean()); break;
+		case eValueTypes::TYPE_NUMBER: statement->SetParamNumber(position, field.m_value.GetNumber()); break;
+		case eValueTypes::TYPE_DATE: statement->SetParamDate(position, field.m_value.GetDate()); break;
+		case eValueTypes::TYPE_STRING: statement->SetParamString(position, field.m_value.GetString()); break;
+		default:
+		{
+			reference_t reference_impl{ column.m_attribute->GetTypeObject(), field.m_guid };
+			statement->SetParamBlob(position, &reference_impl, sizeof(reference_t));
+		}
+		}
+
+		position++;
+	}
+}
+
+bool CObjectDataTransfer::FlushWrite(PreparedStatement *statement)
+{
+	if (statement->ExecuteBatch() == DATABASE_LAYER_QUERY_RESULT_ERROR) {
+		CSystemObjects::Message(wxString::Format(_("Import is stopped: %s"), statement->GetErrorMessage()), eStatusMessage::eStatusMessage_Error);
+		return false;
+	}
+
+	//cache entries are dropped, other sessions learn about the change after the commit
+	if (m_metaObject != NULL) {
+		for (auto &guid : m_aWrittenGuids) {
+			objectCache->Invalidate(m_metaObject->GetMetaID(), guid);
+		}
+	}
+	else {
+		for (auto &column : m_aColumns) {
+			if (column.m_attribute != NULL) {
+				objectCache->Invalidate(column.m_attribute->GetMetaID());
+			}
+		}
+	}
+
+	m_aWrittenGuids.clear();
+	return true;
+}
+
+CObjectDataTransfer::referenceMap_t &CObjectDataTransfer::GetReferenceMap(meta_identifier_t id)
+{
+	auto foundedIt = m_aReferences.find(id);
+	if (foundedIt != m_aReferences.end())
+		return foundedIt->second;
+
+	referenceMap_t &aCodes = m_aReferences[id];
+
+	IMetaObjectRefValue *refObject = NULL;
+	IMetaObject *metaObject = m_metaData->GetMetaObject(id);
+	if (metaObject == NULL || !metaObject->ConvertToValue(refObject))
+		return aCodes;
+
+	if (refObject->isEnumeration()) {
+		for (auto enumeration : refObject->GetObjectEnums()) {
+			aCodes.insert_or_assign(GetCodeKey(NULL, enumeration->GetName()), enumeration->GetGuid());
+		}
+		return aCodes;
+	}
+
+	IMetaAttributeObject *codeAttribute = refObject->GetAttributeForCode();
+	if (codeAttribute == NULL)
+		return aCodes;
+
+	//one query for all the codes of the object
+	DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT %s, %s FROM %s;",
+		guidName, codeAttribute->GetFieldNameDB(), refObject->GetTableNameDB());
+
+	if (resultSet == NULL)
+		return aCodes;
+
+	while (resultSet->Next()) {
+		if (resultSet->IsFieldNull(2))
+			continue;
+		wxString code = codeAttribute->GetTypeObject() == eValueTypes::TYPE_NUMBER ?
+			wxString(resultSet->GetResultNumber(2).ToString()) : resultSet->GetResultString(2);
+		//the first object keeps a repeated code
+		aCodes.emplace(GetCodeKey(codeAttribute, code), CObjectRowMapper::GetResultGuid(resultSet, 1));
+	}
+
+	resultSet->Close();
+	return aCodes;
+}
+
+std::wstring CObjectDataTransfer::GetCodeKey(IMetaAttributeObject *attribute, const wxString &code) const
+{
+	wxString codeKey = code;
+	codeKey.Trim(true).Trim(false);
+
+	//names of enumerations do not depend on case
+	if (attribute == NULL)
+		return codeKey.Upper().ToStdWstring();
+
+	//numbers are compared by value
+	if (attribute->GetTypeObject() == eValueTypes::TYPE_NUMBER) {
+		number_t number;
+		if (number.FromString(codeKey.ToStdWstring().c_str()) == 0) {
+			return number.ToWString();
+		}
+	}
+
+	return codeKey.ToStdWstring();
+}
+
+void CObjectDataTransfer::ShowStatistics(const wxString &operation) const
+{
+	wxString objectName = m_metaObject != NULL ? m_metaObject->GetName() : _("constants");
+
+	wxString statistics = wxString::Format(_("%s of \"%s\": %u rows in %.2f s, %.0f rows per second"),
+		operation, objectName, m_nRows, m_elapsedTime / 1000.0, GetRowsPerSecond());
+
+	if (m_nSkipped > 0) {
+		statistics += wxString::Format(_(", %u rows skipped"), m_nSkipped);
+	}
+
+	CSystemObjects::Message(statistics);
+}
@@ -0,0 +1,100 @@
+#ifndef _OBJECT_DATA_TRANSFER_H__
+#define _OBJECT_DATA_TRANSFER_H__
+
+#include "compiler/value.h"
+#include "guid/guid.h"
+
+#include <unordered_map>
+
+class IMetadata;
+class IMetaAttributeObject;
+class IMetaObjectRefValue;
+
+class wxTextInputStream;
+class wxDataInputStream;
+
+//bulk import and export of object rows.
+//*.csv files are text with a header of attribute names, other files use the binary format.
+//rows are written by batches of upserts, many rows in one transaction
+class CObjectDataTransfer {
+public:
+
+	//rows of a catalog or a document
+	CObjectDataTransfer(IMetaObjectRefValue *metaObject);
+	//row of the constants
+	CObjectDataTransfer(IMetadata *metaData);
+
+	bool ImportData(const wxString &fileName);
+	bool ExportData(const wxString &fileName);
+
+	//rows written in one transaction
+	void SetCommitSize(unsigned int commitSize) { m_commitSize = commitSize; }
+	unsigned int GetCommitSize() const { return m_commitSize; }
+
+	//statistics of the last run
+	unsigned int GetRowCount() const { return m_nRows; }
+	unsigned int GetSkippedCount() const { return m_nSkipped; }
+	long GetElapsedTime() const { return m_elapsedTime; }
+	double GetRowsPerSecond() const;
+
+private:
+
+	struct column_t {
+		wxString m_name;
+		//NULL for UUID and unknown columns
+		IMetaAttributeObject *m_attribute;
+		bool m_bGuid;
+		//type tag of the binary file
+		unsigned char m_fileType;
+	};
+
+	struct field_t {
+		bool m_bNull;
+		CValue m_value;
+		Guid m_guid;
+	};
+
+	typedef std::unordered_map<std::wstring, Guid> referenceMap_t;
+
+	//header of the file
+	bool PrepareColumns(const std::vector<wxString> &aNames);
+	wxString GetWriteQuery() const;
+
+	//rows of the file
+	bool ReadTextRow(wxTextInputStream &textStream, wxChar separator, std::vector<wxString> &aValues) const;
+	bool ReadBinaryRow(wxDataInputStream &dataStream, std::vector<field_t> &aFields, bool &validRow, bool &endOfData);
+
+	bool ParseText(const column_t &column, const wxString &text, field_t &field);
+	bool ParseReference(meta_identifier_t id, const wxString &text, Guid &guid);
+
+	void BindRow(PreparedStatement *statement, const std::vector<field_t> &aFields);
+	bool FlushWrite(PreparedStatement *statement);
+
+	//code -> guid of the referenced objects, one query for each object
+	referenceMap_t &GetReferenceMap(meta_identifier_t id);
+	std::wstring GetCodeKey(IMetaAttributeObject *attribute, const wxString &code) const;
+
+	void ShowStatistics(const wxString &operation) const;
+
+private:
+
+	IMetadata *m_metaData;
+	IMetaObjectRefValue *m_metaObject;
+
+	wxString m_tableName;
+	std::vector<IMetaAttributeObject *> m_aAttributes;
+
+	std::vector<column_t> m_aColumns;
+	std::map<meta_identifier_t, referenceMap_t> m_aReferences;
+
+	//guids of the written rows, their cache entries are dropped on commit
+	std::vector<Guid> m_aWrittenGuids;
+
+	unsigned int m_commitSize;
+
+	unsigned int m_nRows;
+	unsigned int m_nSkipped;
+	long m_elapsedTime;
+};
+
+#endif
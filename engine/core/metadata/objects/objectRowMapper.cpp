@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////
+//	Author		: Maxim Kornienko
+//	Description : object row mapper
+////////////////////////////////////////////////////////////////////////////
+
+#include "objectRowMapper.h"
+#include "metadata/objects/baseObject.h"
+#include "databaseLayer/databaseLayer.h"
+#include "appData.h"
+
+CObjectRowMapper::CObjectRowMapper(IMetadata *metaData, const std::vector<IMetaAttributeObject *> &aAttributes, bool emptyReferences) :
+	m_metaData(metaData), m_bEmptyReferences(emptyReferences), m_guidPosition(wxNOT_FOUND), m_refPosition(wxNOT_FOUND)
+{
+	for (auto attribute : aAttributes) {
+		column_t column;
+		column.m_id = attribute->GetMetaID();
+		column.m_typeObject = attribute->GetTypeObject();
+		column.m_fieldName = attribute->GetFieldNameDB().Upper();
+		column.m_position = wxNOT_FOUND;
+		m_aColumns.push_back(column);
+	}
+}
+
+void CObjectRowMapper::Prepare(DatabaseResultSet *resultSet)
+{
+	std::map<wxString, int> aPositions;
+
+	ResultSetMetaData *resultSetMetadata = resultSet->GetMetaData();
+	if (resultSetMetadata != NULL) {
+		for (int col = 1; col <= resultSetMetadata->GetColumnCount(); col++) {
+			aPositions.insert_or_assign(resultSetMetadata->GetColumnName(col).Upper(), col);
+		}
+		resultSet->CloseMetaData(resultSetMetadata);
+	}
+
+	//columns missing in the query are left empty
+	for (auto &column : m_aColumns) {
+		auto foundedIt = aPositions.find(column.m_fieldName);
+		column.m_position = foundedIt != aPositions.end() ? foundedIt->second : wxNOT_FOUND;
+	}
+
+	auto foundedGuid = aPositions.find(guidName);
+	m_guidPosition = foundedGuid != aPositions.end() ? foundedGuid->second : wxNOT_FOUND;
+
+	auto foundedRef = aPositions.find(guidRef);
+	m_refPosition = foundedRef != aPositions.end() ? foundedRef->second : wxNOT_FOUND;
+}
+
+void CObjectRowMapper::ReadRow(DatabaseResultSet *resultSet, std::map<meta_identifier_t, CValue> &aObjectValues) const
+{
+	for (auto &column : m_aColumns) {
+		if (column.m_position == wxNOT_FOUND)
+			continue;
+
+		switch (column.m_typeObject)
+		{
+		case eValueTypes::TYPE_BOOLEAN:
+			aObjectValues[column.m_id] = resultSet->GetResultBool(column.m_position); break;
+		case eValueTypes::TYPE_NUMBER:
+			//decimal columns are decoded exactly, without double
+			aObjectValues[column.m_id] = resultSet->GetResultNumber(column.m_position); break;
+		case eValueTypes::TYPE_DATE:
+			aObjectValues[column.m_id] = resultSet->GetResultDate(column.m_position); break;
+		case eValueTypes::TYPE_STRING:
+			aObjectValues[column.m_id] = resultSet->GetResultString(column.m_position); break;
+		default:
+		{
+			wxMemoryBuffer bufferData;
+			resultSet->GetResultBlob(column.m_position, bufferData);
+			if (!bufferData.IsEmpty()) {
+				aObjectValues[column.m_id] = CValueReference::CreateFromPtr(
+					m_metaData, bufferData.GetData()
+				);
+			}
+			else if (m_bEmptyReferences) {
+				aObjectValues[column.m_id] = new CValueReference(
+					m_metaData, column.m_typeObject
+				);
+			}
+			break;
+		}
+		}
+	}
+}
+
+Guid CObjectRowMapper::ReadGuid(DatabaseResultSet *resultSet) const
+{
+	if (m_guidPosition == wxNOT_FOUND)
+		return Guid();
+
+	return GetResultGuid(resultSet, m_guidPosition);
+}
+
+bool CObjectRowMapper::ReadReference(DatabaseResultSet *resultSet, wxMemoryBuffer &bufferData) const
+{
+	if (m_refPosition == wxNOT_FOUND)
+		return false;
+
+	resultSet->GetResultBlob(m_refPosition, bufferData);
+	return !bufferData.IsEmpty();
+}
+
+Guid CObjectRowMapper::GetResultGuid(DatabaseResultSet *resultSet, int position)
+{
+	wxMemoryBuffer bufferData;
+	resultSet->GetResultBlob(position, bufferData);
+	if (bufferData.GetDataLen() != 16)
+		return Guid();
+
+	std::array<unsigned char, 16> guidBytes;
+	memcpy(guidBytes.data(), bufferData.GetData(), guidBytes.size());
+	return Guid(guidBytes);
+}
+
+Guid CObjectRowMapper::GetResultGuid(DatabaseResultSet *resultSet, const wxString &fieldName)
+{
+	return GetResultGuid(resultSet, resultSet->LookupField(fieldName));
+}
+
+void CObjectRowMapper::SetParamGuid(PreparedStatement *statement, int position, const Guid &guid)
+{
+	statement->SetParamBlob(position, guid.bytes().data(), guid.bytes().size());
+}
+
+wxString CObjectRowMapper::GetGuidLiteral(const Guid &guid)
+{
+	//the digits of str() go in the order of the bytes
+	wxString hexText = guid.str();
+	hexText.Replace(wxT("-"), wxEmptyString);
+	return databaseLayer->GetDialect()->GetBinaryLiteral(hexText);
+}
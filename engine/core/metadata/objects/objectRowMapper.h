@@ -0,0 +1,53 @@
+#ifndef _OBJECT_ROW_MAPPER_H__
+#define _OBJECT_ROW_MAPPER_H__
+
+#include "compiler/value.h"
+#include "guid/guid.h"
+
+class IMetadata;
+class IMetaAttributeObject;
+
+//reads rows of an object table by column position.
+//positions are found once per result set, not per field and row
+class CObjectRowMapper {
+public:
+
+	CObjectRowMapper(IMetadata *metaData, const std::vector<IMetaAttributeObject *> &aAttributes, bool emptyReferences = true);
+
+	//find the columns of the query, before the first row
+	void Prepare(DatabaseResultSet *resultSet);
+
+	//attributes of the current row
+	void ReadRow(DatabaseResultSet *resultSet, std::map<meta_identifier_t, CValue> &aObjectValues) const;
+
+	//UUID and UUIDREF of the current row
+	Guid ReadGuid(DatabaseResultSet *resultSet) const;
+	bool ReadReference(DatabaseResultSet *resultSet, wxMemoryBuffer &bufferData) const;
+
+	//guid columns are 16 bytes, also outside of object rows
+	static Guid GetResultGuid(DatabaseResultSet *resultSet, int position);
+	static Guid GetResultGuid(DatabaseResultSet *resultSet, const wxString &fieldName);
+	static void SetParamGuid(PreparedStatement *statement, int position, const Guid &guid);
+	//guid as a binary literal of the database dialect, for queries without parameters
+	static wxString GetGuidLiteral(const Guid &guid);
+
+private:
+
+	struct column_t {
+		meta_identifier_t m_id;
+		meta_identifier_t m_typeObject;
+		wxString m_fieldName;
+		int m_position;
+	};
+
+	IMetadata *m_metaData;
+	std::vector<column_t> m_aColumns;
+
+	//attribute of a reference type without value gets an empty reference
+	bool m_bEmptyReferences;
+
+	int m_guidPosition;
+	int m_refPosition;
+};
+
+#endif
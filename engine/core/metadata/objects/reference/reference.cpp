@@ -6,6 +6,7 @@
 #include "reference.h"
 #include "metadata/metadata.h"
 #include "metadata/objects/baseObject.h"
+#include "metadata/objects/objectCache.h"
 #include "metadata/objects/tabularSection/tabularSection.h"
 #include "databaseLayer/databaseLayer.h"
 #include "compiler/methods.h"
@@ -22,6 +23,15 @@ void CValueReference::PrepareReference()
 	wxASSERT(m_metaObject != NULL);
 	wxASSERT(m_reference_impl == NULL);
 	m_reference_impl = new reference_t(m_metaObject->GetMetaID(), m_objGuid);
+}
+
+void CValueReference::LoadReference()
+{
+	if (m_bLoadedRef || !m_metaObject)
+		return;
+
+	m_bLoadedRef = true;
+
 	if (IsEmpty()) {
 		//attrbutes can refValue 
 		for (auto attribute : m_metaObject->GetObjectAttributes()) {
@@ -43,21 +53,34 @@ void CValueReference::PrepareReference()
 		}
 	}
 	else {
-		m_bNewObject = false;
-		if (ReadReferenceInDB()) {
-			m_bFoundedRef = true;
-		}
+		m_bFoundedRef = ReadReferenceInDB();
+	}
+}
+
+void CValueReference::LoadTabularSection(meta_identifier_t id)
+{
+	LoadReference();
+
+	if (!m_bFoundedRef || m_aLoadedTables.find(id) != m_aLoadedTables.end())
+		return;
+
+	CValueTabularRefSection *tabularSection =
+		dynamic_cast<CValueTabularRefSection *>(IObjectValueInfo::GetTableByMetaID(id));
+
+	if (tabularSection) {
+		m_aLoadedTables.insert(id);
+		tabularSection->LoadDataFromDB();
 	}
 }
 
 CValueReference::CValueReference(IMetadata *metaData, meta_identifier_t id, const Guid &objGuid) : CValue(eValueTypes::TYPE_VALUE, true), IObjectValueInfo(objGuid, !objGuid.isValid()),
-m_metaObject(wxStaticCast(metaData->GetMetaObject(id), IMetaObjectRefValue)), m_methods(new CMethods()), m_reference_impl(NULL), m_bFoundedRef(false)
+m_metaObject(wxStaticCast(metaData->GetMetaObject(id), IMetaObjectRefValue)), m_methods(new CMethods()), m_reference_impl(NULL), m_bFoundedRef(false), m_bLoadedRef(false), m_bPresentationRef(false)
 {
 	PrepareReference();
 }
 
 CValueReference::CValueReference(IMetaObjectRefValue *metaObject, const Guid &objGuid) : CValue(eValueTypes::TYPE_VALUE, true), IObjectValueInfo(objGuid, !objGuid.isValid()),
-m_metaObject(metaObject), m_methods(new CMethods()), m_reference_impl(NULL), m_bFoundedRef(false)
+m_metaObject(metaObject), m_methods(new CMethods()), m_reference_impl(NULL), m_bFoundedRef(false), m_bLoadedRef(false), m_bPresentationRef(false)
 {
 	PrepareReference();
 }
@@ -94,6 +117,16 @@ void CValueReference::GetBinaryData(int nPosition, DatabaseResultSet *databaseRe
 
 		m_metaObject = dynamic_cast<IMetaObjectRefValue *>(metadata->GetMetaObject(tempReference->m_id));
 		m_objGuid = tempReference->m_guid;
+		m_bNewObject = !m_objGuid.isValid();
+
+		//values of the previous reference are read again on demand
+		m_aObjectValues.clear();
+		m_aObjectTables.clear();
+		m_aLoadedTables.clear();
+
+		m_bFoundedRef = m_bLoadedRef = m_bPresentationRef = false;
+
+		wxDELETE(m_reference_impl);
 
 		if (m_metaObject) {
 			m_reference_impl = new reference_t(tempReference->m_id, tempReference->m_guid);
@@ -107,6 +140,11 @@ void CValueReference::SetValueByMetaID(meta_identifier_t id, const CValue &cVal)
 
 CValue CValueReference::GetValueByMetaID(meta_identifier_t id) const
 {
+	CValueReference *reference = const_cast<CValueReference *>(this);
+
+	reference->LoadReference();
+	reference->LoadTabularSection(id);
+
 	auto foundedIt = m_aObjectValues.find(id);
 	wxASSERT(foundedIt != m_aObjectValues.end());
 	if (foundedIt != m_aObjectValues.end()) {
@@ -116,6 +154,12 @@ CValue CValueReference::GetValueByMetaID(meta_identifier_t id) const
 	return CValue();
 }
 
+IValueTabularSection *CValueReference::GetTableByMetaID(meta_identifier_t id) const
+{
+	const_cast<CValueReference *>(this)->LoadTabularSection(id);
+	return IObjectValueInfo::GetTableByMetaID(id);
+}
+
 IMetaObjectValue *CValueReference::GetMetaObject() const
 {
 	return m_metaObject;
@@ -176,13 +220,27 @@ wxString CValueReference::GetString() const
 
 	wxASSERT(m_metaObject);
 
+	wxString presentation;
+
+	if (objectCache->GetPresentation(m_metaObject->GetMetaID(), m_objGuid, presentation)) {
+		return presentation;
+	}
+
+	if (m_bPresentationRef) {
+		return m_presentation;
+	}
+
+	const_cast<CValueReference *>(this)->LoadReference();
+
 	if (!m_bFoundedRef) {
 		wxString nullRef;
 		nullRef << _("not found <") << m_metaObject->GetMetaID() << wxT(":") + m_objGuid.str() << wxT(">");
 		return nullRef;
 	}
 
-	return m_metaObject->GetDescription(this);
+	presentation = m_metaObject->GetDescription(this);
+	objectCache->PutPresentation(m_metaObject->GetMetaID(), m_objGuid, presentation);
+	return presentation;
 }
 
 wxString CValueReference::GetTypeString() const
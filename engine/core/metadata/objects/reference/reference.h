@@ -4,14 +4,17 @@
 #include "compiler/value.h"
 #include "common/valueInfo.h"
 
+#include <set>
+
 class CValueTabularRefSection;
+class CObjectRowMapper;
 
 class CValueReference : public CValue,
 	public IObjectValueInfo
 {
 	wxDECLARE_DYNAMIC_CLASS(CValueReference);
 private:
-	CValueReference() : CValue() {}
+	CValueReference() : CValue(), m_methods(new CMethods()), m_metaObject(NULL), m_reference_impl(NULL), m_bFoundedRef(false), m_bLoadedRef(false), m_bPresentationRef(false) {}
 public:
 
 	CValueReference(IMetadata *metaData, meta_identifier_t metaID, const Guid &objGuid = Guid());
@@ -20,6 +23,20 @@ public:
 
 	static CValue CreateFromPtr(IMetadata *metaData, void *ptr);
 
+	//presentations of the references held in the rows (maps of id -> value) are read 
+	//with one query per table and only the columns of the description, e.g. for a page of a list
+	template <typename rowType>
+	static void PrepareReferences(const std::vector<rowType> &aRows)
+	{
+		std::vector<CValueReference *> aReferences;
+		for (auto &rowValues : aRows) {
+			for (auto &colValue : rowValues) {
+				AppendReference(colValue.second, aReferences);
+			}
+		}
+		LoadPresentations(aReferences);
+	}
+
 	//operator '=='
 	virtual inline bool CompareValueEQ(const CValue &cParam) const
 	{
@@ -46,6 +63,9 @@ public:
 	virtual void SetValueByMetaID(meta_identifier_t id, const CValue &cVal);
 	virtual CValue GetValueByMetaID(meta_identifier_t id) const;
 
+	//support tabular section 
+	virtual IValueTabularSection *GetTableByMetaID(meta_identifier_t id) const;
+
 	//get metadata from object 
 	virtual IMetaObjectValue *GetMetaObject() const;
 
@@ -94,12 +114,29 @@ private:
 	void PrepareReference();
 	bool ReadReferenceInDB();
 
+	void ReadValues(DatabaseResultSet *resultSet, const CObjectRowMapper &rowMapper);
+	void PrepareTables();
+
+	static void AppendReference(const CValue &cValue, std::vector<CValueReference *> &aReferences);
+	static void LoadPresentations(const std::vector<CValueReference *> &aReferences);
+
+	//data is read on first access, a reference itself is only meta id and guid
+	void LoadReference();
+	void LoadTabularSection(meta_identifier_t id);
+
 protected:
 	CMethods *m_methods;
 	IMetaObjectRefValue *m_metaObject;
 	reference_t *m_reference_impl;
 
 	bool m_bFoundedRef;
+	bool m_bLoadedRef;
+
+	//description read by PrepareReferences, the row itself is not loaded
+	wxString m_presentation;
+	bool m_bPresentationRef;
+
+	std::set<meta_identifier_t> m_aLoadedTables;
 };
 
 #endif 
\ No newline at end of file
@@ -35,6 +35,6 @@ CValue CValueReference::GetAttribute(attributeArg_t &aParams)
 		return new CValueReference(m_metaObject, m_objGuid);
 	}
 	else {
-		return m_aObjectValues[id];
+		return GetValueByMetaID(id);
 	}
 }
\ No newline at end of file
@@ -6,176 +6,230 @@
 #include "reference.h"
 #include "appData.h"
 #include "metadata/objects/baseObject.h"
+#include "metadata/objects/objectCache.h"
+#include "metadata/objects/objectRowMapper.h"
 #include "metadata/objects/tabularSection/tabularSection.h"
 #include "databaseLayer/databaseLayer.h"
 #include "utils/stringUtils.h"
 
+void CValueReference::ReadValues(DatabaseResultSet *resultSet, const CObjectRowMapper &rowMapper)
+{
+	rowMapper.ReadRow(resultSet, m_aObjectValues);
+}
+
+void CValueReference::PrepareTables()
+{
+	//tabular sections are read on first access
+	for (auto currTable : m_metaObject->GetObjectTables()) {
+		CValueTabularRefSection *tabularSection =
+			new CValueTabularRefSection(this, currTable);
+		m_aObjectValues[currTable->GetMetaID()] = tabularSection;
+		m_aObjectTables.push_back(tabularSection);
+	}
+}
+
 bool CValueReference::ReadReferenceInDB()
 {
 	if (!m_metaObject || !m_objGuid.isValid())
 		return false;
-	wxString tableName = m_metaObject->GetTableNameDB();
-	if (databaseLayer->TableExists(tableName)) {
-		bool isLoaded = false;
-		wxString sql = "SELECT FIRST 1 * FROM " + tableName + " WHERE UUID = '" + m_objGuid.str() + "';";
+
+	//row read a moment ago by this session
+	bool isLoaded = objectCache->GetValues(m_metaObject->GetMetaID(), m_objGuid, m_aObjectValues);
+
+	if (!isLoaded) {
+		wxString tableName = m_metaObject->GetTableNameDB();
+		if (!databaseLayer->TableExists(tableName))
+			return false;
+
+		wxString sql = databaseLayer->GetDialect()->GetSelectLimit("* FROM " + tableName + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_objGuid), 1) + ";";
 		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(sql);
 
 		if (!resultSet)
 			return false;
 
-		for (auto currTable : m_metaObject->GetObjectTables()) {
-			CValueTabularRefSection *tabularSection =
-				new CValueTabularRefSection(this, currTable);
-			m_aObjectValues[currTable->GetMetaID()] = tabularSection;
-			m_aObjectTables.push_back(tabularSection);
-		}
-
 		if (resultSet->Next()) {
-			//load attributes 
-			for (auto attribute : m_metaObject->GetObjectAttributes()) {
-				wxString nameAttribute = attribute->GetFieldNameDB();
-				switch (attribute->GetTypeObject())
-				{
-				case eValueTypes::TYPE_BOOLEAN:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultBool(nameAttribute); break;
-				case eValueTypes::TYPE_NUMBER:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultNumber(nameAttribute); break;
-				case eValueTypes::TYPE_DATE:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultDate(nameAttribute); break;
-				case eValueTypes::TYPE_STRING:
-					m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultString(nameAttribute); break;
-				default:
-				{
-					wxMemoryBuffer bufferData;
-					resultSet->GetResultBlob(nameAttribute, bufferData);
-					if (!bufferData.IsEmpty()) {
-						m_aObjectValues[attribute->GetMetaID()] = CValueReference::CreateFromPtr(
-							m_metaObject->GetMetadata(), bufferData.GetData()
-						);
-					}
-					else {
-						m_aObjectValues[attribute->GetMetaID()] = new CValueReference(
-							m_metaObject->GetMetadata(), attribute->GetTypeObject()
-						);
-					}
-					break;
-				}
-				}
-			}
+			CObjectRowMapper rowMapper(m_metaObject->GetMetadata(), m_metaObject->GetObjectAttributes());
+			rowMapper.Prepare(resultSet);
+			ReadValues(resultSet, rowMapper);
 			isLoaded = true;
-			for (auto tabularSection : m_aObjectTables) {
-				if (!tabularSection->LoadDataFromDB()) {
-					isLoaded = false;
-				}
-			}
 		}
 		resultSet->Close();
-		return isLoaded;
+
+		if (isLoaded) {
+			objectCache->PutValues(m_metaObject->GetMetaID(), m_objGuid, m_aObjectValues);
+		}
 	}
-	return false;
+
+	PrepareTables();
+	return isLoaded;
 }
 
-bool CValueReference::FindValue(const wxString &findData, std::vector<CValue>& foundedObjects)
+//Firebird allows up to 1500 values in IN
+#define maxBatchReferences 500
+
+//row of the description columns only, passed to GetDescription
+class CPresentationRow : public IObjectValueInfo {
+public:
+	CPresentationRow(IMetaObjectRefValue *metaObject, const Guid &guid) : IObjectValueInfo(guid, false), m_metaObject(metaObject) {}
+
+	virtual CValue GetValueByMetaID(meta_identifier_t id) const
+	{
+		auto foundedIt = m_aObjectValues.find(id);
+		if (foundedIt != m_aObjectValues.end())
+			return foundedIt->second;
+		return CValue();
+	}
+
+	virtual IMetaObjectValue *GetMetaObject() const { return m_metaObject; }
+
+	std::map<meta_identifier_t, CValue> &GetValues() { return m_aObjectValues; }
+
+private:
+	IMetaObjectRefValue *m_metaObject;
+};
+
+void CValueReference::LoadPresentations(const std::vector<CValueReference *> &aReferences)
 {
-	class CObjectComparatorValue : public IObjectValueInfo {
-		bool ReadValues()
-		{
-			if (!m_metaObject || m_bNewObject)
-				return false;
-			wxString tableName = m_metaObject->GetTableNameDB();
-			if (databaseLayer->TableExists(tableName)) {
-				wxString queryText = "SELECT FIRST 1 * FROM " + tableName + " WHERE UUID = '" + m_objGuid.str() + "';";
-				DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(queryText);
-				if (!resultSet) {
-					return false;
-				}
-				if (resultSet->Next()) {
-					//load other attributes 
-					for (auto attribute : m_metaObject->GetObjectAttributes()) {
-						wxString nameAttribute = attribute->GetFieldNameDB();
-						switch (attribute->GetTypeObject())
-						{
-						case eValueTypes::TYPE_BOOLEAN:
-							m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultBool(nameAttribute); break;
-						case eValueTypes::TYPE_NUMBER:
-							m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultNumber(nameAttribute); break;
-						case eValueTypes::TYPE_DATE:
-							m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultDate(nameAttribute); break;
-						case eValueTypes::TYPE_STRING:
-							m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultString(nameAttribute); break;
-						default:
-						{
-							wxMemoryBuffer bufferData;
-							resultSet->GetResultBlob(nameAttribute, bufferData);
-							if (!bufferData.IsEmpty()) {
-								m_aObjectValues[attribute->GetMetaID()] = CValueReference::CreateFromPtr(
-									m_metaObject->GetMetadata(), bufferData.GetData()
-								);
-							}
-							else {
-								m_aObjectValues[attribute->GetMetaID()] = new CValueReference(
-									m_metaObject->GetMetadata(), attribute->GetTypeObject()
-								);
-							}
-							break;
-						}
-						}
-					}
+	std::map<IMetaObjectRefValue *, std::map<Guid, std::vector<CValueReference *>>> aBatches;
+
+	wxString presentation;
+	for (auto reference : aReferences) {
+		if (reference->m_bPresentationRef || reference->IsEmpty() || !reference->m_metaObject)
+			continue;
+		if (objectCache->GetPresentation(reference->m_metaObject->GetMetaID(), reference->m_objGuid, presentation))
+			continue;
+		aBatches[reference->m_metaObject][reference->m_objGuid].push_back(reference);
+	}
+
+	for (auto &batch : aBatches) {
+		IMetaObjectRefValue *metaObject = batch.first;
+		std::vector<IMetaAttributeObject *> aAttributes = metaObject->GetPresentationAttributes();
+
+		//nothing to read, e.g. enumerations are described by the guid
+		if (aAttributes.empty()) {
+			for (auto &guidReferences : batch.second) {
+				CPresentationRow presentationRow(metaObject, guidReferences.first);
+				presentation = metaObject->GetDescription(&presentationRow);
+				objectCache->PutPresentation(metaObject->GetMetaID(), guidReferences.first, presentation);
+				for (auto reference : guidReferences.second) {
+					reference->m_presentation = presentation;
+					reference->m_bPresentationRef = true;
 				}
-				resultSet->Close();
-				return true;
 			}
-			return false;
+			continue;
+		}
+
+		wxString tableName = metaObject->GetTableNameDB();
+		if (!databaseLayer->TableExists(tableName))
+			continue;
+
+		wxString columns = guidName;
+		for (auto attribute : aAttributes) {
+			columns += wxT(", ") + attribute->GetFieldNameDB();
 		}
 
-		IMetaObjectRefValue *m_metaObject;
-
-	private:
-		CObjectComparatorValue(IMetaObjectRefValue *metaObject, const Guid &guid) : IObjectValueInfo(guid, false), m_metaObject(metaObject) {}
-	public:
-
-		static bool CompareValue(const wxString &findData, IMetaObjectRefValue *metaObject, const Guid &guid) {
-			bool allow = false;
-			CObjectComparatorValue *comparator = new CObjectComparatorValue(metaObject, guid);
-			if (comparator->ReadValues()) {
-				for (auto attribute : metaObject->GetSearchedAttributes()) {
-					wxString fieldCompare = comparator->m_aObjectValues[attribute->GetMetaID()].GetString();
-					if (fieldCompare.Contains(findData)) {
-						allow = true; break;
-					}
+		CObjectRowMapper rowMapper(metaObject->GetMetadata(), aAttributes);
+
+		auto itGuid = batch.second.begin();
+		while (itGuid != batch.second.end()) {
+			wxString guids; size_t count = 0;
+			for (; itGuid != batch.second.end() && count < maxBatchReferences; itGuid++, count++) {
+				if (count > 0) {
+					guids += wxT(", ");
 				}
+				guids += CObjectRowMapper::GetGuidLiteral(itGuid->first);
 			}
-			if (!allow) {
-				wxString fieldCompare = metaObject->GetDescription(comparator);
-				if (fieldCompare.Contains(findData)) {
-					allow = true; 
+
+			//references without a row are read one by one when shown and get "not found"
+			DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT %s FROM %s WHERE UUID IN (%s);", columns, tableName, guids);
+			if (!resultSet)
+				continue;
+
+			rowMapper.Prepare(resultSet);
+			while (resultSet->Next()) {
+				auto foundedIt = batch.second.find(rowMapper.ReadGuid(resultSet));
+				if (foundedIt == batch.second.end())
+					continue;
+				CPresentationRow presentationRow(metaObject, foundedIt->first);
+				rowMapper.ReadRow(resultSet, presentationRow.GetValues());
+				presentation = metaObject->GetDescription(&presentationRow);
+				objectCache->PutPresentation(metaObject->GetMetaID(), foundedIt->first, presentation);
+				for (auto reference : foundedIt->second) {
+					reference->m_presentation = presentation;
+					reference->m_bPresentationRef = true;
 				}
 			}
-			wxDELETE(comparator);
-			return allow;
+			resultSet->Close();
 		}
+	}
+}
+
+void CValueReference::AppendReference(const CValue &cValue, std::vector<CValueReference *> &aReferences)
+{
+	CValueReference *reference = dynamic_cast<CValueReference *>(cValue.GetRef());
+	//rows read already describe the reference without a query
+	if (reference && !reference->m_bLoadedRef && !reference->m_bPresentationRef && !reference->IsEmpty()) {
+		aReferences.push_back(reference);
+	}
+}
 
-		//get metadata from object 
-		virtual IMetaObjectValue *GetMetaObject() const { return m_metaObject; };
-	};
+//input by string shows the first matches only
+#define maxFoundedReferences 50
 
-	wxString tableName = m_metaObject->GetTableNameDB();
-	if (databaseLayer->TableExists(tableName)) {
-		DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults("SELECT * FROM %s ORDER BY CAST(UUID AS VARCHAR(36)); ", tableName);
-		if (!resultSet) {
-			return false;
+bool CValueReference::FindValue(const wxString &findData, std::vector<CValue>& foundedObjects)
+{
+	if (!m_metaObject)
+		return false;
+
+	//presentation fields are matched by prefix, without case
+	wxString whereText; int nParams = 0;
+	for (auto attribute : m_metaObject->GetSearchedAttributes()) {
+		if (attribute->GetTypeObject() != eValueTypes::TYPE_STRING)
+			continue;
+		if (nParams++ > 0) {
+			whereText += wxT(" OR ");
 		}
+		whereText += databaseLayer->GetDialect()->GetStartsWith(wxT("UPPER(") + attribute->GetFieldNameDB() + wxT(")"));
+	}
+
+	if (nParams == 0)
+		return false;
+
+	wxString tableName = m_metaObject->GetTableNameDB();
+	if (!databaseLayer->TableExists(tableName))
+		return false;
+
+	IMetaAttributeObject *sortAttribute = m_metaObject->GetAttributeForSort();
+	wxString orderText = sortAttribute ? sortAttribute->GetFieldNameDB() + wxT(", UUID") : wxT("UUID");
+
+	PreparedStatement *statement = databaseLayer->PrepareStatement(databaseLayer->GetDialect()->GetSelectLimit(
+		wxT("* FROM ") + tableName + wxT(" WHERE ") + whereText + wxT(" ORDER BY ") + orderText, maxFoundedReferences) + wxT(";"));
+
+	if (!statement)
+		return false;
+
+	wxString searchText = findData.Upper();
+	for (int position = 1; position <= nParams; position++) {
+		statement->SetParamString(position, searchText);
+	}
+
+	//matches come with their rows, so presentations need no further queries
+	DatabaseResultSet *resultSet = statement->RunQueryWithResults();
+	if (resultSet) {
+		CObjectRowMapper rowMapper(m_metaObject->GetMetadata(), m_metaObject->GetObjectAttributes());
+		rowMapper.Prepare(resultSet);
 		while (resultSet->Next()) {
-			Guid currentGuid = resultSet->GetResultString(guidName); 
-			if (CObjectComparatorValue::CompareValue(findData, m_metaObject, currentGuid)) {
-				foundedObjects.push_back(
-					new CValueReference(m_metaObject, currentGuid)
-				);
-			}
+			CValueReference *reference = new CValueReference(m_metaObject, rowMapper.ReadGuid(resultSet));
+			reference->ReadValues(resultSet, rowMapper);
+			reference->m_bLoadedRef = reference->m_bFoundedRef = true;
+			//the cache gets the row only, the tabular sections belong to this reference
+			objectCache->PutValues(m_metaObject->GetMetaID(), reference->m_objGuid, reference->m_aObjectValues);
+			reference->PrepareTables();
+			foundedObjects.push_back(reference);
 		}
 		resultSet->Close();
-		return foundedObjects.size() > 0;
 	}
 
-	return false;
+	databaseLayer->CloseStatement(statement);
+	return foundedObjects.size() > 0;
 }
\ No newline at end of file
@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////
+//	Author		: Maxim Kornienko
+//	Description : restructuring plan of the configuration tables
+////////////////////////////////////////////////////////////////////////////
+
+#include "restructurePlan.h"
+#include "metadata/metaObjects/attributes/metaAttributeObject.h"
+#include "databaseLayer/databaseLayer.h"
+#include "appData.h"
+
+static bool IsScalarType(meta_identifier_t typeObject)
+{
+	return typeObject == eValueTypes::TYPE_BOOLEAN
+		|| typeObject == eValueTypes::TYPE_NUMBER
+		|| typeObject == eValueTypes::TYPE_DATE
+		|| typeObject == eValueTypes::TYPE_STRING;
+}
+
+//conversion of a value between different types, empty if the values can not be kept
+static wxString GetConvertText(IMetaAttributeObject *srcAttr, IMetaAttributeObject *dstAttr)
+{
+	IAttributeInfo::typeDescription_t srcType = srcAttr->GetTypeDescription();
+	meta_identifier_t dstTypeObject = dstAttr->GetTypeObject();
+
+	switch (srcType.GetTypeObject())
+	{
+	case eValueTypes::TYPE_STRING:
+		return wxString::Format(wxT("SUBSTRING(CAST(%%s AS VARCHAR(64)) FROM 1 FOR %i)"), srcType.GetLength());
+	case eValueTypes::TYPE_NUMBER:
+		if (dstTypeObject == eValueTypes::TYPE_BOOLEAN)
+			return wxString::Format(wxT("CAST(%%s AS %s)"), srcAttr->GetSQLTypeObject());
+		break;
+	case eValueTypes::TYPE_BOOLEAN:
+		if (dstTypeObject == eValueTypes::TYPE_NUMBER)
+			return wxT("CASE WHEN %s IS NULL THEN NULL WHEN %s <> 0 THEN 1 ELSE 0 END");
+		if (dstTypeObject == eValueTypes::TYPE_STRING)
+			return wxT("CASE WHEN %s IS NULL THEN NULL WHEN UPPER(TRIM(%s)) IN ('TRUE', '1') THEN 1 ELSE 0 END");
+		break;
+	}
+
+	//strings to numbers or dates may fail on any row
+	return wxEmptyString;
+}
+
+bool CRestructurePlan::PlanColumn(IMetaAttributeObject *srcAttr, IMetaAttributeObject *dstAttr, column_t &column)
+{
+	column.m_oldAttribute = dstAttr;
+
+	if (dstAttr == NULL) {
+		column.m_action = eColumnAdd;
+		column.m_fieldName = srcAttr->GetFieldNameDB();
+		column.m_attributeName = srcAttr->GetName();
+		column.m_newType = srcAttr->GetSQLTypeObject();
+		return true;
+	}
+
+	column.m_fieldName = dstAttr->GetFieldNameDB();
+	column.m_attributeName = dstAttr->GetName();
+	column.m_oldType = dstAttr->GetSQLTypeObject();
+
+	if (srcAttr == NULL) {
+		column.m_action = eColumnDrop;
+		return true;
+	}
+
+	IAttributeInfo::typeDescription_t srcType = srcAttr->GetTypeDescription();
+	IAttributeInfo::typeDescription_t dstType = dstAttr->GetTypeDescription();
+
+	if (srcType == dstType)
+		return false;
+
+	column.m_attributeName = srcAttr->GetName();
+	column.m_newType = srcAttr->GetSQLTypeObject();
+
+	//some backends can not change a column type in place, the values are copied as they are
+	const bool alterInPlace = !databaseLayer->GetDialect()->GetAlterColumnType(
+		wxT("T"), column.m_fieldName, column.m_newType).IsEmpty();
+
+	if (srcType.GetTypeObject() == dstType.GetTypeObject()) {
+		switch (srcType.GetTypeObject())
+		{
+		case eValueTypes::TYPE_STRING:
+			if (srcType.GetLength() >= dstType.GetLength() && alterInPlace) {
+				column.m_action = eColumnAlter;
+			}
+			else if (srcType.GetLength() >= dstType.GetLength()) {
+				column.m_action = eColumnRebuild;
+				column.m_convertText = wxT("%s");
+			}
+			else {
+				column.m_action = eColumnRebuild;
+				column.m_convertText = wxString::Format(wxT("SUBSTRING(%%s FROM 1 FOR %i)"), srcType.GetLength());
+			}
+			return true;
+		case eValueTypes::TYPE_NUMBER:
+			//the server widens a number in place while the scale stays
+			if (srcType.GetScale() == dstType.GetScale() && srcType.GetPrecision() >= dstType.GetPrecision() && alterInPlace) {
+				column.m_action = eColumnAlter;
+			}
+			else {
+				column.m_action = eColumnRebuild;
+				column.m_convertText = wxString::Format(wxT("CAST(%%s AS %s)"), column.m_newType);
+			}
+			return true;
+		}
+
+		//the date fraction is not kept in the column
+		return false;
+	}
+
+	if (IsScalarType(srcType.GetTypeObject()) && IsScalarType(dstType.GetTypeObject())) {
+		column.m_convertText = GetConvertText(srcAttr, dstAttr);
+	}
+
+	column.m_action = column.m_convertText.IsEmpty() ?
+		eColumnReplace : eColumnRebuild;
+
+	return true;
+}
+
+void CRestructurePlan::AddTable(const wxString &tableName, const wxString &objectName, eTableAction action, const std::vector<column_t> &aColumns)
+{
+	if (action == eTableAlter && aColumns.empty())
+		return;
+
+	table_t table;
+	table.m_action = action;
+	table.m_tableName = tableName;
+	table.m_objectName = objectName;
+	table.m_aColumns = aColumns;
+	table.m_rowCount = -1;
+
+	if (action == eTableAlter) {
+		for (auto &column : aColumns) {
+			if (column.m_action == eColumnRebuild) {
+				table.m_action = eTableRebuild;
+				break;
+			}
+		}
+	}
+
+	m_aTables.push_back(table);
+}
+
+const CRestructurePlan::table_t *CRestructurePlan::FindTable(const wxString &tableName) const
+{
+	for (auto &table : m_aTables) {
+		if (table.m_tableName == tableName)
+			return &table;
+	}
+
+	return NULL;
+}
+
+bool CRestructurePlan::HasRowChanges() const
+{
+	for (auto &table : m_aTables) {
+		if (HasRowChanges(table))
+			return true;
+	}
+
+	return false;
+}
+
+bool CRestructurePlan::HasRowChanges(const table_t &table)
+{
+	if (table.m_action == eTableRebuild || table.m_action == eTableDrop)
+		return true;
+
+	if (table.m_action == eTableAlter) {
+		for (auto &column : table.m_aColumns) {
+			if (column.m_action == eColumnReplace || column.m_action == eColumnDrop)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+void CRestructurePlan::Estimate()
+{
+	for (auto &table : m_aTables) {
+		//added and widened columns do not touch the rows
+		if (!HasRowChanges(table))
+			continue;
+
+		DatabaseResultSet *resultSet =
+			databaseLayer->RunQueryWithResults("SELECT COUNT(*) AS rowCount FROM %s;", table.m_tableName);
+
+		if (resultSet == NULL)
+			continue;
+
+		if (resultSet->Next()) {
+			table.m_rowCount = resultSet->GetResultLong(wxT("rowCount"));
+		}
+
+		resultSet->Close();
+	}
+}
+
+long long CRestructurePlan::GetRowsAffected() const
+{
+	long long rowCount = 0;
+
+	for (auto &table : m_aTables) {
+		if (table.m_rowCount > 0)
+			rowCount += table.m_rowCount;
+	}
+
+	return rowCount;
+}
+
+wxString CRestructurePlan::GetDescription() const
+{
+	wxString description;
+
+	for (auto &table : m_aTables) {
+		description += wxString::Format(wxT("%s (%s): %s"),
+			table.m_objectName, table.m_tableName, GetActionName(table.m_action));
+		if (table.m_rowCount >= 0) {
+			description += wxString::Format(_(", rows: %s"), wxLongLong(table.m_rowCount).ToString());
+		}
+		description += wxT("\n");
+
+		for (auto &column : table.m_aColumns) {
+			description += wxString::Format(wxT("\t%s (%s): %s"),
+				column.m_attributeName, column.m_fieldName, GetActionName(column.m_action));
+			if (column.m_action != eColumnAdd && column.m_action != eColumnDrop) {
+				description += wxString::Format(wxT(", %s -> %s"), column.m_oldType, column.m_newType);
+			}
+			description += wxT("\n");
+		}
+	}
+
+	description += wxString::Format(_("Estimated rows affected: %s"), wxLongLong(GetRowsAffected()).ToString());
+	return description;
+}
+
+wxString CRestructurePlan::GetActionName(eTableAction action)
+{
+	switch (action)
+	{
+	case eTableCreate: return _("new table");
+	case eTableAlter: return _("columns are changed");
+	case eTableRebuild: return _("values are copied");
+	case eTableDrop: return _("table is dropped");
+	}
+
+	return wxEmptyString;
+}
+
+wxString CRestructurePlan::GetActionName(eColumnAction action)
+{
+	switch (action)
+	{
+	case eColumnAdd: return _("new column");
+	case eColumnAlter: return _("type is widened");
+	case eColumnRebuild: return _("values are converted");
+	case eColumnReplace: return _("values are cleared");
+	case eColumnDrop: return _("column is dropped");
+	}
+
+	return wxEmptyString;
+}
@@ -0,0 +1,84 @@
+#ifndef _RESTRUCTURE_PLAN_H__
+#define _RESTRUCTURE_PLAN_H__
+
+#include <wx/string.h>
+#include <vector>
+
+class IMetaAttributeObject;
+
+//changes of the tables between the saved and the edited configuration.
+//the plan is built before the save, it is shown as a dry run and then executed table by table
+class CRestructurePlan {
+public:
+
+	enum eTableAction {
+		eTableCreate = 1,
+		//columns are added or altered in place
+		eTableAlter,
+		//values of some columns are copied to new columns
+		eTableRebuild,
+		eTableDrop
+	};
+
+	enum eColumnAction {
+		//new column, existing rows get NULL
+		eColumnAdd = 1,
+		//wider type, only the metadata of the column changes
+		eColumnAlter,
+		//values are converted into a new column, then the new column takes the old name
+		eColumnRebuild,
+		//the values can not be converted, the column is created again empty
+		eColumnReplace,
+		eColumnDrop
+	};
+
+	struct column_t {
+		eColumnAction m_action;
+		wxString m_fieldName;
+		wxString m_attributeName;
+		wxString m_oldType;
+		wxString m_newType;
+		//conversion of the old value, %s is the old column
+		wxString m_convertText;
+		//old attribute, its indexes are dropped with the column
+		IMetaAttributeObject *m_oldAttribute;
+	};
+
+	struct table_t {
+		eTableAction m_action;
+		wxString m_tableName;
+		wxString m_objectName;
+		std::vector<column_t> m_aColumns;
+		//rows of the table, -1 until Estimate()
+		long long m_rowCount;
+	};
+
+	//srcAttr is the new attribute, dstAttr the saved one, NULL when there is none
+	static bool PlanColumn(IMetaAttributeObject *srcAttr, IMetaAttributeObject *dstAttr, column_t &column);
+
+	//tables without changed columns are not added
+	void AddTable(const wxString &tableName, const wxString &objectName, eTableAction action, const std::vector<column_t> &aColumns = std::vector<column_t>());
+
+	const std::vector<table_t> &GetTables() const { return m_aTables; }
+	const table_t *FindTable(const wxString &tableName) const;
+
+	bool IsEmpty() const { return m_aTables.empty(); }
+	//values of some rows are converted, cleared or deleted
+	bool HasRowChanges() const;
+
+	//dry run: rows of the rebuilt and dropped tables are counted
+	void Estimate();
+	long long GetRowsAffected() const;
+	wxString GetDescription() const;
+
+private:
+
+	static bool HasRowChanges(const table_t &table);
+
+	static wxString GetActionName(eTableAction action);
+	static wxString GetActionName(eColumnAction action);
+
+	std::vector<table_t> m_aTables;
+};
+
+#endif
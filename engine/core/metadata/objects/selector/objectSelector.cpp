@@ -1,21 +1,20 @@
 #include "objectSelector.h"
 #include "compiler/methods.h"
+#include "compiler/valueArray.h"
+#include "compiler/valueMap.h"
 #include "metadata/objects/tabularSection/tabularSection.h"
+#include "metadata/objects/reference/reference.h"
+#include "metadata/objects/objectRowMapper.h"
 #include "databaseLayer/databaseLayer.h"
 #include "appData.h"
 
 void IDataSelectorValue::Reset()
 {
+	CloseCursor();
+
 	m_objGuid.reset(); m_bNewObject = false;
-	if (!appData->DesignerMode()) {
-		m_aObjectData.clear();
-		PreparedStatement *statement = databaseLayer->PrepareStatement("SELECT UUID FROM %s ORDER BY CAST(UUID AS VARCHAR(36)); ", m_metaObject->GetTableNameDB());
-		DatabaseResultSet *resultSet = statement->RunQueryWithResults();
-		while (resultSet->Next()) {
-			m_aObjectData.push_back(resultSet->GetResultString(guidName));
-		};
-		resultSet->Close();
-	}
+	m_aObjectTables.clear(); m_aLoadedTables.clear();
+
 	for (auto currAttribute : m_metaObject->GetObjectAttributes()) {
 		if (!appData->DesignerMode()) {
 			m_aObjectValues[currAttribute->GetMetaID()] = CValue(eValueTypes::TYPE_NULL);
@@ -39,10 +38,20 @@ void IDataSelectorValue::Reset()
 
 bool IDataSelectorValue::Read()
 {
+	if (m_resultSet == NULL || m_rowMapper == NULL)
+		return false;
+
+	m_objGuid = m_rowMapper->ReadGuid(m_resultSet);
+
 	if (!m_objGuid.isValid())
 		return false;
 
-	m_aObjectValues.clear(); m_aObjectTables.clear();
+	//map the current row of the cursor into the object
+	m_rowMapper->ReadRow(m_resultSet, m_aObjectValues);
+
+	m_aObjectValues[m_metaObject->GetMetaID()] = new CValueReference(m_metaObject, m_objGuid);
+
+	m_aObjectTables.clear(); m_aLoadedTables.clear();
 
 	for (auto currTable : m_metaObject->GetObjectTables()) {
 		CValueTabularRefSection *tabularSection =
@@ -51,70 +60,70 @@ bool IDataSelectorValue::Read()
 		m_aObjectTables.push_back(tabularSection);
 	}
 
-	bool isLoaded = false;
-	PreparedStatement *statement = databaseLayer->PrepareStatement("SELECT FIRST 1 * FROM %s WHERE UUID = '%s'; ", m_metaObject->GetTableNameDB(), m_objGuid.str());
-	if (statement == NULL)
+	return true;
+}
+
+bool IDataSelectorValue::OpenCursor()
+{
+	CloseCursor();
+
+	m_statement = databaseLayer->PrepareStatement(GetSelectionQuery());
+	if (m_statement == NULL)
 		return false;
-	DatabaseResultSet *resultSet = statement->RunQueryWithResults();
-
-	if (resultSet->Next()) {
-		isLoaded = true;
-		wxMemoryBuffer bufferData;
-		resultSet->GetResultBlob(guidRef, bufferData);
-		if (!bufferData.IsEmpty()) {
-			m_aObjectValues[m_metaObject->GetMetaID()] = CValueReference::CreateFromPtr(
-				m_metaObject->GetMetadata(), bufferData.GetData()
-			);
-		}
-		//load attributes 
-		for (auto attribute : m_metaObject->GetObjectAttributes()) {
-			wxString nameAttribute = attribute->GetFieldNameDB();
-			switch (attribute->GetTypeObject())
-			{
-			case eValueTypes::TYPE_BOOLEAN:
-				m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultBool(nameAttribute); break;
-			case eValueTypes::TYPE_NUMBER:
-				m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultNumber(nameAttribute); break;
-			case eValueTypes::TYPE_DATE:
-				m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultDate(nameAttribute); break;
-			case eValueTypes::TYPE_STRING:
-				m_aObjectValues[attribute->GetMetaID()] = resultSet->GetResultString(nameAttribute); break;
-			default:
-			{
-				wxMemoryBuffer bufferData;
-				resultSet->GetResultBlob(nameAttribute, bufferData);
-				if (!bufferData.IsEmpty()) {
-					m_aObjectValues[attribute->GetMetaID()] = CValueReference::CreateFromPtr(
-						m_metaObject->GetMetadata(), bufferData.GetData()
-					);
-				}
-				else {
-					m_aObjectValues[attribute->GetMetaID()] = new CValueReference(
-						m_metaObject->GetMetadata(), attribute->GetTypeObject()
-					);
-				}
-				break;
-			}
-			}
-		}
-		for (auto tabularSection : m_aObjectTables) {
-			if (!tabularSection->LoadDataFromDB()) {
-				isLoaded = false;
-			}
-		}
+
+	BindSelection(m_statement);
+
+	m_resultSet = m_statement->RunQueryWithResults();
+	if (m_resultSet == NULL) {
+		CloseCursor();
+		return false;
+	}
+
+	m_rowMapper = new CObjectRowMapper(m_metaObject->GetMetadata(), m_metaObject->GetObjectAttributes());
+	m_rowMapper->Prepare(m_resultSet);
+
+	return true;
+}
+
+void IDataSelectorValue::CloseCursor()
+{
+	wxDELETE(m_rowMapper);
+
+	if (m_resultSet != NULL) {
+		m_resultSet->Close();
+		m_resultSet = NULL;
+	}
+
+	if (m_statement != NULL) {
+		databaseLayer->CloseStatement(m_statement);
+		m_statement = NULL;
+	}
+}
+
+void IDataSelectorValue::LoadTabularSection(meta_identifier_t id)
+{
+	if (!m_objGuid.isValid() || m_aLoadedTables.find(id) != m_aLoadedTables.end())
+		return;
+
+	CValueTabularRefSection *tabularSection =
+		dynamic_cast<CValueTabularRefSection *>(IObjectValueInfo::GetTableByMetaID(id));
+
+	if (tabularSection) {
+		m_aLoadedTables.insert(id);
+		tabularSection->LoadDataFromDB();
 	}
-	resultSet->Close();
-	return isLoaded;
 }
 
 IDataSelectorValue::IDataSelectorValue(IMetaObjectRefValue *metaObject) : CValue(eValueTypes::TYPE_VALUE, true), IObjectValueInfo(Guid(), false), 
-m_metaObject(metaObject), m_methods(new CMethods())
+m_metaObject(metaObject), m_methods(new CMethods()), m_orderAttribute(NULL), m_bOrderDesc(false), m_nLimit(0),
+m_statement(NULL), m_resultSet(NULL), m_rowMapper(NULL)
 {
 	Reset();
 }
 
 IDataSelectorValue::~IDataSelectorValue()
 {
+	CloseCursor();
 	wxDELETE(m_methods);
 }
 
@@ -124,26 +133,241 @@ bool IDataSelectorValue::Next()
 		return false;
 	}
 
-	if (!m_objGuid.isValid()) {
-		if (m_aObjectData.size() > 0) {
-			auto itStart = m_aObjectData.begin();
-			m_objGuid = *itStart;
-			return Read();
+	//the cursor is opened by the first call and closed after the last row
+	if (m_resultSet == NULL) {
+		if (m_objGuid.isValid() || !OpenCursor()) {
+			return false;
+		}
+	}
+
+	if (!m_resultSet->Next()) {
+		CloseCursor();
+		return false;
+	}
+
+	return Read();
+}
+
+static bool IsScalarAttribute(IMetaAttributeObject *attribute)
+{
+	switch (attribute->GetTypeObject())
+	{
+	case eValueTypes::TYPE_BOOLEAN:
+	case eValueTypes::TYPE_NUMBER:
+	case eValueTypes::TYPE_DATE:
+	case eValueTypes::TYPE_STRING:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//range bound that is not set
+static bool IsOpenBound(const CValue &cVal)
+{
+	return cVal.GetType() == eValueTypes::TYPE_EMPTY
+		|| cVal.GetType() == eValueTypes::TYPE_NULL;
+}
+
+static CValue AdjustFilterValue(IMetaAttributeObject *attribute, const CValue &cVal)
+{
+	CValueTypeDescription *td = attribute->GetValueTypeDescription();
+	CValue cAdjusted = td->AdjustValue(cVal);
+	wxDELETE(td);
+	return cAdjusted;
+}
+
+void IDataSelectorValue::SetSelection(CValue cFilter, CValue cOrder, CValue cLimit)
+{
+	m_aFilters.clear();
+	m_orderAttribute = NULL; m_bOrderDesc = false;
+	m_nLimit = 0;
+
+	//filter: structure of attribute name -> value, array of values or structure with from/to
+	CValueStructure *filterStructure = cFilter.ConvertToType<CValueStructure>();
+	if (filterStructure != NULL) {
+		//every key must name an attribute, a misspelled one would silently widen the selection
+		for (unsigned int idx = 0; idx < filterStructure->GetItSize(); idx++) {
+			CValue cKeyValue = filterStructure->GetItAt(idx);
+			CValueContainer::CValueReturnContainer *keyValue =
+				cKeyValue.ConvertToType<CValueContainer::CValueReturnContainer>();
+			wxASSERT(keyValue);
+			wxString keyName = keyValue->GetKey().GetString();
+			bool found = false;
+			for (auto attribute : m_metaObject->GetObjectAttributes()) {
+				if (attribute->GetName().CmpNoCase(keyName) == 0) {
+					found = true;
+					break;
+				}
+			}
+			if (!found) {
+				CTranslateError::Error(_("Attribute '%s' is not found"), keyName.wc_str());
+			}
+		}
+
+		for (auto attribute : m_metaObject->GetObjectAttributes()) {
+			CValue cFilterValue;
+			if (!filterStructure->Property(attribute->GetName(), cFilterValue))
+				continue;
+
+			selectorFilter_t filter;
+			filter.m_attribute = attribute;
+
+			CValueArray *valueArray = cFilterValue.ConvertToType<CValueArray>();
+			CValueStructure *valueRange = cFilterValue.ConvertToType<CValueStructure>();
+
+			//references are compared by their bytes, they have no order
+			if (valueRange != NULL && !IsScalarAttribute(attribute)) {
+				CTranslateError::Error(_("Range filter by attribute '%s' is not supported"), attribute->GetName().wc_str());
+			}
+
+			if (valueArray != NULL) {
+				filter.m_kind = eFilterList;
+				for (unsigned int idx = 0; idx < valueArray->GetItSize(); idx++) {
+					filter.m_aValues.push_back(AdjustFilterValue(attribute, valueArray->GetItAt(idx)));
+				}
+			}
+			else if (valueRange != NULL) {
+				filter.m_kind = eFilterRange;
+				CValue cFrom, cTo;
+				valueRange->Property(wxString(wxT("from")), cFrom);
+				valueRange->Property(wxString(wxT("to")), cTo);
+				filter.m_aValues.push_back(IsOpenBound(cFrom) ? CValue() : AdjustFilterValue(attribute, cFrom));
+				filter.m_aValues.push_back(IsOpenBound(cTo) ? CValue() : AdjustFilterValue(attribute, cTo));
+			}
+			else {
+				filter.m_kind = eFilterEqual;
+				filter.m_aValues.push_back(AdjustFilterValue(attribute, cFilterValue));
+			}
+
+			m_aFilters.push_back(filter);
+		}
+	}
+
+	//order: attribute name and optional "desc"
+	wxString orderText = cOrder.GetString().Trim().Trim(false);
+	if (!orderText.IsEmpty()) {
+		wxString orderName = orderText.BeforeFirst(wxT(' '));
+		wxString orderDirection = orderText.AfterFirst(wxT(' ')).Trim(false);
+
+		for (auto attribute : m_metaObject->GetObjectAttributes()) {
+			if (attribute->GetName().CmpNoCase(orderName) == 0) {
+				m_orderAttribute = attribute;
+				break;
+			}
+		}
+
+		if (m_orderAttribute == NULL || !IsScalarAttribute(m_orderAttribute)) {
+			CTranslateError::Error(_("Order by '%s' is not supported"), orderName.wc_str());
+		}
+
+		m_bOrderDesc = orderDirection.CmpNoCase(wxT("desc")) == 0;
+	}
+
+	if (cLimit.GetType() == eValueTypes::TYPE_NUMBER) {
+		m_nLimit = cLimit.ToUInt();
+	}
+
+	Reset();
+}
+
+wxString IDataSelectorValue::GetSelectionQuery() const
+{
+	wxString queryText = wxT("* FROM ") + m_metaObject->GetTableNameDB();
+
+	wxString whereText;
+	for (auto &filter : m_aFilters) {
+		wxString fieldName = filter.m_attribute->GetFieldNameDB();
+		wxString conditionText;
+
+		switch (filter.m_kind)
+		{
+		case eFilterEqual:
+			conditionText = fieldName + wxT(" = ?");
+			break;
+		case eFilterRange:
+			if (!IsOpenBound(filter.m_aValues[0])) {
+				conditionText = fieldName + wxT(" >= ?");
+			}
+			if (!IsOpenBound(filter.m_aValues[1])) {
+				if (!conditionText.IsEmpty()) conditionText += wxT(" AND ");
+				conditionText += fieldName + wxT(" <= ?");
+			}
+			break;
+		case eFilterList:
+			if (filter.m_aValues.empty()) {
+				conditionText = wxT("1 = 0");
+			}
+			else {
+				conditionText = fieldName + wxT(" IN (");
+				for (unsigned int idx = 0; idx < filter.m_aValues.size(); idx++) {
+					conditionText += idx > 0 ? wxT(", ?") : wxT("?");
+				}
+				conditionText += wxT(")");
+			}
+			break;
 		}
+
+		if (conditionText.IsEmpty())
+			continue;
+
+		whereText += whereText.IsEmpty() ? wxT(" WHERE ") : wxT(" AND ");
+		whereText += conditionText;
+	}
+
+	queryText += whereText;
+
+	wxString direction = m_bOrderDesc ? wxT("DESC") : wxT("ASC");
+	if (m_orderAttribute != NULL) {
+		queryText += wxString::Format(wxT(" ORDER BY %s %s, UUID %s"), m_orderAttribute->GetFieldNameDB(), direction, direction);
 	}
 	else {
-		auto itFounded = std::find(m_aObjectData.begin(), m_aObjectData.end(), m_objGuid);
-		ptrdiff_t pos =
-			std::distance(m_aObjectData.begin(), itFounded);
-		if (pos == m_aObjectData.size() - 1) {
-			return false;
+		queryText += wxT(" ORDER BY UUID");
+	}
+
+	if (m_nLimit > 0) {
+		return databaseLayer->GetDialect()->GetSelectLimit(queryText, m_nLimit) + wxT("; ");
+	}
+
+	return wxT("SELECT ") + queryText + wxT("; ");
+}
+
+void IDataSelectorValue::BindSelection(PreparedStatement *statement) const
+{
+	int position = 1;
+
+	for (auto &filter : m_aFilters) {
+		for (auto &cFilterValue : filter.m_aValues) {
+			if (filter.m_kind == eFilterRange && IsOpenBound(cFilterValue))
+				continue;
+			CValue cValue = cFilterValue;
+			if (IsScalarAttribute(filter.m_attribute)) {
+				cValue.SetBinaryData(position++, statement);
+				continue;
+			}
+			//reference_t of the value, an empty reference of the attribute type if the value is not a reference
+			CValueReference *refValue = cValue.ConvertToType<CValueReference>();
+			if (refValue != NULL) {
+				refValue->SetBinaryData(position++, statement);
+			}
+			else {
+				reference_t reference_impl(filter.m_attribute->GetTypeObject(), Guid());
+				statement->SetParamBlob(position++, &reference_impl, sizeof(reference_t));
+			}
 		}
-		std::advance(itFounded, 1);
-		m_objGuid = *itFounded;
-		return Read();
 	}
+}
 
-	return false;
+CValue IDataSelectorValue::GetValueByMetaID(meta_identifier_t id) const
+{
+	const_cast<IDataSelectorValue *>(this)->LoadTabularSection(id);
+	return IObjectValueInfo::GetValueByMetaID(id);
+}
+
+IValueTabularSection *IDataSelectorValue::GetTableByMetaID(meta_identifier_t id) const
+{
+	const_cast<IDataSelectorValue *>(this)->LoadTabularSection(id);
+	return IObjectValueInfo::GetTableByMetaID(id);
 }
 
 IDataObjectRefValue *IDataSelectorValue::GetObject(const Guid &guid) const
@@ -231,5 +455,6 @@ CValue IDataSelectorValue::GetAttribute(attributeArg_t &aParams)
 			return CValue(eValueTypes::TYPE_NULL);
 		}
 	}
+	LoadTabularSection(id);
 	return m_aObjectValues[id];
 }
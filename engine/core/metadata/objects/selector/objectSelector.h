@@ -3,12 +3,23 @@
 
 #include "metadata/objects/baseObject.h"
 
+#include <set>
+
+class CObjectRowMapper;
+
 class IDataSelectorValue : public CValue,
 	public IObjectValueInfo {
 	CMethods *m_methods;
 private:
 	void Reset();
 	bool Read();
+
+	//rows are read through one cursor over the table
+	bool OpenCursor();
+	void CloseCursor();
+
+	//tabular sections are read on first use
+	void LoadTabularSection(meta_identifier_t id);
 public:
 	IDataSelectorValue(IMetaObjectRefValue *metaObject);
 	virtual ~IDataSelectorValue();
@@ -16,6 +27,13 @@ public:
 	virtual bool Next();
 	virtual IDataObjectRefValue *GetObject(const Guid &guid) const;
 
+	//filter, order and limit are passed to the query
+	void SetSelection(CValue cFilter, CValue cOrder, CValue cLimit);
+
+	//support source data 
+	virtual CValue GetValueByMetaID(meta_identifier_t id) const;
+	virtual IValueTabularSection *GetTableByMetaID(meta_identifier_t id) const;
+
 	//is empty
 	virtual inline bool IsEmpty() const { return false; }
 
@@ -40,7 +58,34 @@ public:
 protected:
 
 	IMetaObjectRefValue *m_metaObject;
-	std::vector<Guid> m_aObjectData;
+
+	enum eFilterKind {
+		eFilterEqual,
+		eFilterRange,
+		eFilterList
+	};
+
+	struct selectorFilter_t {
+		IMetaAttributeObject *m_attribute;
+		eFilterKind m_kind;
+		std::vector<CValue> m_aValues; //value, from-to (empty is open) or list
+	};
+
+	wxString GetSelectionQuery() const;
+	void BindSelection(PreparedStatement *statement) const;
+
+	std::vector<selectorFilter_t> m_aFilters;
+
+	IMetaAttributeObject *m_orderAttribute;
+	bool m_bOrderDesc;
+
+	unsigned int m_nLimit;
+
+	PreparedStatement *m_statement;
+	DatabaseResultSet *m_resultSet;
+	CObjectRowMapper *m_rowMapper;
+
+	std::set<meta_identifier_t> m_aLoadedTables;
 };
 
 #endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "databaseLayer/databaseLayer.h"
 #include "databaseLayer/databaseErrorCodes.h"
 #include "metadata/objects/baseObject.h"
+#include "metadata/objects/objectRowMapper.h"
 #include "utils/stringUtils.h"
 
 wxIMPLEMENT_ABSTRACT_CLASS(IValueTabularSection, IValueTable);
@@ -20,6 +21,37 @@ wxIMPLEMENT_DYNAMIC_CLASS(CValueTabularRefSection, IValueTabularSection);
 //////////////////////////////////////////////////////////////////////
 
 #include "metadata/singleMetaTypes.h"
+#include "compiler/methods.h"
+
+IValueTabularSection::~IValueTabularSection()
+{
+	if (m_aDataColumns != NULL) {
+		m_aDataColumns->DecrRef();
+	}
+
+	wxDELETE(m_lineMethods);
+}
+
+CMethods *IValueTabularSection::GetLineMethods()
+{
+	if (m_lineMethods != NULL)
+		return m_lineMethods;
+
+	std::vector<SEng> aAttributes;
+
+	for (auto attribute : m_metaTable->GetObjectAttributes())
+	{
+		SEng aAttribute;
+		aAttribute.sName = attribute->GetName();
+		aAttribute.iName = attribute->GetMetaID();
+		aAttribute.sSynonym = wxT("default");
+		aAttributes.push_back(aAttribute);
+	}
+
+	m_lineMethods = new CMethods();
+	m_lineMethods->PrepareAttributes(aAttributes.data(), aAttributes.size());
+	return m_lineMethods;
+}
 
 CValue IValueTabularSection::GetAt(const CValue & cKey)
 {
@@ -121,47 +153,40 @@ bool CValueTabularRefSection::LoadDataFromDB()
 	wxASSERT(metaObject);
 
 	wxString tableName = m_metaTable->GetTableNameDB();
-	wxString sql = "SELECT * FROM " + tableName + " WHERE UUID = '" + m_dataObject->GetGuid().str() + "'";
+	wxString sql = "SELECT * FROM " + tableName + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_dataObject->GetGuid());
 
 	DatabaseResultSet *resultSet = databaseLayer->RunQueryWithResults(sql);
 	if (!resultSet) {
 		return false;
 	}
+	//numberline is special field, it is not read
+	std::vector<IMetaAttributeObject *> aAttributes;
+	std::vector<meta_identifier_t> aNumberLines;
+	for (auto attribute : m_metaTable->GetObjectAttributes()) {
+		if (m_metaTable->IsNumberLine(attribute->GetMetaID())) {
+			aNumberLines.push_back(attribute->GetMetaID());
+		}
+		else {
+			aAttributes.push_back(attribute);
+		}
+	}
+
+	CObjectRowMapper rowMapper(m_metaTable->GetMetadata(), aAttributes);
+	rowMapper.Prepare(resultSet);
+
 	while (resultSet->Next()) {
 		std::map<meta_identifier_t, CValue> aRowTable;
-		for (auto attribute : m_metaTable->GetObjectAttributes()) {
-			wxString nameAttribute = attribute->GetFieldNameDB();
-			if (m_metaTable->IsNumberLine(attribute->GetMetaID())) {
-				aRowTable[attribute->GetMetaID()] = CValue(); //numberline is special field
-				continue;
-			}
-			switch (attribute->GetTypeObject())
-			{
-			case eValueTypes::TYPE_BOOLEAN: aRowTable[attribute->GetMetaID()] = resultSet->GetResultBool(nameAttribute); break;
-			case eValueTypes::TYPE_NUMBER:aRowTable[attribute->GetMetaID()] = resultSet->GetResultDouble(nameAttribute); break;
-			case eValueTypes::TYPE_DATE:aRowTable[attribute->GetMetaID()] = resultSet->GetResultDate(nameAttribute); break;
-			case eValueTypes::TYPE_STRING:aRowTable[attribute->GetMetaID()] = resultSet->GetResultString(nameAttribute); break;
-			default:
-			{
-				wxMemoryBuffer bufferData;
-				resultSet->GetResultBlob(nameAttribute, bufferData);
-				if (!bufferData.IsEmpty()) {
-					aRowTable[attribute->GetMetaID()] = CValueReference::CreateFromPtr(
-						m_metaTable->GetMetadata(), bufferData.GetData()
-					);
-				}
-				else {
-					aRowTable[attribute->GetMetaID()] = new CValueReference(
-						m_metaTable->GetMetadata(), attribute->GetTypeObject()
-					);
-				}
-				break;
-			}
-			}
+		for (auto id : aNumberLines) {
+			aRowTable[id] = CValue();
 		}
+		rowMapper.ReadRow(resultSet, aRowTable);
 		m_aObjectValues.push_back(aRowTable);
 	}
 	resultSet->Close();
+
+	m_aStoredValues = m_aObjectValues;
+	m_storedGuid = m_dataObject->GetGuid();
+
 	if (!CTranslateError::IsSimpleMode()) {
 		IValueTable::Reset(m_aObjectValues.size());
 	}
@@ -172,8 +197,6 @@ bool CValueTabularRefSection::LoadDataFromDB()
 
 bool CValueTabularRefSection::SaveDataInDB()
 {
-	bool hasError = false;
-
 	//check fill attributes 
 	bool fillCheck = true; int nLine = 1;
 	for (auto objectValue : m_aObjectValues) {
@@ -194,48 +217,131 @@ bool CValueTabularRefSection::SaveDataInDB()
 		return false;
 	}
 
-	if (!CValueTabularRefSection::DeleteDataInDB()) {
+	//rows are keyed by object and line number - rewrite only lines that differ from the stored ones
+	bool hasStoredRows = !m_dataObject->IsNewObject() && m_storedGuid == m_dataObject->GetGuid();
+
+	std::vector<unsigned int> aChangedRows;
+	if (hasStoredRows) {
+		for (unsigned int line = 0; line < m_aObjectValues.size(); line++) {
+			if (IsRowChanged(line)) {
+				aChangedRows.push_back(line);
+			}
+		}
+	}
+
+	unsigned int overlapRows = std::min(m_aObjectValues.size(), m_aStoredValues.size());
+	unsigned int changedRows = 0;
+	for (auto line : aChangedRows) {
+		if (line < overlapRows) {
+			changedRows++;
+		}
+	}
+
+	//inserted or deleted lines in the middle shift every following line, then a full rewrite is cheaper
+	if (!hasStoredRows || changedRows > overlapRows / 2) {
+		if (!CValueTabularRefSection::DeleteDataInDB()) {
+			return false;
+		}
+		aChangedRows.clear();
+		for (unsigned int line = 0; line < m_aObjectValues.size(); line++) {
+			aChangedRows.push_back(line);
+		}
+	}
+	else if (m_aStoredValues.size() > m_aObjectValues.size()) {
+		CMetaDefaultAttributeObject *numLine = m_metaTable->GetNumberLine();
+		wxASSERT(numLine);
+		databaseLayer->RunQuery("DELETE FROM " + m_metaTable->GetTableNameDB() + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_dataObject->GetGuid()) + " AND " + numLine->GetFieldNameDB() + " > " + StringUtils::IntToStr(m_aObjectValues.size()) + ";");
+		//zero deleted lines and an error share the same return code
+		if (databaseLayer->GetErrorCode() != DATABASE_LAYER_OK) {
+			m_aStoredValues.clear();
+			m_storedGuid.reset();
+			return false;
+		}
+	}
+
+	if (!SaveRowsInDB(aChangedRows)) {
+		m_aStoredValues.clear();
+		m_storedGuid.reset();
 		return false;
 	}
 
+	m_aStoredValues = m_aObjectValues;
+	m_storedGuid = m_dataObject->GetGuid();
+	return true;
+}
+
+bool CValueTabularRefSection::IsRowChanged(unsigned int line) const
+{
+	if (line >= m_aStoredValues.size())
+		return true;
+
+	const std::map<meta_identifier_t, CValue> &rowValues = m_aObjectValues[line];
+	const std::map<meta_identifier_t, CValue> &storedValues = m_aStoredValues[line];
+
+	if (rowValues.size() != storedValues.size())
+		return true;
+
+	for (auto &rowValue : rowValues) {
+		if (m_metaTable->IsNumberLine(rowValue.first)) {
+			continue;
+		}
+		auto foundedValue = storedValues.find(rowValue.first);
+		if (foundedValue == storedValues.end()) {
+			return true;
+		}
+		if (rowValue.second.GetType() != foundedValue->second.GetType()
+			|| !(rowValue.second == foundedValue->second)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CValueTabularRefSection::SaveRowsInDB(const std::vector<unsigned int> &aRows)
+{
+	if (aRows.empty()) {
+		return true;
+	}
+
+	bool hasError = false;
+
 	CMetaDefaultAttributeObject *numLine = m_metaTable->GetNumberLine();
 	wxASSERT(numLine);
 	IMetaObjectValue *metaObject = m_dataObject->GetMetaObject();
 	wxASSERT(metaObject);
 	reference_t *m_reference_impl = new reference_t(metaObject->GetMetaID(), m_dataObject->GetGuid());
 	wxString tableName = m_metaTable->GetTableNameDB();
-	wxString queryText = "UPDATE OR INSERT INTO " + tableName + " (";
-	queryText += "UUID, UUIDREF";
+	wxArrayString aColumns, aValues, aKeyColumns;
+	aColumns.Add(guidName); aValues.Add(wxT("?"));
+	aColumns.Add(guidRef); aValues.Add(wxT("?"));
 	for (auto attribute : m_metaTable->GetObjectAttributes()) {
-		queryText = queryText + ", " + attribute->GetFieldNameDB();
+		aColumns.Add(attribute->GetFieldNameDB()); aValues.Add(wxT("?"));
 	}
-	queryText += ") VALUES (?, ?";
-	for (auto attribute : m_metaTable->GetObjectAttributes()) {
-		queryText += ", ?";
+	aKeyColumns.Add(guidName);
+	aKeyColumns.Add(numLine->GetFieldNameDB());
+	wxString queryText = databaseLayer->GetDialect()->GetUpsert(tableName, aColumns, aValues, aKeyColumns);
+	DatabaseStatementLocker statement(databaseLayer, queryText);
+	if (!statement.IsOk()) {
+		delete m_reference_impl;
+		return false;
 	}
-	queryText += ") MATCHING (UUID, " + numLine->GetFieldNameDB() + ");";
-	PreparedStatement *statement = databaseLayer->PrepareStatement(queryText);
-	wxASSERT(statement);
-	number_t numberLine = 1;
-	for (auto objectValue : m_aObjectValues) {
-		if (hasError) {
-			break;
-		}
+	for (auto line : aRows) {
+		auto &objectValue = m_aObjectValues[line];
 		int position = 3;
-		statement->SetParamString(1, m_dataObject->GetGuid().str());
+		CObjectRowMapper::SetParamGuid(statement.GetStatement(), 1, m_dataObject->GetGuid());
 		statement->SetParamBlob(2, m_reference_impl, sizeof(reference_t));
 		for (auto attribute : m_metaTable->GetObjectAttributes()) {
 			if (!m_metaTable->IsNumberLine(attribute->GetMetaID())) {
-				objectValue[attribute->GetMetaID()].SetBinaryData(position++, statement);
+				objectValue[attribute->GetMetaID()].SetBinaryData(position++, statement.GetStatement());
 			}
 			else {
-				statement->SetParamNumber(position++, numberLine);
+				statement->SetParamNumber(position++, number_t(line + 1));
 			}
 		}
-		numberLine = numberLine + 1;
-		hasError = statement->RunQuery() == DATABASE_LAYER_QUERY_RESULT_ERROR;
+		statement->AddBatch();
 	}
-	databaseLayer->CloseStatement(statement);
+	hasError = statement->ExecuteBatch() == DATABASE_LAYER_QUERY_RESULT_ERROR;
 	delete m_reference_impl;
 
 	return !hasError;
@@ -249,8 +355,16 @@ bool CValueTabularRefSection::DeleteDataInDB()
 	IMetaObjectValue *metaObject = m_dataObject->GetMetaObject();
 	wxASSERT(metaObject);
 	wxString tableName = m_metaTable->GetTableNameDB();
-	databaseLayer->RunQuery("DELETE FROM " + tableName + " WHERE UUID = '" + m_dataObject->GetGuid().str() + "';");
-	return true;
+	databaseLayer->RunQuery("DELETE FROM " + tableName + " WHERE UUID = " + CObjectRowMapper::GetGuidLiteral(m_dataObject->GetGuid()) + ";");
+
+	m_aStoredValues.clear();
+	m_storedGuid.reset();
+	return databaseLayer->GetErrorCode() == DATABASE_LAYER_OK;
+}
+
+void IValueTabularSection::PrepareReferences()
+{
+	CValueReference::PrepareReferences(m_aObjectValues);
 }
 
 #include "compiler/valueTable.h"
@@ -275,7 +389,6 @@ bool IValueTabularSection::LoadDataFromTable(IValueTable *srcTable)
 	for (unsigned int row = 0; row < rowsCount; row++) {
 		IValueTableReturnLine *retLine = srcTable->GetRowAt(row); 
 		IValueTableReturnLine *newRetLine = new CValueTabularSectionReturnLine(this, AppenRow());
-		newRetLine->PrepareNames();
 		for (auto colName : m_aColumnsName) {
 			newRetLine->SetAttribute(colName, retLine->GetAttribute(colName));
 		}
@@ -336,8 +449,6 @@ CValue CValueTabularRefSection::GetValueByMetaID(long line, meta_identifier_t id
 //               CValueTabularSectionColumns                        //
 //////////////////////////////////////////////////////////////////////
 
-#include "compiler/methods.h"
-
 wxIMPLEMENT_DYNAMIC_CLASS(IValueTabularSection::CValueTabularSectionColumns, IValueTable::IValueTableColumns);
 
 IValueTabularSection::CValueTabularSectionColumns::CValueTabularSectionColumns() : IValueTableColumns(), m_methods(NULL), m_ownerTable(NULL)
@@ -464,37 +575,19 @@ CValue IValueTabularSection::CValueTabularSectionColumns::CValueTabularSectionCo
 //////////////////////////////////////////////////////////////////////
 
 IValueTabularSection::CValueTabularSectionReturnLine::CValueTabularSectionReturnLine()
-	: IValueTableReturnLine(), m_methods(new CMethods())
+	: IValueTableReturnLine(), m_ownerTable(NULL), m_lineTable(wxNOT_FOUND)
 {
 }
 
 IValueTabularSection::CValueTabularSectionReturnLine::CValueTabularSectionReturnLine(IValueTabularSection *ownerTable, int line)
-	: IValueTableReturnLine(), m_ownerTable(ownerTable), m_lineTable(line), m_methods(new CMethods())
+	: IValueTableReturnLine(), m_ownerTable(ownerTable), m_lineTable(line)
 {
 }
 
 IValueTabularSection::CValueTabularSectionReturnLine::~CValueTabularSectionReturnLine()
 {
-	wxDELETE(m_methods);
 }
 
-void IValueTabularSection::CValueTabularSectionReturnLine::PrepareNames() const
-{
-	std::vector<SEng> aAttributes;
-
-	for (auto attribute : m_ownerTable->m_metaTable->GetObjectAttributes())
-	{
-		SEng aAttribute;
-		aAttribute.sName = attribute->GetName();
-		aAttribute.iName = attribute->GetMetaID();
-		aAttribute.sSynonym = wxT("default");
-		aAttributes.push_back(aAttribute);
-	}
-
-	m_methods->PrepareAttributes(aAttributes.data(), aAttributes.size());
-}
-
-
 void IValueTabularSection::CValueTabularSectionReturnLine::SetValueByMetaID(meta_identifier_t id, const CValue &cVal)
 {
 	m_ownerTable->SetValueByMetaID(m_lineTable, id, cVal);
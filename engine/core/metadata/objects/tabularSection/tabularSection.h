@@ -115,6 +115,7 @@ public:
 
 	} *m_aDataColumns;
 
+	//row handle: owner table and line index only, names are shared through the owner table
 	class CValueTabularSectionReturnLine : public IValueTableReturnLine {
 		wxDECLARE_DYNAMIC_CLASS(CValueTabularSectionReturnLine);
 	public:
@@ -132,8 +133,7 @@ public:
 		virtual void SetValueByMetaID(meta_identifier_t id, const CValue &cVal);
 		virtual CValue GetValueByMetaID(meta_identifier_t id) const;
 
-		virtual CMethods* GetPMethods() const { PrepareNames(); return m_methods; }; //         
-		virtual void PrepareNames() const;                         //         
+		virtual CMethods* GetPMethods() const { return m_ownerTable ? m_ownerTable->GetLineMethods() : NULL; } //         
 
 		virtual void SetAttribute(attributeArg_t &aParams, CValue &cVal); // 
 		virtual CValue GetAttribute(attributeArg_t &aParams); // 
@@ -142,28 +142,25 @@ public:
 		virtual wxString GetString() const { return wxT("tabularSectionRow"); }
 
 		friend class IValueTabularSection;
-	private:
-		CMethods *m_methods;
 	};
 
-	IValueTabularSection() : m_dataObject(NULL), m_metaTable(NULL), m_aDataColumns(NULL) {
+	IValueTabularSection() : m_dataObject(NULL), m_metaTable(NULL), m_aDataColumns(NULL), m_lineMethods(NULL) {
 	}
 
-	IValueTabularSection(IObjectValueInfo *dataObject, CMetaTableObject *tableObject) : m_dataObject(dataObject), m_metaTable(tableObject), m_aDataColumns(NULL) {
+	IValueTabularSection(IObjectValueInfo *dataObject, CMetaTableObject *tableObject) : m_dataObject(dataObject), m_metaTable(tableObject), m_aDataColumns(NULL), m_lineMethods(NULL) {
 		m_aDataColumns = new CValueTabularSectionColumns(this);
 		m_aDataColumns->IncrRef();
 	}
 
-	virtual ~IValueTabularSection() {
-		if (m_aDataColumns != NULL) {
-			m_aDataColumns->DecrRef();
-		}
-	}
+	virtual ~IValueTabularSection();
 
 	CMetaTableObject *GetMetaObject() const {
 		return m_metaTable;
 	}
 
+	//attribute table shared by all rows of the section
+	CMethods *GetLineMethods();
+
 	meta_identifier_t GetMetaID() const {
 		return m_metaTable ? m_metaTable->GetMetaID() : wxNOT_FOUND;
 	}
@@ -253,6 +250,8 @@ public:
 
 	virtual unsigned int GetItSize() const override { return m_aObjectValues.size(); }
 
+	virtual void PrepareReferences();
+
 protected:
 
 	//set meta/get meta
@@ -264,6 +263,8 @@ protected:
 	IObjectValueInfo *m_dataObject;
 	std::vector<std::map<meta_identifier_t, CValue>> m_aObjectValues;
 	CMetaTableObject *m_metaTable;
+
+	CMethods *m_lineMethods;
 };
 
 class CValueTabularSection : public IValueTabularSection {
@@ -293,6 +294,15 @@ public:
 	//set meta/get meta
 	virtual void SetValueByMetaID(long line, meta_identifier_t id, const CValue &cVal);
 	virtual CValue GetValueByMetaID(long line, meta_identifier_t id) const;
+
+private:
+
+	bool SaveRowsInDB(const std::vector<unsigned int> &aRows);
+	bool IsRowChanged(unsigned int line) const;
+
+	//rows as they are stored in the database - save writes only the difference
+	std::vector<std::map<meta_identifier_t, CValue>> m_aStoredValues;
+	Guid m_storedGuid;
 };
 
 #endif // !_VALUEUUID_H__
@@ -13,13 +13,13 @@
 void IValueTabularSection::CValueTabularSectionReturnLine::SetAttribute(attributeArg_t &aParams, CValue &cVal)
 {
 	meta_identifier_t id = 
-		m_methods->GetAttributePosition(aParams.GetIndex());
+		m_ownerTable->GetLineMethods()->GetAttributePosition(aParams.GetIndex());
 	SetValueByMetaID(id, cVal);
 }
 
 CValue IValueTabularSection::CValueTabularSectionReturnLine::GetAttribute(attributeArg_t &aParams)
 {
 	meta_identifier_t id = 
-		m_methods->GetAttributePosition(aParams.GetIndex());
+		m_ownerTable->GetLineMethods()->GetAttributePosition(aParams.GetIndex());
 	return GetValueByMetaID(id);
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "dateUtils.h"
+
+#include <wx/datetime.h>
+
+namespace DateUtils
+{
+	static inline wxLongLong_t FloorDiv(wxLongLong_t a, wxLongLong_t b)
+	{
+		wxLongLong_t q = a / b;
+		if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+		return q;
+	}
+
+	wxLongLong_t DaysFromCivil(int nYear, int nMonth, int nDay)
+	{
+		wxLongLong_t y = nMonth <= 2 ? nYear - 1 : nYear;
+		wxLongLong_t era = (y >= 0 ? y : y - 399) / 400;
+		wxLongLong_t yoe = y - era * 400;
+		wxLongLong_t doy = (153 * (nMonth + (nMonth > 2 ? -3 : 9)) + 2) / 5 + nDay - 1;
+		wxLongLong_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + doe - 719468;
+	}
+
+	void CivilFromDays(wxLongLong_t nDays, int &nYear, int &nMonth, int &nDay)
+	{
+		wxLongLong_t z = nDays + 719468;
+		wxLongLong_t era = (z >= 0 ? z : z - 146096) / 146097;
+		wxLongLong_t doe = z - era * 146097;
+		wxLongLong_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		wxLongLong_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		wxLongLong_t mp = (5 * doy + 2) / 153;
+
+		nDay = (int)(doy - (153 * mp + 2) / 5 + 1);
+		nMonth = (int)(mp < 10 ? mp + 3 : mp - 9);
+		nYear = (int)(yoe + era * 400 + (nMonth <= 2 ? 1 : 0));
+	}
+
+	int DaysInMonth(int nYear, int nMonth)
+	{
+		static const int s_aDaysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		if (nMonth == 2 && IsLeapYear(nYear))
+			return 29;
+		return s_aDaysInMonth[nMonth - 1];
+	}
+
+	//the offset only changes on hour boundaries, so it is kept per utc hour
+	struct offsetCache_t {
+		wxLongLong_t m_nHour;
+		wxLongLong_t m_nOffset;
+		bool m_bValid;
+	};
+
+	#define OFFSET_CACHE_SIZE 1024
+
+	static wxLongLong_t GetLocalOffset(wxLongLong_t date)
+	{
+		static offsetCache_t s_aOffsetCache[OFFSET_CACHE_SIZE] = {};
+
+		wxLongLong_t nHour = FloorDiv(date, 3600 * msPerSecond);
+		offsetCache_t &offsetCache = s_aOffsetCache[(nHour % OFFSET_CACHE_SIZE + OFFSET_CACHE_SIZE) % OFFSET_CACHE_SIZE];
+
+		if (offsetCache.m_bValid && offsetCache.m_nHour == nHour)
+			return offsetCache.m_nOffset;
+
+		wxLongLong_t nHourDate = nHour * 3600 * msPerSecond;
+		wxDateTime::Tm tm = wxDateTime(wxLongLong(nHourDate)).GetTm();
+
+		wxLongLong_t nLocalDate = DaysFromCivil(tm.year, tm.mon + 1, tm.mday) * msPerDay
+			+ (tm.hour * 3600 + tm.min * 60 + tm.sec) * msPerSecond;
+
+		offsetCache.m_nHour = nHour;
+		offsetCache.m_nOffset = nLocalDate - nHourDate;
+		offsetCache.m_bValid = true;
+
+		return offsetCache.m_nOffset;
+	}
+
+	wxLongLong_t ToLocal(wxLongLong_t date)
+	{
+		return date + GetLocalOffset(date);
+	}
+
+	wxLongLong_t FromLocal(wxLongLong_t localDate)
+	{
+		wxLongLong_t date = localDate - GetLocalOffset(localDate);
+		return localDate - GetLocalOffset(date);
+	}
+
+	bool Compose(wxLongLong_t &date, int nYear, int nMonth, int nDay, int nHour, int nMinute, int nSecond)
+	{
+		if (nMonth < 1 || nMonth > 12 || nDay < 1 || nDay > DaysInMonth(nYear, nMonth))
+			return false;
+		if (nHour < 0 || nHour > 23 || nMinute < 0 || nMinute > 59 || nSecond < 0 || nSecond > 59)
+			return false;
+
+		date = FromLocal(DaysFromCivil(nYear, nMonth, nDay) * msPerDay
+			+ (nHour * 3600 + nMinute * 60 + nSecond) * msPerSecond);
+
+		return true;
+	}
+
+	void SplitDays(wxLongLong_t date, wxLongLong_t &nDays, wxLongLong_t &nTime)
+	{
+		wxLongLong_t localDate = ToLocal(date);
+		nDays = FloorDiv(localDate, msPerDay);
+		nTime = localDate - nDays * msPerDay;
+	}
+
+	void Split(wxLongLong_t date, int &nYear, int &nMonth, int &nDay)
+	{
+		wxLongLong_t nDays, nTime;
+		SplitDays(date, nDays, nTime);
+		CivilFromDays(nDays, nYear, nMonth, nDay);
+	}
+
+	void Split(wxLongLong_t date, int &nYear, int &nMonth, int &nDay, int &nHour, int &nMinute, int &nSecond)
+	{
+		wxLongLong_t nDays, nTime;
+		SplitDays(date, nDays, nTime);
+		CivilFromDays(nDays, nYear, nMonth, nDay);
+
+		int nSeconds = (int)(nTime / msPerSecond);
+		nHour = nSeconds / 3600;
+		nMinute = (nSeconds / 60) % 60;
+		nSecond = nSeconds % 60;
+	}
+}
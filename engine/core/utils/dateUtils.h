@@ -0,0 +1,38 @@
+#pragma once
+
+#include <wx/defs.h>
+
+//civil calendar arithmetic on date values (milliseconds since 1970-01-01 UTC, as wxDateTime keeps them).
+//the calendar breakdown is done with integers, wxDateTime is only asked for the local time offset.
+namespace DateUtils
+{
+	const wxLongLong_t msPerSecond = 1000;
+	const wxLongLong_t msPerDay = 86400 * msPerSecond;
+
+	//days since 1970-01-01 of the proleptic gregorian date
+	wxLongLong_t DaysFromCivil(int nYear, int nMonth, int nDay);
+	void CivilFromDays(wxLongLong_t nDays, int &nYear, int &nMonth, int &nDay);
+
+	inline bool IsLeapYear(int nYear) { return (nYear % 4 == 0 && nYear % 100 != 0) || nYear % 400 == 0; }
+	int DaysInMonth(int nYear, int nMonth);
+
+	//1 - monday ... 7 - sunday
+	inline int WeekDayFromDays(wxLongLong_t nDays)
+	{
+		int nWeekDay = (int)((nDays % 7 + 7 + 3) % 7); //1970-01-01 was thursday
+		return nWeekDay + 1;
+	}
+
+	//local time <-> utc
+	wxLongLong_t ToLocal(wxLongLong_t date);
+	wxLongLong_t FromLocal(wxLongLong_t localDate);
+
+	//returns false if the date does not exist
+	bool Compose(wxLongLong_t &date, int nYear, int nMonth, int nDay, int nHour = 0, int nMinute = 0, int nSecond = 0);
+
+	void Split(wxLongLong_t date, int &nYear, int &nMonth, int &nDay);
+	void Split(wxLongLong_t date, int &nYear, int &nMonth, int &nDay, int &nHour, int &nMinute, int &nSecond);
+
+	//day number in local calendar and time of day
+	void SplitDays(wxLongLong_t date, wxLongLong_t &nDays, wxLongLong_t &nTime);
+}
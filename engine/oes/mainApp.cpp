@@ -80,6 +80,9 @@ static const wxCmdLineEntryDesc s_cmdLineDesc[] = {
 	{ wxCMD_LINE_OPTION, "srv", "srv", "Start enterprise using server address", wxCMD_LINE_VAL_STRING, NULL },
 	{ wxCMD_LINE_OPTION, "port", "port", "Start enterprise using port", wxCMD_LINE_VAL_STRING, NULL },
 
+	//storage of the data: firebird or sqlite
+	{ wxCMD_LINE_OPTION, "storage", "storage", "Start enterprise using storage", wxCMD_LINE_VAL_STRING, NULL },
+
 	{ wxCMD_LINE_OPTION, "l", "l", "Start enterprise from current login", wxCMD_LINE_VAL_STRING, NULL },
 	{ wxCMD_LINE_OPTION, "p", "p", "Start enterprise from current password", wxCMD_LINE_VAL_STRING, NULL },
 
@@ -144,6 +147,11 @@ int CMainApp::OnRun()
 	parser.Found("srv", &serverIB);
 	parser.Found("port", &portIB);
 
+	wxString storage;
+	if (parser.Found("storage", &storage)) {
+		wxSystemOptions::SetOption("storage", storage);
+	}
+
 	parser.Found("l", &userIB);
 	parser.Found("p", &passwordIB);
 